@@ -0,0 +1,129 @@
+#include "binon/binon.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//	This program times the bulk varint encoders WriteUIntVarints() and
+//	WriteIntVarints() against writing the same integers one at a time with
+//	WriteUIntVarint() and WriteIntVarint(). The integers come from a fixed
+//	seed, so every run encodes the same data. For each case, it prints the
+//	best of kPasses passes in nanoseconds per integer.
+
+namespace {
+	using namespace binon;
+	using TClock = std::chrono::steady_clock;
+
+	constexpr std::size_t kCount = std::size_t{1} << 20;
+	constexpr int kPasses = 15;
+	constexpr std::uint64_t kSeed = 0x42696e4f4e;
+
+	struct Timing {
+		double nsPerInt;
+		std::size_t size;
+	};
+
+	//	Runs encode(writer) kPasses times into out and returns the fastest
+	//	pass along with the number of bytes it wrote.
+	template<typename Encode>
+		auto Time(Encode encode, TBytes& out) -> Timing
+	{
+		auto best = TClock::duration::max();
+		std::size_t size = 0;
+		for(int pass = 0; pass < kPasses; ++pass) {
+			SpanWriter writer{out.data(), out.size()};
+			auto start = TClock::now();
+			encode(writer);
+			best = std::min(best, TClock::now() - start);
+			size = writer.count();
+		}
+		std::chrono::duration<double,std::nano> ns = best;
+		return {ns.count() / kCount, size};
+	}
+
+	//	Makes kCount integers by shifting 64 random bits right by one of the
+	//	amounts in shifts, chosen at random. Shifts of 57, 50, 35, 4, and 0
+	//	give varints that are 1, 2, 4, 8, and 9 bytes long, respectively.
+	//	(Signed integers are shifted arithmetically.)
+	template<typename T>
+		auto MakeInts(const std::vector<int>& shifts) -> std::vector<T>
+	{
+		std::mt19937_64 gen{kSeed};
+		std::vector<T> ints(kCount);
+		for(auto& i: ints) {
+			auto bits = gen();
+			i = static_cast<T>(bits) >> shifts[gen() % shifts.size()];
+		}
+		return ints;
+	}
+
+	//	Prints the timings for one case and returns whether the two
+	//	encoders wrote the same bytes.
+	template<typename T>
+		auto Compare(const std::string& name, const std::vector<int>& shifts)
+			-> bool
+	{
+		auto ints = MakeInts<T>(shifts);
+		TBytes bulkOut(kCount * kMaxVarintSize);
+		TBytes singleOut(kCount * kMaxVarintSize);
+		auto b = Time([&](ByteWriter& w) {
+			if constexpr(std::is_signed_v<T>) {
+				WriteIntVarints(ints.data(), ints.size(), w);
+			}
+			else {
+				WriteUIntVarints(ints.data(), ints.size(), w);
+			}
+		}, bulkOut);
+		auto s = Time([&](ByteWriter& w) {
+			for(auto i: ints) {
+				if constexpr(std::is_signed_v<T>) {
+					WriteIntVarint(i, w);
+				}
+				else {
+					WriteUIntVarint(i, w);
+				}
+			}
+		}, singleOut);
+		std::cout << std::left << std::setw(14) << name << std::right
+			<< std::fixed << std::setprecision(2)
+			<< std::setw(8) << static_cast<double>(b.size) / kCount
+			<< std::setw(12) << s.nsPerInt
+			<< std::setw(12) << b.nsPerInt
+			<< std::setw(9) << s.nsPerInt / b.nsPerInt << "x\n";
+		return b.size == s.size
+			&& std::memcmp(bulkOut.data(), singleOut.data(), b.size) == 0;
+	}
+}
+
+auto main() -> int {
+	try {
+		const std::vector<int> kSmall{57};
+		const std::vector<int> kMixed{57, 57, 57, 50, 35, 4, 0};
+		const std::vector<int> kWide{4, 0};
+		std::cout << kCount << " integers, best of " << kPasses
+			<< " passes\n"
+			<< "case         bytes/int  single ns   bulk ns  speedup\n";
+		auto ok = Compare<std::uint64_t>("uint 1-byte", kSmall)
+			& Compare<std::uint64_t>("uint mixed", kMixed)
+			& Compare<std::uint64_t>("uint wide", kWide)
+			& Compare<std::int64_t>("int 1-byte", kSmall)
+			& Compare<std::int64_t>("int mixed", kMixed)
+			& Compare<std::int64_t>("int wide", kWide);
+		if(!ok) {
+			std::cerr << "bulk and single encodings differ\n";
+			return 1;
+		}
+	}
+	catch(const std::exception& err) {
+		std::cerr << "ERROR: " << err.what() << '\n';
+		return 1;
+	}
+	return 0;
+}
@@ -29,7 +29,8 @@ template<typename T>
 		auto s{std::move(oss).str()};
 		DumpBinON(s);
 		istringstream iss{std::move(s)};
-		v.decode(iss);
+		binon::StreamReader reader{iss};
+		v.decode(binon::CodeByte::Read(reader), reader);
 		cout << "after decoding:\n\t" << v << '\n';
 	}
 
@@ -42,10 +43,10 @@ auto main() -> int {
 		v1.mValue["bar"] = 1;
 		v1.mValue["baz"] = 2;
 		RunTest(v1);
-		SKDictT<StrObj> v2;
-		v2.mValue["foo"] = std::make_shared<IntObj>(42);
-		v2.mValue["bar"] = std::make_shared<StrObj>("qux");
-		v2.mValue["baz"] = std::make_shared<BoolObj>(true);
+		SKDictT<std::string> v2;
+		v2.mValue["foo"] = IntObj{42};
+		v2.mValue["bar"] = StrObj{"qux"};
+		v2.mValue["baz"] = BoolObj{true};
 		RunTest(v2);
 		SListT<bool> v3{true,true,false,true,true,true,false};
 		RunTest(v3);
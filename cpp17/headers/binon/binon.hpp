@@ -6,9 +6,21 @@
 //	dependency for any other projects that use libbinon.
 
 #include "dicthelpers.hpp"
+#include "encodeplan.hpp"
 #include "idgen.hpp"
 #include "iterable.hpp"
+#include "lazyobj.hpp"
 #include "listhelpers.hpp"
+#include "mmapfile.hpp"
+#include "optimalobj.hpp"
+#include "pullparser.hpp"
+#include "sdictt.hpp"
 #include "seedsource.hpp"
+#include "skipobj.hpp"
+#include "slistbits.hpp"
+#include "sliststrs.hpp"
+#include "slistt.hpp"
+#include "treecodec.hpp"
+#include "varint.hpp"
 
 #endif
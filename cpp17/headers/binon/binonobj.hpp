@@ -60,17 +60,30 @@ namespace binon {
 		//		stream: a std::istream from which raw bytes can be read as char
 		//		requireIO: throw exception if a read operation fails?
 		//			This argument is common to all encoding/decoding methods and
-		//			always defaults to true. It sets the various std::ios
-		//			exception flags. Generally, you want this.
+		//			always defaults to true. Generally, you want this.
 		//
-		//			If you are doing several encoding/decoding operations in a
-		//			row, however, you might consider declaring a RequireIO
-		//			object (see ioutil.hpp). This will set the flags while it
-		//			exists and restore them when it destructs. Then you can call
-		//			BinONObj::Decode(stream, kSkipRequireIO) since you know the
-		//			exception bits have already been set.
+		//			It is recorded once in the CodecContext (see byteio.hpp) of
+		//			the StreamReader wrapping your stream, and the decoder
+		//			checks it only when the stream actually fails. (Older
+		//			versions of BinON set the stream's exception flags with
+		//			RequireIO on every call instead. RequireIO and
+		//			kSkipRequireIO are still around in ioutil.hpp, but you no
+		//			longer need them to speed up a series of calls.)
 		static auto Decode(TIStream& stream, bool requireIO = true) -> BinONObj;
 
+		//	This version of Decode() reads from a ByteReader (see byteio.hpp)
+		//	instead of a stream. For example, to decode from memory:
+		//
+		//		SpanReader reader{bytes};
+		//		auto obj = BinONObj::Decode(reader);
+		//
+		//	Every encoding/decoding method has a ByteWriter/ByteReader
+		//	overload like this one. These skip the std::iostream machinery
+		//	altogether, so they are considerably faster when you are working
+		//	with memory buffers. (The stream versions call them internally
+		//	through a StreamWriter or StreamReader.)
+		static auto Decode(ByteReader& reader) -> BinONObj;
+
 		//	FromTypeCode() returns a new object of the type specified by type
 		//	code (see codebyte.hpp for a list of possible codes). This object
 		//	type will be default-constructed.
@@ -114,6 +127,7 @@ namespace binon {
 		//	appropriate one.
 		auto encode(TOStream& stream, bool requireIO = true) const
 			-> const BinONObj&;
+		auto encode(ByteWriter& writer) const -> const BinONObj&;
 
 		//	encodeData() omits encoding the type code and goes straight to the
 		//	object data. You can call this if the object type is clear by
@@ -122,6 +136,7 @@ namespace binon {
 		//	since the size of a list will always be an unsigned integer.
 		auto encodeData(TOStream& stream, bool requireIO = true) const
 			-> const BinONObj&;
+		auto encodeData(ByteWriter& writer) const -> const BinONObj&;
 
 		//	decodeData() reads back what encodeData() wrote. Note how it is an
 		//	instance method--not a class method like Decode(). That means you
@@ -129,6 +144,18 @@ namespace binon {
 		//	call decodeData() on it.
 		auto decodeData(TIStream& stream, bool requireIO = true)
 			-> BinONObj&;
+		auto decodeData(ByteReader& reader) -> BinONObj&;
+
+		//	encodedSize() and encodedDataSize() return the exact number of
+		//	bytes encode() and encodeData() would write, respectively. You can
+		//	use them to size a buffer up front:
+		//
+		//		TBytes bytes;
+		//		bytes.reserve(obj.encodedSize());
+		//		VectorWriter writer{bytes};
+		//		obj.encode(writer); // never needs to reallocate
+		auto encodedSize() const -> std::size_t;
+		auto encodedDataSize() const -> std::size_t;
 
 		//	asObj() attempts to extract a specific object type from a general
 		//	BinONObj. If your primary choice does not pan out, it may run
@@ -0,0 +1,145 @@
+#ifndef BINON_BITVEC_HPP
+#define BINON_BITVEC_HPP
+
+#include "byteio.hpp"
+#include "byteutil.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace binon {
+
+	/*
+	BitVec class
+
+	BitVec is a resizable sequence of bools stored 1 bit apiece. The bits are
+	laid out in memory exactly the way BinON packs bools in a simple container
+	(most-significant bit of the first byte first), so encoding or decoding a
+	BitVec is a single copy of its bytes.
+
+	The bytes live in an array of 64-bit words, which lets count() and the
+	bitwise operators work a word at a time. Bits past size() are always kept
+	at 0, so these never need to mask anything off.
+
+	Example:
+
+		BitVec flags(1'000'000);
+		flags.set(42);
+		auto enabled = flags & otherFlags;
+		std::cout << enabled.count() << " flags set in both\n";
+
+	The binary operators throw std::invalid_argument if the sizes of the 2
+	BitVecs differ.
+
+	SListBits (see slistbits.hpp) wraps a BitVec to encode and decode boolean
+	SLists.
+	*/
+	class BitVec {
+	 public:
+		using TWord = std::uint64_t;
+		static constexpr std::size_t kWordBits = 64;
+
+		BitVec() noexcept = default;
+		explicit BitVec(std::size_t n, bool v = false);
+		BitVec(std::initializer_list<bool> init);
+
+		auto size() const noexcept { return mSize; }
+		auto empty() const noexcept { return mSize == 0u; }
+
+		//	test() and operator[] return bit i. (There is no bounds check.)
+		auto test(std::size_t i) const noexcept -> bool;
+		auto operator[] (std::size_t i) const noexcept { return test(i); }
+		void set(std::size_t i, bool v = true) noexcept;
+		void reset(std::size_t i) noexcept { set(i, false); }
+		void flip(std::size_t i) noexcept;
+
+		void push_back(bool v);
+		void resize(std::size_t n, bool v = false);
+		void reserve(std::size_t n);
+		void clear() noexcept;
+
+		//	count() returns the number of bits set. any(), none(), and all()
+		//	are much as in std::bitset. flip() with no argument inverts every
+		//	bit.
+		auto count() const noexcept -> std::size_t;
+		auto any() const noexcept -> bool;
+		auto none() const noexcept -> bool { return !any(); }
+		auto all() const noexcept -> bool { return count() == mSize; }
+		auto flip() noexcept -> BitVec&;
+
+		auto operator&= (const BitVec& rhs) -> BitVec&;
+		auto operator|= (const BitVec& rhs) -> BitVec&;
+		auto operator^= (const BitVec& rhs) -> BitVec&;
+		auto operator== (const BitVec& rhs) const noexcept -> bool;
+		auto operator!= (const BitVec& rhs) const noexcept -> bool
+			{ return !(*this == rhs); }
+
+		//	data() and byteSize() give you the bits in packed form. words() and
+		//	wordCount() give you the same memory as 64-bit words, should you
+		//	want to implement some other bitwise operation efficiently.
+		auto data() const noexcept -> const std::byte*;
+		auto byteSize() const noexcept -> std::size_t
+			{ return (mSize + 7u) >> 3; }
+		auto words() noexcept -> TWord* { return mWords.data(); }
+		auto words() const noexcept -> const TWord* { return mWords.data(); }
+		auto wordCount() const noexcept { return mWords.size(); }
+
+		//	assign() replaces the contents with n bits in packed form starting
+		//	at p.
+		void assign(const std::byte* p, std::size_t n);
+
+		//	read() replaces the contents with n packed bits read from reader,
+		//	and write() writes them out in packed form. (read() grows the
+		//	words as the bytes arrive if the reader does not know how many
+		//	remain. If they run out without requireIO, it keeps only the bits
+		//	it got.)
+		void read(ByteReader& reader, std::size_t n);
+		void write(ByteWriter& writer) const;
+
+	 private:
+		std::vector<TWord> mWords;
+		std::size_t mSize = 0u;
+
+		auto bytes() noexcept -> unsigned char*;
+		auto bytes() const noexcept -> const unsigned char*;
+		void clearTail() noexcept;
+		void checkSize(const BitVec& rhs) const;
+	};
+	auto operator& (BitVec lhs, const BitVec& rhs) -> BitVec;
+	auto operator| (BitVec lhs, const BitVec& rhs) -> BitVec;
+	auto operator^ (BitVec lhs, const BitVec& rhs) -> BitVec;
+	auto operator~ (BitVec v) -> BitVec;
+
+	//==== Inline Implementation ===============================================
+
+	inline auto BitVec::bytes() noexcept -> unsigned char* {
+		return reinterpret_cast<unsigned char*>(mWords.data());
+	}
+	inline auto BitVec::bytes() const noexcept -> const unsigned char* {
+		return reinterpret_cast<const unsigned char*>(mWords.data());
+	}
+	inline auto BitVec::data() const noexcept -> const std::byte* {
+		return reinterpret_cast<const std::byte*>(mWords.data());
+	}
+	inline auto BitVec::test(std::size_t i) const noexcept -> bool {
+		return (bytes()[i >> 3] & (0x80u >> (i & 0x7u))) != 0u;
+	}
+	inline void BitVec::set(std::size_t i, bool v) noexcept {
+		auto& b = bytes()[i >> 3];
+		auto mask = static_cast<unsigned char>(0x80u >> (i & 0x7u));
+		b = v ? b | mask : b & ~mask;
+	}
+	inline void BitVec::flip(std::size_t i) noexcept {
+		bytes()[i >> 3] ^= static_cast<unsigned char>(0x80u >> (i & 0x7u));
+	}
+	inline void BitVec::push_back(bool v) {
+		if(mSize == mWords.size() * kWordBits) {
+			mWords.push_back(0u);
+		}
+		set(mSize++, v);
+	}
+}
+
+#endif
@@ -14,13 +14,17 @@ namespace binon {
 	//	2. When you encode a batch of bools from say an SList, they get packed
 	//	   8 to a byte.
 	//
+	//	BoolObj borrows the stream overloads of these methods from StdCodec but
+	//	implements its own encode() and decode() for ByteWriter/ByteReader.
+	//
 	//	Note: The common interface to all BinONObj types is described in
 	//	mixins.hpp.
 	struct BoolObj:
 		StdAcc<BoolObj>,
 		StdEq<BoolObj>,
 		StdHash<BoolObj>,
-		StdHasDefVal<BoolObj>
+		StdHasDefVal<BoolObj>,
+		StdCodec<BoolObj>
 	{
 		using TValue = bool;
 		TValue mValue;
@@ -31,14 +35,18 @@ namespace binon {
 			{ return equals(rhs); }
 		auto operator!= (const BoolObj& rhs) const noexcept
 			{ return !equals(rhs); }
-		auto encode(TOStream& stream, bool requireIO = true) const
-			-> const BoolObj&;
-		auto decode(CodeByte cb, TIStream& stream, bool requireIO = true)
-			-> BoolObj&;
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const BoolObj&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> BoolObj&;
+		using StdCodec<BoolObj>::encode;
+		using StdCodec<BoolObj>::decode;
+		using StdCodec<BoolObj>::encodeData;
+		using StdCodec<BoolObj>::decodeData;
+		auto encode(ByteWriter& writer) const -> const BoolObj&;
+		auto decode(CodeByte cb, ByteReader& reader) -> BoolObj&;
+		auto encodeData(ByteWriter& writer) const -> const BoolObj&;
+		auto decodeData(ByteReader& reader) -> BoolObj&;
+		constexpr auto encodedSize() const noexcept -> std::size_t
+			{ return 1u; }
+		constexpr auto encodedDataSize() const noexcept -> std::size_t
+			{ return 1u; }
 		void printArgs(std::ostream& stream) const;
 	};
 }
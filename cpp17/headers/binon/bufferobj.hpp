@@ -19,18 +19,23 @@ namespace binon {
 	auto operator<< (std::ostream& stream, const BufferVal& v)
 		-> std::ostream&;
 
+	//	Like StrObj, BufferObj can decode its value as a view into the input
+	//	if the ByteReader has borrowing enabled (see BorrowMode in byteio.hpp).
+	//	It is also a HashCache in the same way, with mValue likewise private
+	//	if BINON_HASH_CACHE is defined true.
+	//
 	//	Note: The common interface to all BinONObj types is described in
 	//	mixins.hpp.
 	struct BufferObj:
 		StdAcc<BufferObj>,
 		StdEq<BufferObj>,
 		StdHash<BufferObj>,
-		StdCodec<BufferObj>
+		StdCodec<BufferObj>,
+		HashCache
 	{
 		using TValue = BufferVal;
 		static constexpr auto kTypeCode = kBufferObjCode;
 		static constexpr auto kClsName = std::string_view{"BufferObj"};
-		TValue mValue;
 		BufferObj(const HyStr& hyStr);
 		BufferObj(TValue v);
 		BufferObj() = default;
@@ -39,11 +44,19 @@ namespace binon {
 		auto operator!= (const BufferObj& rhs) const noexcept
 			{ return !equals(rhs); }
 		auto hasDefVal() const noexcept -> bool;
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const BufferObj&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> BufferObj&;
+		using StdCodec<BufferObj>::encodeData;
+		using StdCodec<BufferObj>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const BufferObj&;
+		auto encodedDataSize() const noexcept -> std::size_t;
+		auto decodeData(ByteReader& reader) -> BufferObj&;
 		void printArgs(std::ostream& stream) const;
+
+	 #if BINON_HASH_CACHE
+	 private:
+		friend struct StdAcc<BufferObj>;
+		friend struct StdHash<BufferObj>;
+	 #endif
+		TValue mValue;
 	};
 }
 
@@ -0,0 +1,630 @@
+#ifndef BINON_BYTEIO_HPP
+#define BINON_BYTEIO_HPP
+
+#include "errors.hpp"
+#include "ioutil.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+#if BINON_CPP20
+	#include <span>
+#endif
+
+namespace binon {
+
+	//	TBytes is the growable byte buffer type used by VectorWriter (and
+	//	accepted by SpanReader). It is simply a std::vector of std::byte using
+	//	the BINON_ALLOCATOR.
+	using TBytes = std::vector<std::byte, BINON_ALLOCATOR<std::byte>>;
+
+	/*
+	CodecContext struct
+
+	CodecContext holds settings that apply to an entire encoding or decoding
+	operation. Every ByteWriter and ByteReader carries one, and since the
+	writer/reader gets passed down through all the nested encodeData() and
+	decodeData() calls, so does its context. Settings are therefore
+	established once at the top level rather than by each object in the tree.
+
+	Fields:
+		requireIO: throw std::ios_base::failure if the underlying stream fails?
+			Only StreamWriter and StreamReader consult this. (SpanWriter and
+			SpanReader always throw BufOverrun when they run out of memory.)
+			The stream-based encode/decode methods set it from their own
+			requireIO arguments.
+		maxDepth: how deeply containers may be nested within one another
+			BinONObj::Decode() and encode() walk the object tree with an
+			explicit stack rather than by recursion (see treecodec.hpp), so
+			this limit is not about the call stack so much as rejecting
+			hostile input early. Exceeding it throws DepthErr. A ByteReader
+			starts out with kDefMaxDepth here, but a ByteWriter starts out
+			with kNoLimit, since an object tree already in memory is not
+			hostile input. You can still set one to limit encoding.
+		maxBytes: the most bytes a decoder may read in total
+			This is compared against the reader's count(), so it includes
+			anything read before decoding began.
+		maxCount: the most elements (or entries) a single list (or dict) may
+			declare
+		maxStrLen: the longest string or buffer a decoder will accept
+			This also bounds the byte length of a variable-length IntObj or
+			UIntObj.
+		maxNullCount: the most NullObj elements (in SLists, or as the keys or
+			values of SKDicts and SDicts) a reader may decode in total
+			Such elements take up no space at all in the encoding, so unlike
+			the others, this limit does not default to kNoLimit. It defaults
+			to kDefMaxNullCount instead, which you can raise if need be. Like
+			maxBytes, it is counted across everything the reader decodes
+			rather than per container (see ByteReader::nullCount()).
+
+	The last four apply only to decoding, and exceeding any of them throws
+	LimitErr. Apart from maxNullCount, they default to kNoLimit, but even so,
+	the decoder never allocates memory on the strength of a length read from
+	the input alone. Strings and the elements of containers are checked
+	against the remaining input first when the reader knows how much there
+	is. When it does not (as with a stream), strings, buffers, big integers,
+	and packed bools are read a chunk at a time instead (see
+	ByteReader::readGrowing()). Either way, containers reserve space
+	gradually as their elements actually arrive. Memory use is therefore
+	bounded by about twice the size of the message plus maxNullCount null
+	elements in all, and setting maxBytes bounds the former outright.
+	*/
+	inline constexpr std::size_t kDefMaxDepth = 64;
+	inline constexpr std::size_t kDefMaxNullCount = 0x10000;
+	inline constexpr std::size_t kNoLimit =
+		std::numeric_limits<std::size_t>::max();
+	struct CodecContext {
+		bool requireIO = true;
+		std::size_t maxDepth = kDefMaxDepth;
+		std::size_t maxBytes = kNoLimit;
+		std::size_t maxCount = kNoLimit;
+		std::size_t maxStrLen = kNoLimit;
+		std::size_t maxNullCount = kDefMaxNullCount;
+	};
+
+	//	kWriterContext is the context a ByteWriter starts out with: the
+	//	defaults, minus the depth limit.
+	inline constexpr CodecContext kWriterContext{true, kNoLimit};
+
+	/*
+	ByteWriter class
+
+	ByteWriter is the abstract base class of all BinON byte sinks. Every
+	encodeData() method has an overload that takes a ByteWriter& rather than a
+	TOStream&, and this is where the real encoding work happens. (The stream
+	overloads simply wrap your stream in a StreamWriter.)
+
+	A ByteWriter manages a window of memory delimited by 3 pointers: mBeg, mPos,
+	and mEnd. As long as there is room between mPos and mEnd, writing is a
+	matter of copying bytes and bumping mPos along. Only when the window fills
+	up does a subclass get involved through the virtual makeRoom() method. So
+	encoding into memory avoids the per-call overhead of the iostream library
+	(sentry objects, virtual streambuf calls, and so on).
+
+	There are 3 concrete subclasses:
+
+		VectorWriter: appends to a growable TBytes buffer
+		SpanWriter: writes into a fixed-size buffer you supply
+		StreamWriter: buffers output for a TOStream
+
+	ByteWriters cannot be copied.
+	*/
+	class ByteWriter {
+	 public:
+		ByteWriter(const ByteWriter&) = delete;
+		auto operator= (const ByteWriter&) -> ByteWriter& = delete;
+		virtual ~ByteWriter() = default;
+
+		//	put() writes a single byte.
+		void put(std::byte b);
+
+		//	write() writes n bytes starting at address p.
+		void write(const std::byte* p, std::size_t n);
+		void write(const TStreamByte* p, std::size_t n);
+
+		//	prepare() returns a pointer to at least n writable bytes of
+		//	contiguous memory. Once you have filled in however many of these you
+		//	need, you call advance() to commit them to the output. This lets you
+		//	serialize a value in place rather than going through an
+		//	intermediate buffer.
+		//
+		//	Note that n should be kept small. StreamWriter cannot prepare more
+		//	than kStreamBufSize bytes at once and throws std::length_error if
+		//	you ask it to. (write() has no such limit.)
+		auto prepare(std::size_t n) -> std::byte*;
+		void advance(std::size_t n) noexcept;
+
+		//	window() and windowSize() describe the writable memory left in
+		//	the current window without growing it. You can fill in as much of
+		//	it as you like and then call advance(), much as with prepare().
+		//	(WriteUIntVarints() in varint.hpp does this to encode integers
+		//	with as few bounds checks as possible.)
+		auto window() const noexcept -> std::byte*;
+		auto windowSize() const noexcept -> std::size_t;
+
+		//	count() returns the total number of bytes written so far.
+		auto count() const noexcept -> std::size_t;
+
+		//	context() gives you access to the writer's CodecContext.
+		auto context() noexcept -> CodecContext&;
+		auto context() const noexcept -> const CodecContext&;
+
+		//	flush() makes sure all bytes written so far have been delivered to
+		//	the underlying sink. What that means depends on the subclass. For
+		//	example, StreamWriter will write its buffered bytes out to the
+		//	stream.
+		virtual void flush() {}
+
+	 protected:
+		std::byte* mBeg = nullptr;
+		std::byte* mPos = nullptr;
+		std::byte* mEnd = nullptr;
+
+		//	mBase counts bytes that have left the mBeg-mEnd window (e.g. flushed
+		//	to a stream) so that count() can account for them.
+		std::size_t mBase = 0;
+		CodecContext mContext{kWriterContext};
+
+		ByteWriter() noexcept = default;
+
+		//	makeRoom() must ensure that there are at least n bytes available
+		//	between mPos and mEnd or throw an exception trying.
+		virtual void makeRoom(std::size_t n) = 0;
+
+		//	writeSlow() is called by write() whenever the current window is too
+		//	small to hold the data. The default implementation calls makeRoom()
+		//	and copies the data, but a subclass may have a more direct route.
+		virtual void writeSlow(const std::byte* p, std::size_t n);
+	};
+
+	/*
+	VectorWriter class
+
+	VectorWriter appends bytes to a TBytes buffer you supply, growing it as
+	needed. Any bytes that were already in the buffer are left alone (though
+	they are included in count(), which therefore matches the buffer size after
+	a flush()).
+
+	Internally, VectorWriter may resize the buffer beyond what has actually
+	been written to give itself room to work. The buffer size gets trimmed back
+	down to the written bytes when you call flush() or when the VectorWriter
+	destructs.
+
+	Example:
+
+		TBytes bytes;
+		{
+			VectorWriter writer{bytes};
+			myObj.encode(writer);
+		}
+		// bytes now contains the encoded object
+	*/
+	class VectorWriter final: public ByteWriter {
+	 public:
+		explicit VectorWriter(TBytes& bytes) noexcept;
+		~VectorWriter() override;
+		void flush() override;
+
+	 protected:
+		TBytes& mBytes;
+
+		void makeRoom(std::size_t n) override;
+	};
+
+	/*
+	SpanWriter class
+
+	SpanWriter writes into a fixed-size buffer. If the encoding does not fit,
+	it throws BufOverrun. You can check how many bytes were written with
+	count().
+	*/
+	class SpanWriter final: public ByteWriter {
+	 public:
+		SpanWriter(std::byte* data, std::size_t size) noexcept;
+	 #if BINON_CPP20
+		explicit SpanWriter(std::span<std::byte> span) noexcept;
+	 #endif
+
+	 protected:
+		void makeRoom(std::size_t n) override;
+	};
+
+	/*
+	StreamWriter class
+
+	StreamWriter is a ByteWriter adapter around a TOStream. It collects bytes
+	in an internal buffer of kStreamBufSize bytes and writes them out to the
+	stream in one call whenever the buffer fills up or you call flush().
+
+	The StreamWriter destructor will flush any bytes still in the buffer, but
+	it cannot report errors in doing so. If you need to know that everything
+	made it to the stream, call flush() yourself first. (All the stream-based
+	encoding methods in BinON do this.)
+
+	If the stream fails while being written, StreamWriter throws
+	std::ios_base::failure, unless you pass false for requireIO. (It checks the
+	stream state once per buffer flush rather than changing the stream's
+	exception mask the way RequireIO in ioutil.hpp does.)
+	*/
+	inline constexpr std::size_t kStreamBufSize = 0x200;
+	class StreamWriter final: public ByteWriter {
+	 public:
+		explicit StreamWriter(
+			TOStream& stream, bool requireIO = true
+			) noexcept;
+		~StreamWriter() override;
+		void flush() override;
+
+	 protected:
+		TOStream& mStream;
+		std::array<std::byte, kStreamBufSize> mBuffer;
+
+		void makeRoom(std::size_t n) override;
+		void writeSlow(const std::byte* p, std::size_t n) override;
+		void checkStream() const;
+	};
+
+	/*
+	BorrowMode enum
+
+	Normally, decoding a StrObj or BufferObj copies its data out of the input
+	into a std::string (or equivalent). But if you are decoding from memory,
+	you can have the decoder borrow the data instead, leaving the object's
+	HyStr/BufferVal value in string view form pointing straight into the input.
+	This makes decoding large payloads proportional to the structure of the
+	data rather than its size.
+
+	kCopy: copy string/buffer data out of the input (the default)
+	kView: decode string/buffer values as views into the input
+		It is up to you to make sure the input buffer outlives the decoded
+		objects (or at least any of their values still in view form).
+	kShared: like kView, except each view also holds a reference to a
+		std::shared_ptr owning the input buffer, so the buffer is only released
+		once the last view referring to it is gone
+
+	You can set the mode on a ByteReader that supports it with setBorrowMode().
+	Note that any HyStr method that modifies the string (see hystr.hpp) will
+	convert a borrowed view into an owned string first, so borrowed values are
+	never written through.
+	*/
+	enum class BorrowMode { kCopy, kView, kShared };
+
+	/*
+	ByteReader class
+
+	ByteReader is the source counterpart to ByteWriter. Every decodeData()
+	method has an overload that takes a ByteReader&.
+
+	It works the same way as ByteWriter, in that bytes are read out of a
+	memory window. When the window is exhausted, the virtual readSlow() method
+	takes over.
+
+	There are 2 concrete subclasses:
+
+		SpanReader: reads from a contiguous block of memory
+		StreamReader: reads from a TIStream
+	*/
+	inline constexpr std::size_t kReadChunk = 0x10000;
+	class ByteReader {
+	 public:
+		ByteReader(const ByteReader&) = delete;
+		auto operator= (const ByteReader&) -> ByteReader& = delete;
+		virtual ~ByteReader() = default;
+
+		//	get() reads a single byte.
+		auto get() -> std::byte;
+
+		//	read() reads n bytes into the buffer at address p.
+		void read(std::byte* p, std::size_t n);
+		void read(TStreamByte* p, std::size_t n);
+
+		//	skip() reads past n bytes without copying them anywhere.
+		void skip(std::size_t n);
+
+		//	count() returns the total number of bytes read so far.
+		auto count() const noexcept -> std::size_t;
+
+		//	context() gives you access to the reader's CodecContext.
+		auto context() noexcept -> CodecContext&;
+		auto context() const noexcept -> const CodecContext&;
+
+		//	borrow() is how decoders implement the BorrowMode options. If
+		//	borrowing is enabled and the reader can lend its input memory
+		//	directly, it returns a pointer to the next n bytes and advances
+		//	past them. Otherwise, it returns nullptr without reading anything,
+		//	and you should fall back on read().
+		//
+		//	owner() returns the std::shared_ptr a borrowed view should hold in
+		//	kShared mode. (It is empty in the other modes.)
+		auto borrow(std::size_t n) -> const std::byte*;
+		auto borrowMode() const noexcept -> BorrowMode;
+		auto owner() const noexcept -> const std::shared_ptr<const void>&;
+
+		//	setBorrowMode() throws std::invalid_argument if you request kShared
+		//	on a reader that has no owner.
+		void setBorrowMode(BorrowMode mode);
+
+		//	window() returns a pointer to the bytes the reader already has in
+		//	memory, and windowSize() how many there are (always 0 for a
+		//	StreamReader). Bulk decoders work on these in place and then call
+		//	consume() to advance past however many they used, falling back on
+		//	get() and read() where the window runs out. (See ReadVarintRun()
+		//	in varint.hpp.)
+		auto window() const noexcept -> const std::byte*;
+		auto windowSize() const noexcept -> std::size_t;
+		void consume(std::size_t n) noexcept;
+
+		//	remaining() returns the number of bytes that have yet to be read,
+		//	or kNoLimit if the reader cannot tell (as with a stream).
+		virtual auto remaining() const noexcept -> std::size_t;
+
+		//	checkAvail() is called by decoders before committing memory to
+		//	n bytes' worth of input. It throws BufOverrun if the input is
+		//	known to end sooner or LimitErr if reading n more bytes would
+		//	exceed the context's maxBytes. checkLength() does the same for a
+		//	string or buffer length, first checking it against maxStrLen.
+		void checkAvail(std::size_t n) const;
+		void checkLength(std::size_t n) const;
+
+		//	readGrowing() reads n bytes into a buffer of your own. grow(size)
+		//	must resize the buffer to hold size bytes and return a pointer to
+		//	the first of them. If remaining() is known, the buffer is sized to
+		//	n in one go, so you should have called checkAvail() or
+		//	checkLength() first. Otherwise, the buffer grows by kReadChunk
+		//	bytes or by however many have been read so far (whichever is more)
+		//	at a time, so that a bogus length read from a stream fails for
+		//	lack of data before much memory is committed to it.
+		//
+		//	If the input runs out without requireIO, readGrowing() stops there
+		//	(calling grow() one last time with the size actually read) rather
+		//	than padding the buffer out to n bytes. It returns that size.
+		template<typename Grow>
+			auto readGrowing(std::size_t n, Grow grow) -> std::size_t;
+
+		//	checkNulls() is called by decoders before committing memory to n
+		//	NullObj elements. Since these take up no input, the reader keeps
+		//	a running total of them instead, which nullCount() returns.
+		//	checkNulls() adds n to it, throwing LimitErr if the result would
+		//	exceed the context's maxNullCount.
+		void checkNulls(std::size_t n);
+		auto nullCount() const noexcept -> std::size_t;
+
+	 protected:
+		const std::byte* mBeg = nullptr;
+		const std::byte* mPos = nullptr;
+		const std::byte* mEnd = nullptr;
+		std::size_t mBase = 0;
+		BorrowMode mBorrowMode = BorrowMode::kCopy;
+		std::shared_ptr<const void> mOwner;
+		CodecContext mContext;
+		std::size_t mNullCount = 0;
+
+		ByteReader() noexcept = default;
+
+		//	borrowSlow() is called by borrow() when borrowing is enabled but
+		//	the current window does not contain n bytes. The default returns
+		//	nullptr.
+		virtual auto borrowSlow(std::size_t n) -> const std::byte*;
+
+		//	readSlow() is called by read() whenever the current window does not
+		//	contain enough bytes to satisfy the request.
+		virtual void readSlow(std::byte* p, std::size_t n) = 0;
+
+		//	skipSlow() is called by skip() when the current window does not
+		//	contain n bytes. The default implementation reads the bytes into a
+		//	scratch buffer on the stack in chunks.
+		virtual void skipSlow(std::size_t n);
+	};
+
+	/*
+	SpanReader class
+
+	SpanReader decodes from a contiguous block of memory. Reading past the end
+	of it throws BufOverrun.
+
+	The memory must remain valid for as long as the SpanReader is in use. (In
+	BorrowMode::kView, it must remain valid for as long as any borrowed views
+	into it are in use.)
+
+	If you construct a SpanReader with a std::shared_ptr owning the memory, it
+	starts out in BorrowMode::kShared (unless you pass a different mode), so
+	decoded strings and buffers become views that keep the memory alive.
+	(kShared without an owner falls back on kCopy.) Otherwise, the mode starts
+	out as kCopy but you can call setBorrowMode(BorrowMode::kView).
+	*/
+	class SpanReader final: public ByteReader {
+	 public:
+		SpanReader(const std::byte* data, std::size_t size) noexcept;
+		explicit SpanReader(const TBytes& bytes) noexcept;
+		explicit SpanReader(TStringView sv) noexcept;
+		SpanReader(
+			const std::byte* data, std::size_t size,
+			std::shared_ptr<const void> owner,
+			BorrowMode mode = BorrowMode::kShared
+			) noexcept;
+		explicit SpanReader(std::shared_ptr<const TBytes> bytes) noexcept;
+	 #if BINON_CPP20
+		explicit SpanReader(std::span<const std::byte> span) noexcept;
+	 #endif
+
+		auto remaining() const noexcept -> std::size_t override;
+
+	 protected:
+		void readSlow(std::byte* p, std::size_t n) override;
+		auto borrowSlow(std::size_t n) -> const std::byte* override;
+		void skipSlow(std::size_t n) override;
+	};
+
+	/*
+	StreamReader class
+
+	StreamReader is a ByteReader adapter around a TIStream. It reads directly
+	from the stream's buffer and never reads ahead, so the stream will be
+	positioned immediately after the last byte decoded.
+
+	If the stream runs out of data, StreamReader sets the eof and fail bits and
+	throws std::ios_base::failure. If you pass false for requireIO, it does not
+	throw (unless the stream's own exception mask calls for it) and the missing
+	bytes are read back as zeros instead. (Strings and the like are cut short
+	instead, though; see ByteReader::readGrowing().)
+
+	StreamReader cannot lend out memory, so it always decodes in
+	BorrowMode::kCopy.
+	*/
+	class StreamReader final: public ByteReader {
+	 public:
+		explicit StreamReader(
+			TIStream& stream, bool requireIO = true
+			) noexcept;
+
+	 protected:
+		TIStream& mStream;
+
+		void readSlow(std::byte* p, std::size_t n) override;
+	};
+
+	//==== Inline Implementation ===============================================
+
+	//---- ByteWriter ----------------------------------------------------------
+
+	inline void ByteWriter::put(std::byte b) {
+		if(mPos == mEnd) {
+			makeRoom(1);
+		}
+		*mPos++ = b;
+	}
+	inline void ByteWriter::write(const std::byte* p, std::size_t n) {
+		if(n <= static_cast<std::size_t>(mEnd - mPos)) {
+			mPos = std::copy(p, p + n, mPos);
+		}
+		else {
+			writeSlow(p, n);
+		}
+	}
+	inline void ByteWriter::write(const TStreamByte* p, std::size_t n) {
+		write(reinterpret_cast<const std::byte*>(p), n);
+	}
+	inline auto ByteWriter::prepare(std::size_t n) -> std::byte* {
+		if(n > static_cast<std::size_t>(mEnd - mPos)) {
+			makeRoom(n);
+		}
+		return mPos;
+	}
+	inline void ByteWriter::advance(std::size_t n) noexcept {
+		mPos += n;
+	}
+	inline auto ByteWriter::window() const noexcept -> std::byte* {
+		return mPos;
+	}
+	inline auto ByteWriter::windowSize() const noexcept -> std::size_t {
+		return static_cast<std::size_t>(mEnd - mPos);
+	}
+	inline auto ByteWriter::count() const noexcept -> std::size_t {
+		return mBase + static_cast<std::size_t>(mPos - mBeg);
+	}
+	inline auto ByteWriter::context() noexcept -> CodecContext& {
+		return mContext;
+	}
+	inline auto ByteWriter::context() const noexcept -> const CodecContext& {
+		return mContext;
+	}
+
+	//---- ByteReader ----------------------------------------------------------
+
+	inline auto ByteReader::get() -> std::byte {
+		if(mPos != mEnd) {
+			return *mPos++;
+		}
+		std::byte b;
+		readSlow(&b, 1);
+		return b;
+	}
+	inline void ByteReader::read(std::byte* p, std::size_t n) {
+		if(n <= static_cast<std::size_t>(mEnd - mPos)) {
+			std::copy(mPos, mPos + n, p);
+			mPos += n;
+		}
+		else {
+			readSlow(p, n);
+		}
+	}
+	inline void ByteReader::read(TStreamByte* p, std::size_t n) {
+		read(reinterpret_cast<std::byte*>(p), n);
+	}
+	inline void ByteReader::skip(std::size_t n) {
+		if(n <= static_cast<std::size_t>(mEnd - mPos)) {
+			mPos += n;
+		}
+		else {
+			skipSlow(n);
+		}
+	}
+	inline auto ByteReader::count() const noexcept -> std::size_t {
+		return mBase + static_cast<std::size_t>(mPos - mBeg);
+	}
+	inline auto ByteReader::context() noexcept -> CodecContext& {
+		return mContext;
+	}
+	inline auto ByteReader::context() const noexcept -> const CodecContext& {
+		return mContext;
+	}
+	inline auto ByteReader::nullCount() const noexcept -> std::size_t {
+		return mNullCount;
+	}
+	inline auto ByteReader::borrow(std::size_t n) -> const std::byte* {
+		if(mBorrowMode == BorrowMode::kCopy) {
+			return nullptr;
+		}
+		if(n <= static_cast<std::size_t>(mEnd - mPos)) {
+			auto p = mPos;
+			mPos += n;
+			return p;
+		}
+		return borrowSlow(n);
+	}
+	inline auto ByteReader::window() const noexcept -> const std::byte* {
+		return mPos;
+	}
+	inline auto ByteReader::windowSize() const noexcept -> std::size_t {
+		return static_cast<std::size_t>(mEnd - mPos);
+	}
+	inline void ByteReader::consume(std::size_t n) noexcept {
+		mPos += n;
+	}
+	inline auto ByteReader::borrowMode() const noexcept -> BorrowMode {
+		return mBorrowMode;
+	}
+	inline auto ByteReader::owner() const noexcept
+		-> const std::shared_ptr<const void>&
+	{
+		static const std::shared_ptr<const void> kNoOwner;
+		return mBorrowMode == BorrowMode::kShared ? mOwner : kNoOwner;
+	}
+	template<typename Grow>
+		auto ByteReader::readGrowing(std::size_t n, Grow grow) -> std::size_t
+	{
+		if(remaining() != kNoLimit) {
+			read(grow(n), n);
+			return n;
+		}
+		std::size_t size = 0;
+		while(size < n) {
+			auto step = std::min(n - size, std::max(kReadChunk, size));
+			auto p = grow(size + step) + size;
+			auto start = count();
+			read(p, step);
+			if(auto got = count() - start; got < step) {
+				size += got;
+				grow(size);
+				break;
+			}
+			size += step;
+		}
+		return size;
+	}
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef BINON_BYTEUTIL_HPP
 #define BINON_BYTEUTIL_HPP
 
+#include "byteio.hpp"
 #include "errors.hpp"
 #include "floattypes.hpp"
 #include "ioutil.hpp"
@@ -10,6 +11,7 @@
 #include <array>
 #include <climits>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <iterator>
 #include <optional>
@@ -142,9 +144,8 @@ namespace binon {
 	//	LittleEndian function
 	//
 	//	C++20 can determine the byte order convention at compile time, while
-	//	C++17 requires some runtime logic (unless you look at precompiler macros
-	//	which would be compiler-dependent -- the current implementation does not
-	//	do so).
+	//	C++17 requires some runtime logic unless the compiler predefines
+	//	__BYTE_ORDER__ (as GCC and Clang do).
 	//
 	//	Returns:
 	//		bool: compiler target uses little-endian byte order?
@@ -152,10 +153,63 @@ namespace binon {
 	constexpr auto LittleEndian() noexcept -> bool {
 		return std::endian::native == std::endian::little;
 	}
+ #elif defined(__BYTE_ORDER__)
+	constexpr auto LittleEndian() noexcept -> bool {
+		return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+	}
  #else
 	auto LittleEndian() noexcept -> bool;
  #endif
 
+	//	SwapBytes function
+	//
+	//	Reverses the byte order of a 32 or 64-bit unsigned integer. It is
+	//	spelled out with shifts, which optimizing compilers recognize and
+	//	replace with a single instruction.
+	constexpr auto SwapBytes(std::uint32_t u) noexcept -> std::uint32_t {
+		return u >> 24 | (u >> 8 & 0xff00u) | (u << 8 & 0xff0000u) | u << 24;
+	}
+	constexpr auto SwapBytes(std::uint64_t u) noexcept -> std::uint64_t {
+		return std::uint64_t{SwapBytes(static_cast<std::uint32_t>(u))} << 32
+			| SwapBytes(static_cast<std::uint32_t>(u >> 32));
+	}
+
+	//	CountLZero function
+	//
+	//	Returns the number of leading 0 bits in a 64-bit unsigned integer (64
+	//	if it is 0). This is std::countl_zero() in C++20. Otherwise, it falls
+	//	back on a compiler builtin where available.
+	constexpr auto CountLZero(std::uint64_t u) noexcept -> unsigned {
+	 #if BINON_CPP20
+		return static_cast<unsigned>(std::countl_zero(u));
+	 #elif defined(__GNUC__)
+		return u ? static_cast<unsigned>(__builtin_clzll(u)) : 64u;
+	 #else
+		unsigned n = 64u;
+		for(; u; u >>= 1) {
+			--n;
+		}
+		return n;
+	 #endif
+	}
+
+	//	PopCount function
+	//
+	//	Returns the number of 1 bits in a 64-bit unsigned integer. This is
+	//	std::popcount() in C++20, or a compiler builtin where available.
+	constexpr auto PopCount(std::uint64_t u) noexcept -> unsigned {
+	 #if BINON_CPP20
+		return static_cast<unsigned>(std::popcount(u));
+	 #elif defined(__GNUC__)
+		return static_cast<unsigned>(__builtin_popcountll(u));
+	 #else
+		u -= u >> 1 & 0x55555555'55555555u;
+		u = (u & 0x33333333'33333333u) + (u >> 2 & 0x33333333'33333333u);
+		u = (u + (u >> 4)) & 0x0f0f0f0f'0f0f0f0fu;
+		return static_cast<unsigned>(u * 0x01010101'01010101u >> 56);
+	 #endif
+	}
+
 	//-------------------------------------------------------------------------
 	//
 	//	Byte-Like Type Handling
@@ -212,8 +266,9 @@ namespace binon {
 	//
 	//		auto i = ByteUnpack<int,2>(arr);  // i = 1000
 	//
-	//	There are also WriteAsBytes() and ReadAsBytes() functions that
-	//	serialize data to/from TOStream and TIStream streams, respectively.
+	//	There are also BytePack() and ByteUnpack() overloads that serialize
+	//	data to/from TOStream and TIStream streams, respectively, as well as
+	//	ByteWriter and ByteReader (see byteio.hpp).
 	//
 	//	Regarding floating-point values, BinON currently only supports IEEE 754
 	//	binary32 and binary64 formats, so the size needs to be either 4 or 8
@@ -427,6 +482,26 @@ namespace binon {
 			stream.write(arr.data(), arr.size());
 		}
 
+	//	BytePack function -- ByteWriter version
+	//
+	//	This overloaded version of BytePack writes the byte data to a
+	//	ByteWriter (see byteio.hpp). It is what the BinON object classes use
+	//	internally, since it avoids the overhead of going through an iostream.
+	//
+	//	Template args:
+	//		Size: see array version
+	//		T (inferred): see array version
+	//
+	//	Function args:
+	//		v: the value to pack
+	//		writer: a ByteWriter to receive the packed bytes
+	//
+	template<std::size_t Size=0, typename T>
+		void BytePack(T v, ByteWriter& writer) {
+			auto arr = BytePack<Size, std::byte>(v);
+			writer.write(arr.data(), arr.size());
+		}
+
 	//	ByteUnpack function -- array version
 	//
 	//	Unpack a numeric value packed into an array earlier by BytePack().
@@ -521,6 +596,28 @@ namespace binon {
 			return ByteUnpack<T, TStreamByte, Size>(arr);
 		}
 
+	//	ByteUnpack function -- ByteReader version
+	//
+	//	This overloaded version of ByteUnpack reads the byte data from a
+	//	ByteReader (see byteio.hpp).
+	//
+	//	Template args:
+	//		T: see array version
+	//		Size: number of bytes to unpack (defaults to sizeof(T))
+	//
+	//	Function args:
+	//		reader: a ByteReader supplying the packed bytes
+	//
+	//	Returns:
+	//		value of type T unpacked from the reader
+	//
+	template<typename T, std::size_t Size=sizeof(T)>
+		auto ByteUnpack(ByteReader& reader) -> T {
+			std::array<std::byte, Size> arr;
+			reader.read(arr.data(), arr.size());
+			return ByteUnpack<T, std::byte, Size>(arr);
+		}
+
 	//-------------------------------------------------------------------------
 	//
 	//	Read/WriteWord functions: DEPRECATED
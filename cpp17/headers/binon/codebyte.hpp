@@ -15,6 +15,7 @@ namespace binon {
 		template<typename I> static constexpr auto FromInt(I i) noexcept
 			{ return CodeByte(ToByte(i)); }
 		static auto Read(TIStream& stream, bool requireIO=true) -> CodeByte;
+		static auto Read(ByteReader& reader) -> CodeByte;
 
 		constexpr CodeByte(std::byte value=0x00_byte) noexcept:
 			mValue{value} {}
@@ -51,6 +52,7 @@ namespace binon {
 			}
 
 		void write(TOStream& stream, bool requireIO=true) const;
+		void write(ByteWriter& writer) const;
 		void printRepr(std::ostream& stream) const;
 
 	 private:
@@ -3,6 +3,8 @@
 
 #include "objhelpers.hpp"
 #include <initializer_list>
+#include <stdexcept>
+#include <string_view>
 
 //	dicthelpers.hpp is structured a lot like listhelpers.hpp, so the
 //	documentation here will mainly highlight differences.
@@ -39,6 +41,14 @@ namespace binon {
 	//	You can also call FindObj() simply to check if a key exists, since an
 	//	OptRef evaluates true or false in say an if statement.
 	//
+	//	None of the functions here that only look up a key need to build a
+	//	BinONObj out of a string or integer key, so long as its object type
+	//	(StrObj, IntObj, or UIntObj according to TypeConv) is the dict's key
+	//	type. With a FlatMap or OrderedMap TDict, they hash the native value
+	//	directly (see KeyHash in dictobj.hpp). With a std::unordered_map, a
+	//	string key still gets wrapped in a StrObj, but one that only views
+	//	the string rather than copying it.
+	//
 	//auto FindObj(const DictType auto& dict, const TCType auto& key)
 	//	-> OptRef<const BinONObj>;
 	//auto FindObj(DictType auto& dict, const TCType auto& key)
@@ -101,6 +111,65 @@ namespace binon {
 				return MakeObj(key);
 			}
 		}
+		template<typename Obj, typename Dict>
+			auto HasKeyType(const Dict& dict) -> bool
+		{
+			using std::is_base_of_v;
+			if constexpr(
+				is_base_of_v<SKDict,Dict> ||
+				is_base_of_v<SDict,Dict>
+			) {
+				return dict.mKeyCode == Obj::kTypeCode;
+			}
+			else {
+				return true;
+			}
+		}
+
+		//	FindKey() calls find() on map (the dict's value) with whatever
+		//	is cheapest to look up for the key type.
+		template<typename Dict, typename Map, typename Key>
+			auto FindKey(const Dict& dict, Map& map, const Key& key)
+		{
+			using std::is_same_v;
+			using Obj = TValObj<Key>;
+			constexpr bool kStrKey = is_same_v<Obj,StrObj> &&
+				std::is_convertible_v<const Key&,std::string_view>;
+			constexpr bool kIntKey = std::is_integral_v<Key> &&
+				(is_same_v<Obj,IntObj> || is_same_v<Obj,UIntObj>);
+			if constexpr(kStrKey || kIntKey) {
+				if(HasKeyType<Obj>(dict)) {
+					if constexpr(kIsTransparent<typename Map::hasher>) {
+						if constexpr(kStrKey) {
+							return map.find(std::string_view{key});
+						}
+						else {
+							using TScalar = typename Obj::TValue::TScalar;
+							return map.find(static_cast<TScalar>(key));
+						}
+					}
+					else if constexpr(kStrKey) {
+						return map.find(
+							BinONObj{StrObj{HyStr{std::string_view{key}}}}
+							);
+					}
+				}
+			}
+			return map.find(MakeKeyObj(dict, key));
+		}
+
+		//	AtKey() is like calling at() on the map, but goes through
+		//	FindKey().
+		template<typename Dict, typename Map, typename Key>
+			auto AtKey(const Dict& dict, Map& map, const Key& key)
+			-> decltype((map.begin()->second))
+		{
+			auto iter = FindKey(dict, map, key);
+			if(iter == map.end()) {
+				throw std::out_of_range{"BinON dict key not found"};
+			}
+			return iter->second;
+		}
 		template<typename Dict, typename Val>
 			auto MakeValObj(const Dict& dict, const Val& val) -> BinONObj
 		{
@@ -127,9 +196,8 @@ namespace binon {
 			OptRef<const BinONObj>
 		)
 	{
-		auto keyObj = details::MakeKeyObj(dict, key);
 		auto& map = dict.value();
-		auto iter = map.find(keyObj);
+		auto iter = details::FindKey(dict, map, key);
 		if(iter != map.end()) {
 			return iter->second;
 		}
@@ -143,9 +211,8 @@ namespace binon {
 			OptRef<BinONObj>
 		)
 	{
-		auto keyObj = details::MakeKeyObj(dict, key);
 		auto& map = dict.value();
-		auto iter = map.find(keyObj);
+		auto iter = details::FindKey(dict, map, key);
 		if(iter != map.end()) {
 			return iter->second;
 		}
@@ -180,7 +247,7 @@ namespace binon {
 			TGetObjVal<Val>
 		)
 	{
-		return GetObjVal<Val>(dict.value().at(details::MakeKeyObj(dict, key)));
+		return GetObjVal<Val>(details::AtKey(dict, dict.value(), key));
 	}
 
 	//---- CtnrTValue function templates ---------------------------------------
@@ -194,19 +261,18 @@ namespace binon {
 		)
 	{
 		auto& map = dict.value();
-		auto keyObj{details::MakeKeyObj(dict, key)};
 		if(autoAlloc) {
-			auto iter = map.find(keyObj);
+			auto iter = details::FindKey(dict, map, key);
 			if(iter == map.end()) {
-				iter = map.insert(
-					*iter,
-					{keyObj, MakeValObj(dict, Val())}
-				);
+				iter = map.try_emplace(
+					details::MakeKeyObj(dict, key),
+					details::MakeValObj(dict, Val())
+				).first;
 			}
 			return ObjTValue<Val>(iter->second);
 		}
 		else {
-			return ObjTValue<Val>(map.at(keyObj));
+			return ObjTValue<Val>(details::AtKey(dict, map, key));
 		}
 	}
 	template<typename Val, typename Key, typename Dict>
@@ -219,8 +285,7 @@ namespace binon {
 			const Val&
 		)
 	{
-		auto& map = dict.value();
-		return ObjTValue<Val>(map.at(details::MakeKeyObj(dict, key)));
+		return ObjTValue<Val>(details::AtKey(dict, dict.value(), key));
 	}
 	template<typename Val, typename Dict, typename Key>
 		auto CtnrTValue(
@@ -232,9 +297,8 @@ namespace binon {
 			Val
 		)
 	{
-		auto& map = dict.value();
 		return ObjTValue<Val>(
-			std::move(map.at(details::MakeKeyObj(dict, key)))
+			std::move(details::AtKey(dict, dict.value(), key))
 		);
 	}
 
@@ -248,7 +312,7 @@ namespace binon {
 			Dict&
 		)
 	{
-		dict.value().insert_or_assign(
+		dict.updateValue().insert_or_assign(
 			details::MakeKeyObj(dict, key),
 			details::MakeValObj(dict, val)
 		);
@@ -265,8 +329,8 @@ namespace binon {
 			bool
 		)
 	{
-		auto& map = dict.value();
-		auto iter = map.find(details::MakeKeyObj(dict, key));
+		auto& map = dict.updateValue();
+		auto iter = details::FindKey(dict, map, key);
 		if(iter == map.end()) {
 			return false;
 		}
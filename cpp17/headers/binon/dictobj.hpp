@@ -1,12 +1,16 @@
 #ifndef BINON_DICTOBJ_HPP
 #define BINON_DICTOBJ_HPP
 
+#include "flatmap.hpp"
 #include "listobj.hpp"
+#include "orderedmap.hpp"
 
 #include <any>
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <sstream>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 
@@ -14,18 +18,76 @@ namespace binon {
 	struct SKDict;
 	struct SDict;
 
+	//	KeyHash and KeyEq hash and compare the keys of a FlatMap or OrderedMap
+	//	TDict. For BinONObj keys, they do exactly what std::hash<BinONObj> and
+	//	std::equal_to<BinONObj> do. But they are also transparent (see
+	//	kIsTransparent in typeutil.hpp): they take a std::string_view,
+	//	std::int64_t, or std::uint64_t in place of a StrObj, IntObj, or UIntObj
+	//	key respectively. KeyHash hashes such a key to the same value
+	//	std::hash<BinONObj> gives the equivalent object, so TDict::find() can
+	//	look it up without a BinONObj being built first. (The dict helpers in
+	//	dicthelpers.hpp take advantage of this.)
+	//
+	//	A std::unordered_map TDict sticks with std::hash and std::equal_to, so
+	//	that it remains the same type as std::unordered_map<BinONObj,BinONObj>.
+	struct KeyHash {
+		using is_transparent = void;
+		auto operator() (const BinONObj& key) const -> std::size_t;
+		auto operator() (std::string_view key) const noexcept
+			-> std::size_t;
+		auto operator() (std::int64_t key) const noexcept -> std::size_t;
+		auto operator() (std::uint64_t key) const noexcept -> std::size_t;
+	};
+	struct KeyEq {
+		using is_transparent = void;
+		auto operator() (const BinONObj& key, const BinONObj& other) const
+			-> bool;
+		auto operator() (const BinONObj& key, std::string_view other) const
+			noexcept -> bool;
+		auto operator() (const BinONObj& key, std::int64_t other) const
+			noexcept -> bool;
+		auto operator() (const BinONObj& key, std::uint64_t other) const
+			noexcept -> bool;
+	};
+
 	//	TDict is the value type of all dictionary objects (e.g. it is synomymous
 	//	with DictObj::TValue). It is an unordered map where both key and value
 	//	are BinON object types. The keys are presently restricted to
 	//	non-container types that can be hashed.
-	using TDict = std::unordered_map<
-		BinONObj, BinONObj, std::hash<BinONObj>, std::equal_to<BinONObj>,
-		BINON_ALLOCATOR<std::pair<const BinONObj, BinONObj>>
-		>;
+	//
+	//	Which map class it is depends on BINON_DICT_STORAGE (see macros.hpp).
+	//	Code that wants to work with any of them should stick to the interface
+	//	FlatMap and OrderedMap share with std::unordered_map, and not hold on
+	//	to references to entries across insertions.
+	#if BINON_DICT_STORAGE == BINON_DICT_FLAT
+		using TDict = FlatMap<
+			BinONObj, BinONObj, KeyHash, KeyEq,
+			BINON_ALLOCATOR<std::pair<const BinONObj, BinONObj>>
+			>;
+	#elif BINON_DICT_STORAGE == BINON_DICT_ORDERED
+		using TDict = OrderedMap<
+			BinONObj, BinONObj, KeyHash, KeyEq,
+			BINON_ALLOCATOR<std::pair<const BinONObj, BinONObj>>
+			>;
+	#else
+		using TDict = std::unordered_map<
+			BinONObj, BinONObj, std::hash<BinONObj>, std::equal_to<BinONObj>,
+			BINON_ALLOCATOR<std::pair<const BinONObj, BinONObj>>
+			>;
+	#endif
 
 	//	DictBase is very much the dictionary counterpart to ListBase. Its
 	//	value() methods return a TDict rather than a TList, of course.
-	struct DictBase {
+	//
+	//	With BINON_DICT_FLAT storage, a dict of up to FlatMap::kSmallSize
+	//	entries is a packed array that takes a single small allocation, and
+	//	only becomes a hash table past that size (see flatmap.hpp). With
+	//	BINON_DICT_ORDERED storage, the entries stay in insertion order, so
+	//	encoding a DictObj writes them in that order and decoding it restores
+	//	the order.
+	//
+	//	Like ListBase, DictBase is a HashCache (see hashutil.hpp).
+	struct DictBase: HashCache {
 		using TValue = TDict;
 		DictBase(const DictBase&) = default;
 		DictBase(DictBase&&) noexcept = default;
@@ -38,9 +100,18 @@ namespace binon {
 		auto value() & -> TValue&;
 		auto value() && -> TValue;
 		auto value() const& -> const TValue&;
+		auto updateValue() & -> TValue&;
 		auto size() const -> std::size_t;
 	 protected:
+
+		//	std::unordered_map cannot be instantiated with BinONObj still
+		//	incomplete, so it has to be tucked away in a std::any. FlatMap
+		//	and OrderedMap can, and avoid the any_cast on every value() call.
+	 #if BINON_DICT_STORAGE == BINON_DICT_STD
 		std::any mValue;
+	 #else
+		TValue mValue;
+	 #endif
 		auto calcHash(std::size_t seed) const -> std::size_t;
 		template<typename T> [[noreturn]] void castError();
 	};
@@ -61,10 +132,11 @@ namespace binon {
 		explicit DictObj(const SKDict& obj);
 		explicit DictObj(const SDict& obj);
 		DictObj() = default;
-		auto encodeData(TOStream&, bool requireIO = true) const
-			-> const DictObj&;
-		auto decodeData(TIStream&, bool requireIO = true)
-			-> DictObj&;
+		using StdCodec<DictObj>::encodeData;
+		using StdCodec<DictObj>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const DictObj&;
+		auto encodedDataSize() const -> std::size_t;
+		auto decodeData(ByteReader& reader) -> DictObj&;
 		auto hash() const -> std::size_t;
 		void printArgs(std::ostream&) const;
 	};
@@ -86,10 +158,11 @@ namespace binon {
 			);
 		SKDict(CodeByte keyCode = kNoObjCode) noexcept;
 		explicit SKDict(const SDict& obj);
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const SKDict&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> SKDict&;
+		using StdCodec<SKDict>::encodeData;
+		using StdCodec<SKDict>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const SKDict&;
+		auto encodedDataSize() const -> std::size_t;
+		auto decodeData(ByteReader& reader) -> SKDict&;
 		auto hash() const -> std::size_t;
 		void printArgs(std::ostream& stream) const;
 	};
@@ -115,10 +188,11 @@ namespace binon {
 		SDict(
 			CodeByte keyCode = kNoObjCode, CodeByte valCode = kNoObjCode
 			) noexcept;
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const SDict&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> SDict&;
+		using StdCodec<SDict>::encodeData;
+		using StdCodec<SDict>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const SDict&;
+		auto encodedDataSize() const -> std::size_t;
+		auto decodeData(ByteReader& reader) -> SDict&;
 		auto hash() const -> std::size_t;
 		void printArgs(std::ostream& stream) const;
 	};
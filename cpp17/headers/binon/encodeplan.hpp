@@ -0,0 +1,98 @@
+#ifndef BINON_ENCODEPLAN_HPP
+#define BINON_ENCODEPLAN_HPP
+
+#include "binonobj.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace binon {
+
+	/*
+	EncodePlanCache class
+
+	An EncodePlanCache speeds up encoding a stream of messages that share the
+	same layout. Say your service emits millions of DictObjs, each with the
+	keys "id", "name", and "score" mapped to a UIntObj, a StrObj, and a
+	FloatObj, respectively. The first time the cache sees a dict of a given
+	shape (its keys plus the type codes of its values), it works out a plan:
+
+		1. The keys are optimized the way OptimalObj() would (see
+		   optimalobj.hpp), which decides between an SKDict-style key block
+		   and a DictObj one.
+		2. If the keys can share a key code and the values all have the same
+		   type code, the dict is encoded as an SDict. Otherwise, it is an
+		   SKDict (or a DictObj if the keys cannot share a code).
+		3. Everything that precedes the values in the encoding (the element
+		   count, key code, and packed keys, plus the value code for an SDict)
+		   is encoded once and kept in the plan.
+
+	Every later dict of the same shape then encodes as a memcpy of that key
+	block followed by a straight pass over its values.
+
+	Unlike OptimalObj(), the plan cannot narrow values (say IntObj to
+	UIntObj), since whether that works depends on the values of each message
+	rather than its shape. Values are encoded as they are, except that any
+	nonempty DictObj or ListObj is in turn encoded through the cache. So a
+	list of messages, or a message holding nested dicts, benefits too. Other
+	objects are simply encoded as usual.
+
+	Note that the shape includes the order in which the std::unordered_map
+	iterates over the keys. Dicts built up the same way iterate in the same
+	order, but if yours do not, each order will simply get its own plan.
+	Looking up a plan means hashing the keys, though the plan used last is
+	tried first by comparing them directly.
+
+	Once the cache holds maxPlans plans, it starts over from scratch rather
+	than growing further.
+
+	Example:
+
+		EncodePlanCache cache;
+		for(auto& msg: messages) {
+			cache.encode(msg, writer);
+		}
+	*/
+	inline constexpr std::size_t kDefMaxPlans = 0x100;
+	class EncodePlanCache {
+	 public:
+		explicit EncodePlanCache(std::size_t maxPlans = kDefMaxPlans);
+
+		//	encode() writes obj in full (code byte and data), throwing
+		//	DepthErr if it nests containers deeper than the writer's
+		//	CodecContext::maxDepth (if you have set one).
+		void encode(const BinONObj& obj, ByteWriter& writer);
+		void encode(
+			const BinONObj& obj, TOStream& stream, bool requireIO = true
+			);
+
+		//	size() returns the number of plans in the cache, and clear()
+		//	forgets them all.
+		auto size() const noexcept -> std::size_t;
+		void clear() noexcept;
+
+	 private:
+		struct Plan {
+			CodeByte mTypeCode = kNoObjCode;
+			CodeByte mValCode = kNoObjCode;
+			TList mKeys;
+			std::vector<CodeByte> mValCodes;
+			TBytes mKeyBlock;
+			auto matches(const TDict& dict) const -> bool;
+		};
+		std::size_t mMaxPlans;
+		std::unordered_multimap<std::size_t,Plan> mPlans;
+		const Plan* mLastPlan;
+
+		void encodeObj(
+			const BinONObj& obj, ByteWriter& writer, std::size_t depth
+			);
+		void encodeDict(
+			const TDict& dict, ByteWriter& writer, std::size_t depth
+			);
+		auto findPlan(const TDict& dict) -> const Plan&;
+		static auto MakePlan(const TDict& dict) -> Plan;
+	};
+}
+
+#endif
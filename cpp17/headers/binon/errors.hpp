@@ -2,6 +2,7 @@
 #define BINON_ERRORS_HPP
 
 #include <any>
+#include <ios>
 #include <sstream>
 #include <stdexcept>
 
@@ -27,6 +28,12 @@ namespace binon {
 	//				TruncErr
 	//					ByteTrunc
 	//					IntTrunc
+	//		std::runtime_error
+	//			LimitErr
+	//				DepthErr
+	//			std::system_error
+	//				std::ios_base::failure
+	//					BufOverrun
 
 	//---- General Exception Types ---------------------------------------------
 	//
@@ -178,6 +185,35 @@ namespace binon {
 		using TypeErr::TypeErr;
 	};
 
+	//	BufOverrun: memory buffer too small for the encoding/decoding operation
+	//
+	//	This is the in-memory equivalent of a stream I/O failure. A SpanWriter
+	//	throws it when the encoded data will not fit its output buffer, and a
+	//	SpanReader throws it when decoding runs past the end of the input (see
+	//	byteio.hpp). Since it derives from std::ios_base::failure, code that
+	//	already catches stream errors will catch it too.
+	struct BufOverrun: std::ios_base::failure {
+		using std::ios_base::failure::failure;
+	};
+
+	//	LimitErr: input exceeds a CodecContext limit
+	//
+	//	The decoder throws this when the encoded data would take it past one of
+	//	the maxBytes, maxCount, or maxStrLen settings (see byteio.hpp).
+	struct LimitErr: std::runtime_error {
+		using std::runtime_error::runtime_error;
+	};
+
+	//	DepthErr: containers nested too deeply
+	//
+	//	A decoder that tracks how deeply lists and dicts are nested within one
+	//	another throws this when the encoded data exceeds its limit (the
+	//	maxDepth of its CodecContext; see byteio.hpp). So does an encoder
+	//	whose writer has been given a maxDepth.
+	struct DepthErr: LimitErr {
+		using LimitErr::LimitErr;
+	};
+
 	//==== Template Implementation =============================================
 
 	//---- BadAnyCast ----------------------------------------------------------
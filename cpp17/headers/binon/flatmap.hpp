@@ -0,0 +1,698 @@
+#ifndef BINON_FLATMAP_HPP
+#define BINON_FLATMAP_HPP
+
+#include "mapbase.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#if BINON_X86_SIMD && defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
+namespace binon {
+
+	/*
+	FlatMap class template
+
+	FlatMap is an open-addressing hash map along the lines of Abseil's
+	"Swiss table". It keeps its entries in a single array of slots, alongside
+	an array of 1-byte control codes that say whether each slot is empty,
+	deleted, or full (in which case the code holds 7 bits of the key's hash).
+	Lookups compare the hash bits of 16 slots at a time (using SSE2 where
+	available) and only compare keys when these match. Iteration is a linear
+	walk through the slot array.
+
+	Small maps (up to kSmallSize entries) are not hash tables at all. They
+	allocate only as many slots as they need, packed at the front of the
+	array, and a lookup scans their control codes in one go for a hash
+	match. (Comparing 2 BinONObjs costs about as much as hashing one, so the
+	hash bits are still worth keeping.) A small map turns into a hash table
+	once it outgrows kSmallSize or you reserve() more room than that. Either
+	way, the control codes and slots share a single memory allocation.
+
+	TDict is a FlatMap when BINON_DICT_STORAGE is BINON_DICT_FLAT (see
+	macros.hpp). Most of its interface comes from MapBase (see mapbase.hpp).
+	Erasing only invalidates iterators and references to the erased entry,
+	except that in a small map, the last entry moves into its place.
+	*/
+	template<
+		typename K, typename V,
+		typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+		typename Alloc = std::allocator<std::pair<const K,V>>
+		>
+	class FlatMap:
+		public MapBase<FlatMap<K,V,Hash,Eq,Alloc>,K,V,Hash,Eq,Alloc>
+	{
+		using TBase = MapBase<FlatMap,K,V,Hash,Eq,Alloc>;
+	 public:
+		using typename TBase::value_type;
+		using typename TBase::size_type;
+		using typename TBase::node_type;
+		static constexpr std::size_t kSmallSize = 8;
+		template<bool Const> class Iter;
+		using iterator = Iter<false>;
+		using const_iterator = Iter<true>;
+		using insert_return_type =
+			typename TBase::template InsertReturn<iterator>;
+
+		FlatMap() noexcept = default;
+		FlatMap(std::initializer_list<value_type> init);
+		template<typename InputIt> FlatMap(InputIt first, InputIt last);
+		FlatMap(const FlatMap& map);
+		FlatMap(FlatMap&& map) noexcept;
+		~FlatMap();
+		auto operator= (const FlatMap& map) -> FlatMap&;
+		auto operator= (FlatMap&& map) noexcept -> FlatMap&;
+		auto operator= (std::initializer_list<value_type> init) -> FlatMap&;
+
+		auto begin() noexcept -> iterator;
+		auto begin() const noexcept -> const_iterator;
+		auto end() noexcept -> iterator;
+		auto end() const noexcept -> const_iterator;
+		auto size() const noexcept { return mSize; }
+
+		//	capacity() is the number of slots, at most 7/8 of which may be
+		//	full. reserve(n) makes enough room for n entries.
+		auto capacity() const noexcept { return mCapacity; }
+		void reserve(size_type n);
+		void clear() noexcept;
+
+		using TBase::erase;
+		using TBase::extract;
+		auto erase(const_iterator pos) -> iterator;
+		auto erase(iterator pos) -> iterator;
+		auto extract(const_iterator pos) -> node_type;
+		void swap(FlatMap& map) noexcept;
+
+	 private:
+		template<typename, typename, typename, typename, typename, typename>
+			friend class MapBase;
+		using TBase::Mix;
+		using TCtrl = signed char;
+		using TSlotAlloc = typename std::allocator_traits<Alloc>::
+			template rebind_alloc<value_type>;
+		static constexpr size_type kGroupSize = 16;
+		static constexpr TCtrl kEmpty = -128;
+		static constexpr TCtrl kDeleted = -2;
+		static constexpr TCtrl kSentinel = -1;
+
+		//	mCtrl has mCapacity + 1 bytes, the last of which is kSentinel to
+		//	stop iteration. (It lives in the same allocation as mSlots, just
+		//	past the last slot.) mGrowthLeft counts how many more empty slots
+		//	can be filled before the table needs to be rehashed. (Deleted
+		//	slots do not give this back, since they still lengthen probes.)
+		//
+		//	A map is small while mCapacity <= kSmallSize, since hash tables
+		//	have at least kGroupSize slots. Its first mSize slots are full,
+		//	and its control codes are padded out to kGroupSize with
+		//	kSentinel so that they can be matched as one group.
+		TCtrl* mCtrl = nullptr;
+		value_type* mSlots = nullptr;
+		size_type mSize = 0;
+		size_type mCapacity = 0;
+		size_type mGrowthLeft = 0;
+
+		static auto H2(std::uint64_t mixed) noexcept
+			{ return static_cast<TCtrl>(mixed & 0x7fu); }
+		static auto MatchByte(const TCtrl* group, TCtrl c) noexcept
+			-> std::uint32_t;
+		static auto MatchEmpty(const TCtrl* group) noexcept
+			{ return MatchByte(group, kEmpty); }
+		static auto MatchAvail(const TCtrl* group) noexcept -> std::uint32_t;
+		static auto LowBit(std::uint32_t mask) noexcept -> size_type;
+		static auto CapacityFor(size_type n) noexcept -> size_type;
+		static auto MaxLoad(size_type capacity) noexcept -> size_type;
+		static auto CtrlSize(size_type capacity) noexcept -> size_type;
+		static auto AllocCount(size_type capacity) noexcept -> size_type;
+
+		auto isSmall() const noexcept { return mCapacity <= kSmallSize; }
+		template<typename Q>
+			auto findKey(const Q& key) -> iterator;
+		template<typename Q>
+			auto findSmall(const Q& key, std::uint64_t mixed) const
+			-> size_type;
+		template<typename Q>
+			auto findIndex(const Q& key, std::uint64_t mixed) const
+			-> size_type;
+		auto findAvail(std::uint64_t mixed) const noexcept -> size_type;
+		auto prepareInsert(std::uint64_t mixed) -> size_type;
+		auto iterAt(size_type i) noexcept -> iterator;
+		auto indexOf(const_iterator pos) const noexcept -> size_type;
+		void eraseAt(size_type i) noexcept;
+		void rehash(size_type capacity);
+		void allocate(size_type capacity);
+		void deallocate() noexcept;
+		void destroyAll() noexcept;
+		template<typename KArg, typename... Args>
+			auto tryEmplace(KArg&& key, Args&&... args)
+			-> std::pair<iterator,bool>;
+	};
+
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<bool Const>
+		class FlatMap<K,V,H,E,A>::Iter {
+		 public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename FlatMap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<
+				Const, const value_type*, value_type*
+				>;
+			using reference = std::conditional_t<
+				Const, const value_type&, value_type&
+				>;
+
+			Iter() noexcept = default;
+			template<bool C = Const, typename = std::enable_if_t<C>>
+				Iter(const Iter<false>& it) noexcept:
+					mCtrl{it.mCtrl}, mSlot{it.mSlot} {}
+			auto operator* () const noexcept -> reference { return *mSlot; }
+			auto operator-> () const noexcept -> pointer { return mSlot; }
+			auto operator++ () noexcept -> Iter&
+				{ ++mCtrl; ++mSlot; skipFree(); return *this; }
+			auto operator++ (int) noexcept -> Iter
+				{ auto it = *this; ++*this; return it; }
+			template<bool C> auto operator== (const Iter<C>& rhs)
+				const noexcept { return mSlot == rhs.mSlot; }
+			template<bool C> auto operator!= (const Iter<C>& rhs)
+				const noexcept { return mSlot != rhs.mSlot; }
+
+		 private:
+			friend class FlatMap;
+			template<bool> friend class Iter;
+			const TCtrl* mCtrl = nullptr;
+			value_type* mSlot = nullptr;
+
+			Iter(const TCtrl* pCtrl, value_type* pSlot) noexcept:
+				mCtrl{pCtrl}, mSlot{pSlot} {}
+
+			//	Advances to the next full slot or the sentinel.
+			void skipFree() noexcept {
+				while(*mCtrl < 0 && *mCtrl != kSentinel) {
+					++mCtrl; ++mSlot;
+				}
+			}
+		};
+
+	template<typename K, typename V, typename H, typename E, typename A>
+		void swap(FlatMap<K,V,H,E,A>& a, FlatMap<K,V,H,E,A>& b) noexcept
+			{ a.swap(b); }
+
+	//==== Template Implementation =============================================
+
+	//---- FlatMap -------------------------------------------------------------
+
+	template<typename K, typename V, typename H, typename E, typename A>
+		FlatMap<K,V,H,E,A>::FlatMap(std::initializer_list<value_type> init)
+	{
+		this->insert(init);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename InputIt>
+		FlatMap<K,V,H,E,A>::FlatMap(InputIt first, InputIt last)
+	{
+		this->insert(first, last);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		FlatMap<K,V,H,E,A>::FlatMap(const FlatMap& map)
+	{
+		if(map.mSize == 0u) {
+			return;
+		}
+		allocate(map.mCapacity);
+		std::memcpy(mCtrl, map.mCtrl, mCapacity);
+		size_type i = 0;
+		try {
+			for(; i < mCapacity; ++i) {
+				if(mCtrl[i] >= 0) {
+					new(mSlots + i) value_type(map.mSlots[i]);
+				}
+			}
+		}
+		catch(...) {
+			while(i-- > 0u) {
+				if(mCtrl[i] >= 0) {
+					mSlots[i].~value_type();
+				}
+			}
+			deallocate();
+			throw;
+		}
+		mSize = map.mSize;
+		mGrowthLeft = map.mGrowthLeft;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		FlatMap<K,V,H,E,A>::FlatMap(FlatMap&& map) noexcept:
+			mCtrl{std::exchange(map.mCtrl, nullptr)},
+			mSlots{std::exchange(map.mSlots, nullptr)},
+			mSize{std::exchange(map.mSize, 0u)},
+			mCapacity{std::exchange(map.mCapacity, 0u)},
+			mGrowthLeft{std::exchange(map.mGrowthLeft, 0u)}
+	{
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		FlatMap<K,V,H,E,A>::~FlatMap()
+	{
+		destroyAll();
+		deallocate();
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::operator= (const FlatMap& map) -> FlatMap&
+	{
+		if(this != &map) {
+			FlatMap copy{map};
+			swap(copy);
+		}
+		return *this;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::operator= (FlatMap&& map) noexcept
+		-> FlatMap&
+	{
+		if(this != &map) {
+			FlatMap tmp{std::move(map)};
+			swap(tmp);
+		}
+		return *this;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::operator= (
+			std::initializer_list<value_type> init) -> FlatMap&
+	{
+		clear();
+		this->insert(init);
+		return *this;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::begin() noexcept -> iterator
+	{
+		if(mSize == 0u) {
+			return end();
+		}
+		iterator it{mCtrl, mSlots};
+		it.skipFree();
+		return it;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::begin() const noexcept -> const_iterator
+	{
+		return const_cast<FlatMap*>(this)->begin();
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::end() noexcept -> iterator
+	{
+		return iterator{mCtrl + mCapacity, mSlots + mCapacity};
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::end() const noexcept -> const_iterator
+	{
+		return const_cast<FlatMap*>(this)->end();
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void FlatMap<K,V,H,E,A>::reserve(size_type n)
+	{
+		if(n > mSize + mGrowthLeft) {
+			rehash(std::max(CapacityFor(n), mCapacity));
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void FlatMap<K,V,H,E,A>::clear() noexcept
+	{
+		if(mCapacity == 0u) {
+			return;
+		}
+		destroyAll();
+		std::memset(mCtrl, static_cast<unsigned char>(kEmpty), mCapacity);
+		mSize = 0u;
+		mGrowthLeft = MaxLoad(mCapacity);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::erase(const_iterator pos) -> iterator
+	{
+		auto i = indexOf(pos);
+		eraseAt(i);
+		auto it = iterAt(i);
+		it.skipFree();
+		return it;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::erase(iterator pos) -> iterator
+	{
+		return erase(const_iterator{pos});
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::extract(const_iterator pos) -> node_type
+	{
+		auto i = indexOf(pos);
+		auto node = TBase::MakeNode(mSlots[i]);
+		eraseAt(i);
+		return node;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void FlatMap<K,V,H,E,A>::swap(FlatMap& map) noexcept
+	{
+		std::swap(mCtrl, map.mCtrl);
+		std::swap(mSlots, map.mSlots);
+		std::swap(mSize, map.mSize);
+		std::swap(mCapacity, map.mCapacity);
+		std::swap(mGrowthLeft, map.mGrowthLeft);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::MatchByte(const TCtrl* group, TCtrl c) noexcept
+		-> std::uint32_t
+	{
+	 #if BINON_X86_SIMD && defined(__SSE2__)
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+		return static_cast<std::uint32_t>(
+			_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)))
+			);
+	 #else
+		std::uint32_t mask = 0;
+		for(size_type i = 0; i < kGroupSize; ++i) {
+			mask |= std::uint32_t{group[i] == c} << i;
+		}
+		return mask;
+	 #endif
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::MatchAvail(const TCtrl* group) noexcept
+		-> std::uint32_t
+	{
+		//	Empty and deleted slots both have codes less than kSentinel.
+	 #if BINON_X86_SIMD && defined(__SSE2__)
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+		return static_cast<std::uint32_t>(
+			_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(kSentinel), v))
+			);
+	 #else
+		std::uint32_t mask = 0;
+		for(size_type i = 0; i < kGroupSize; ++i) {
+			mask |= std::uint32_t{group[i] < kSentinel} << i;
+		}
+		return mask;
+	 #endif
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::LowBit(std::uint32_t mask) noexcept
+		-> size_type
+	{
+	 #if defined(__GNUC__) || defined(__clang__)
+		return static_cast<size_type>(__builtin_ctz(mask));
+	 #else
+		size_type i = 0;
+		for(; (mask & 1u) == 0u; mask >>= 1) {
+			++i;
+		}
+		return i;
+	 #endif
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::CapacityFor(size_type n) noexcept
+		-> size_type
+	{
+		if(n <= kSmallSize) {
+			return n;
+		}
+		size_type capacity = kGroupSize;
+		while(MaxLoad(capacity) < n) {
+			capacity <<= 1;
+		}
+		return capacity;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::MaxLoad(size_type capacity) noexcept
+		-> size_type
+	{
+		return capacity <= kSmallSize ? capacity : capacity - capacity / 8u;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::CtrlSize(size_type capacity) noexcept
+		-> size_type
+	{
+		return capacity <= kSmallSize ? kGroupSize : capacity + 1u;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::AllocCount(size_type capacity) noexcept
+		-> size_type
+	{
+		//	This is the number of slots needed to cover the slots themselves
+		//	plus the control codes that follow them.
+		auto n = CtrlSize(capacity) + sizeof(value_type) - 1u;
+		return capacity + n / sizeof(value_type);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename Q>
+		auto FlatMap<K,V,H,E,A>::findKey(const Q& key) -> iterator
+	{
+		if(mSize == 0u) {
+			return end();
+		}
+		auto mixed = Mix(H{}(key));
+		return iterAt(
+			isSmall() ? findSmall(key, mixed) : findIndex(key, mixed)
+			);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename Q>
+		auto FlatMap<K,V,H,E,A>::findSmall(
+			const Q& key, std::uint64_t mixed) const -> size_type
+	{
+		if(mSize == 0u) {
+			return mCapacity;
+		}
+		for(auto mask = MatchByte(mCtrl, H2(mixed)); mask; mask &= mask - 1u) {
+			auto i = LowBit(mask);
+			if(E{}(mSlots[i].first, key)) {
+				return i;
+			}
+		}
+		return mCapacity;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename Q>
+		auto FlatMap<K,V,H,E,A>::findIndex(
+			const Q& key, std::uint64_t mixed) const -> size_type
+	{
+		//	Groups are probed quadratically (1, 2, 3... groups further along
+		//	each time), which visits every group when the group count is a
+		//	power of 2.
+		auto h2 = H2(mixed);
+		auto groupMask = mCapacity / kGroupSize - 1u;
+		auto g = static_cast<size_type>(mixed >> 7) & groupMask;
+		for(size_type step = 1u; ; ++step) {
+			auto group = mCtrl + g * kGroupSize;
+			for(auto mask = MatchByte(group, h2); mask; mask &= mask - 1u) {
+				auto i = g * kGroupSize + LowBit(mask);
+				if(E{}(mSlots[i].first, key)) {
+					return i;
+				}
+			}
+			if(MatchEmpty(group) || step > groupMask) {
+				return mCapacity;
+			}
+			g = (g + step) & groupMask;
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::findAvail(std::uint64_t mixed) const noexcept
+		-> size_type
+	{
+		auto groupMask = mCapacity / kGroupSize - 1u;
+		auto g = static_cast<size_type>(mixed >> 7) & groupMask;
+		for(size_type step = 1u; ; ++step) {
+			if(auto mask = MatchAvail(mCtrl + g * kGroupSize); mask) {
+				return g * kGroupSize + LowBit(mask);
+			}
+			g = (g + step) & groupMask;
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::prepareInsert(std::uint64_t mixed)
+		-> size_type
+	{
+		auto i = findAvail(mixed);
+		if(mGrowthLeft == 0u && mCtrl[i] == kEmpty) {
+
+			//	Rehash in place if at least half the filled slots are merely
+			//	deleted. Otherwise, double the capacity.
+			rehash(
+				mSize * 2u <= MaxLoad(mCapacity) ? mCapacity : mCapacity * 2u
+				);
+			i = findAvail(mixed);
+		}
+		if(mCtrl[i] == kEmpty) {
+			--mGrowthLeft;
+		}
+		mCtrl[i] = H2(mixed);
+		++mSize;
+		return i;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::iterAt(size_type i) noexcept -> iterator
+	{
+		return iterator{mCtrl + i, mSlots + i};
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto FlatMap<K,V,H,E,A>::indexOf(const_iterator pos) const noexcept
+		-> size_type
+	{
+		return static_cast<size_type>(pos.mSlot - mSlots);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void FlatMap<K,V,H,E,A>::eraseAt(size_type i) noexcept
+	{
+		//	A small map keeps its entries together by moving the last one
+		//	into the gap.
+		if(isSmall()) {
+			auto last = --mSize;
+			if(i != last) {
+				mSlots[i].~value_type();
+				new(mSlots + i) value_type(
+					std::move(const_cast<K&>(mSlots[last].first)),
+					std::move(mSlots[last].second)
+					);
+				mCtrl[i] = mCtrl[last];
+			}
+			mSlots[last].~value_type();
+			mCtrl[last] = kEmpty;
+			++mGrowthLeft;
+			return;
+		}
+
+		//	If the slot's group still has an empty slot, no probe can have
+		//	gone past it, so the slot can simply become empty again.
+		//	Otherwise, it is marked deleted to keep later probes going.
+		mSlots[i].~value_type();
+		--mSize;
+		auto group = mCtrl + i / kGroupSize * kGroupSize;
+		if(MatchEmpty(group)) {
+			mCtrl[i] = kEmpty;
+			++mGrowthLeft;
+		}
+		else {
+			mCtrl[i] = kDeleted;
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void FlatMap<K,V,H,E,A>::rehash(size_type capacity)
+	{
+		//	The new table is allocated before any entries leave the old one,
+		//	so that if allocation fails, the map is left as it was. The old
+		//	table (holding the moved-from entries) is then released by
+		//	table's destructor.
+		FlatMap table;
+		table.allocate(capacity);
+		table.mGrowthLeft = MaxLoad(capacity);
+		for(size_type i = 0; i < mCapacity; ++i) {
+			if(mCtrl[i] >= 0) {
+				auto& entry = mSlots[i];
+				auto mixed = Mix(H{}(entry.first));
+				auto j = table.isSmall() ? table.mSize : table.findAvail(mixed);
+				new(table.mSlots + j) value_type(
+					std::move(const_cast<K&>(entry.first)),
+					std::move(entry.second)
+					);
+				table.mCtrl[j] = H2(mixed);
+				--table.mGrowthLeft;
+				++table.mSize;
+			}
+		}
+		swap(table);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void FlatMap<K,V,H,E,A>::allocate(size_type capacity)
+	{
+		TSlotAlloc slotAlloc;
+		mSlots = std::allocator_traits<TSlotAlloc>::allocate(
+			slotAlloc, AllocCount(capacity)
+			);
+		mCtrl = reinterpret_cast<TCtrl*>(mSlots + capacity);
+		std::memset(mCtrl, static_cast<unsigned char>(kEmpty), capacity);
+		std::memset(
+			mCtrl + capacity, static_cast<unsigned char>(kSentinel),
+			CtrlSize(capacity) - capacity
+			);
+		mCapacity = capacity;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void FlatMap<K,V,H,E,A>::deallocate() noexcept
+	{
+		if(mCapacity == 0u) {
+			return;
+		}
+		TSlotAlloc slotAlloc;
+		std::allocator_traits<TSlotAlloc>::deallocate(
+			slotAlloc, mSlots, AllocCount(mCapacity)
+			);
+		mCtrl = nullptr;
+		mSlots = nullptr;
+		mSize = mCapacity = mGrowthLeft = 0u;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void FlatMap<K,V,H,E,A>::destroyAll() noexcept
+	{
+		if constexpr(!std::is_trivially_destructible_v<value_type>) {
+			for(size_type i = 0; i < mCapacity; ++i) {
+				if(mCtrl[i] >= 0) {
+					mSlots[i].~value_type();
+				}
+			}
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename KArg, typename... Args>
+		auto FlatMap<K,V,H,E,A>::tryEmplace(KArg&& key, Args&&... args)
+		-> std::pair<iterator,bool>
+	{
+		auto mixed = Mix(H{}(key));
+		if(isSmall()) {
+			if(auto i = findSmall(key, mixed); i != mCapacity) {
+				return {iterAt(i), false};
+			}
+			if(mSize == mCapacity) {
+				auto capacity = mCapacity == 0u ? size_type{4} : mCapacity * 2u;
+				rehash(capacity <= kSmallSize ? capacity : kGroupSize);
+			}
+			if(isSmall()) {
+				auto i = mSize;
+				new(mSlots + i) value_type(
+					std::piecewise_construct,
+					std::forward_as_tuple(std::forward<KArg>(key)),
+					std::forward_as_tuple(std::forward<Args>(args)...)
+					);
+				mCtrl[i] = H2(mixed);
+				--mGrowthLeft;
+				++mSize;
+				return {iterAt(i), true};
+			}
+		}
+		else if(auto i = findIndex(key, mixed); i != mCapacity) {
+			return {iterAt(i), false};
+		}
+		auto i = prepareInsert(mixed);
+		try {
+			new(mSlots + i) value_type(
+				std::piecewise_construct,
+				std::forward_as_tuple(std::forward<KArg>(key)),
+				std::forward_as_tuple(std::forward<Args>(args)...)
+				);
+		}
+		catch(...) {
+			--mSize;
+			mCtrl[i] = kDeleted;
+			throw;
+		}
+		return {iterAt(i), true};
+	}
+}
+
+#endif
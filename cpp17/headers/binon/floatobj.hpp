@@ -26,10 +26,12 @@ namespace binon {
 			{ return equals(rhs); }
 		auto operator!= (const FloatObj& rhs) const noexcept
 			{ return !equals(rhs); }
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const FloatObj&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> FloatObj&;
+		using StdCodec<FloatObj>::encodeData;
+		using StdCodec<FloatObj>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const FloatObj&;
+		auto decodeData(ByteReader& reader) -> FloatObj&;
+		constexpr auto encodedDataSize() const noexcept -> std::size_t
+			{ return sizeof(TValue); }
 	};
 	struct Float32Obj:
 		StdAcc<Float32Obj>,
@@ -48,10 +50,12 @@ namespace binon {
 			{ return equals(rhs); }
 		auto operator!= (const Float32Obj& rhs) const noexcept
 			{ return !equals(rhs); }
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const Float32Obj&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> Float32Obj&;
+		using StdCodec<Float32Obj>::encodeData;
+		using StdCodec<Float32Obj>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const Float32Obj&;
+		auto decodeData(ByteReader& reader) -> Float32Obj&;
+		constexpr auto encodedDataSize() const noexcept -> std::size_t
+			{ return sizeof(TValue); }
 	};
 
 	namespace types {
@@ -118,6 +118,85 @@ namespace binon {
 		operator std::size_t() const { return get(); }
 	};
 
+	//---- HashCache class -----------------------------------------------------
+	//
+	//	HashCache is a base class for BinON object types whose hashes take
+	//	some work to compute: StrObj, BufferObj, ListBase, and DictBase. When
+	//	BINON_HASH_CACHE is true (see macros.hpp), cachedHash() calls the
+	//	function you pass it only if there is no hash saved from a previous
+	//	call, and resetHash() discards the saved hash. Otherwise, HashCache is
+	//	an empty class, cachedHash() calls the function every time, and the
+	//	other methods do nothing.
+	//
+	//	An object's non-const value() calls lendValue() rather than
+	//	resetHash(). Since the reference it returns may be kept and written
+	//	through at any later time (as may references into a container's
+	//	elements), the object stops caching altogether from then on. A copy
+	//	starts out caching again, but a move carries the lent state over
+	//	along with the value. (A HashCache that gets moved from is reset,
+	//	since its object's value has been moved away.)
+
+	struct HashCache {
+	 #if BINON_HASH_CACHE
+		HashCache() noexcept = default;
+		HashCache(const HashCache& other) noexcept:
+			mHash{other.mHash}, mHashValid{other.mHashValid}
+		{
+		}
+		HashCache(HashCache&& other) noexcept:
+			mHash{other.mHash}, mHashValid{other.mHashValid},
+			mValueLent{other.mValueLent}
+		{
+			other.resetHash();
+		}
+		auto operator= (const HashCache& other) noexcept -> HashCache& {
+			mHash = other.mHash;
+			mHashValid = other.mHashValid;
+			return *this;
+		}
+		auto operator= (HashCache&& other) noexcept -> HashCache& {
+			mHash = other.mHash;
+			mHashValid = other.mHashValid;
+			mValueLent = mValueLent || other.mValueLent;
+			other.resetHash();
+			return *this;
+		}
+	 #endif
+		template<typename Calc>
+			auto cachedHash(Calc calc) const -> std::size_t {
+			 #if BINON_HASH_CACHE
+				if(mValueLent) {
+					return calc();
+				}
+				if(!mHashValid) {
+					mHash = calc();
+					mHashValid = true;
+				}
+				return mHash;
+			 #else
+				return calc();
+			 #endif
+			}
+		void resetHash() noexcept {
+		 #if BINON_HASH_CACHE
+			mHashValid = false;
+		 #endif
+		}
+		void lendValue() noexcept {
+		 #if BINON_HASH_CACHE
+			mHashValid = false;
+			mValueLent = true;
+		 #endif
+		}
+
+	 #if BINON_HASH_CACHE
+	 private:
+		mutable std::size_t mHash = 0;
+		mutable bool mHashValid = false;
+		bool mValueLent = false;
+	 #endif
+	};
+
 	//	This is nothing more than a random number generated at program launch
 	//	you can apply to your hash values with a simple bitwise-xor (^)
 	//	operation. It will ensure that every time your program runs, it will use
@@ -138,6 +217,12 @@ namespace binon {
 	//	that due to the generally read-only nature of gHashSalt, it has NOT been
 	//	declared atomic.)
 	extern std::size_t gHashSalt;
+
+	//	SaltHash() applies gHashSalt to a hash value the way the std::hash
+	//	specialization for BinONObj does (with the 1-bit rotation). Anything
+	//	that needs to produce the same hashes as std::hash<BinONObj> (e.g.
+	//	KeyHash in dictobj.hpp) should call it rather than salting on its own.
+	auto SaltHash(std::size_t hash) noexcept -> std::size_t;
 }
 
 #endif
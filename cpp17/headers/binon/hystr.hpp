@@ -5,6 +5,7 @@
 
 #include <functional>
 #include <istream>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <string_view>
@@ -40,6 +41,12 @@ namespace binon {
 	call asStr(), thus converting the object from a view to a string if
 	necessary.
 
+	A view may optionally come with an owner: a std::shared_ptr to whatever
+	holds the viewed characters. The BasicHyStr keeps the owner alive for as
+	long as it remains in view form. (This is how StrObj and BufferObj can
+	decode into views that share ownership of the input buffer. See BorrowMode
+	in byteio.hpp.)
+
 	BasicHyStr has yet to expose all the APIs of a basic_string. Here are the
 	ones available so far:
 
@@ -134,6 +141,19 @@ namespace binon {
 			constexpr BasicHyStr(const TChr* cStr) noexcept;
 			constexpr BasicHyStr() noexcept = default;
 
+			/*
+			constructor - owned string view variant
+
+			Loads the BasicHyStr with a string view and holds onto the owner of
+			the viewed memory until the view is discarded.
+
+			Args:
+				sv (const TView&)
+				owner (std::shared_ptr<const void>)
+			*/
+			BasicHyStr(const TView& sv, std::shared_ptr<const void> owner)
+				noexcept;
+
 			//---- Methods Found In std::string --------------------------------
 			//
 			//	These are not specially documented aside from some class notes
@@ -209,12 +229,27 @@ namespace binon {
 			*/
 			constexpr auto hash() const noexcept -> std::size_t;
 
+			/*
+			owner method:
+				Returns:
+					const std::shared_ptr<const void>&:
+						owner of the viewed memory (may be empty)
+			*/
+			auto owner() const noexcept -> const std::shared_ptr<const void>&;
+
 		 private:
 			mutable std::variant<TView,TStr> mV;
+			mutable std::shared_ptr<const void> mOwner;
 		};
 
 	//---- Free Functions Relating to BasicHyStr -------------------------------
 
+	template<typename C, typename T, typename A>
+		auto BasicHyStr<C,T,A>::owner() const noexcept
+			-> const std::shared_ptr<const void>&
+		{
+			return mOwner;
+		}
 	template<typename C, typename T, typename A>
 		constexpr auto operator == (
 			const BasicHyStr<C,T,A>& a,
@@ -271,6 +306,14 @@ namespace binon {
 			mV{static_cast<TView>(cStr)}
 		{
 		}
+	template<typename C, typename T, typename A>
+		BasicHyStr<C,T,A>::BasicHyStr(
+			const TView& sv, std::shared_ptr<const void> owner
+			) noexcept:
+			mV{sv},
+			mOwner{std::move(owner)}
+		{
+		}
 	template<typename C, typename T, typename A>
 		auto BasicHyStr<C,T,A>::at(TSize i) -> TChr& {
 			auto& s = asStr();
@@ -317,6 +360,7 @@ namespace binon {
 			}
 			else {
 				mV = TView{};
+				mOwner.reset();
 			}
 		}
 	template<typename C, typename T, typename A>
@@ -355,6 +399,7 @@ namespace binon {
 			if(!isStr()) {
 				auto& sv = std::get<0>(mV);
 				mV = TStr(sv.begin(), sv.end());
+				mOwner.reset();
 			}
 			return std::get<1>(mV);
 		}
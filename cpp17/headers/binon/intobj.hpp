@@ -3,6 +3,8 @@
 
 #include "hystr.hpp"
 #include "mixins.hpp"
+#include "smallbytes.hpp"
+#include <cstring>
 #include <ostream>
 #include <type_traits>
 #include <variant>
@@ -16,7 +18,10 @@ namespace binon {
 	//	The value types contain take 2 forms internally: scalar or vector. This
 	//	is done using a std::variant between a 64-bit integer (std::int64_t or
 	//	std::uint64_t for IntVal or UIntVal, respectively) and a
-	//	std::basic_string<std::byte> for the vector form.
+	//	std::basic_string<std::byte> for the vector form. (If you define
+	//	BINON_INLINE_BIGINT true, the vector form is a SmallBytes instead,
+	//	which stores values up to 32 bytes long without allocating memory. See
+	//	macros.hpp.)
 	//
 	//	The vector form is needed to represent values that are too large to fit
 	//	in 64 bits. When used, the byte string should follow the big-endian byte
@@ -27,19 +32,26 @@ namespace binon {
 	//
 	//	BinON does not implement a big integer library. However, you may find
 	//	the asHex() and FromHex() methods useful for converting to/from a form
-	//	suitable to third party libraries?
+	//	suitable to third party libraries? There are also asDec() and FromDec()
+	//	for decimal strings.
 
 	struct UIntObj;
 
+	#if BINON_INLINE_BIGINT
+		using TIntVect = SmallBytes<32>;
+	#else
+		using TIntVect = std::basic_string<std::byte>;
+	#endif
+
 	//	IntBase is an abstract CRTP base class that implements common
 	//	functionality between IntVal and UIntVal. It, in turn, inherits all
 	//	public functionality (including constructors) from a std::variant of the
 	//	scalar and vector forms described earlier.
 	template<typename Child, typename Scalar>
-		struct IntBase: std::variant<Scalar, std::basic_string<std::byte>>
+		struct IntBase: std::variant<Scalar, TIntVect>
 		{
 			using TScalar = Scalar; // std::int64_t or std::uint64_t
-			using TVect = std::basic_string<std::byte>;
+			using TVect = TIntVect;
 
 			using std::variant<TScalar,TVect>::variant;
 
@@ -152,9 +164,35 @@ namespace binon {
 		 //	auto asHex(
 		 //		bool zerox = true, std::size_t wordSize = sizeof(TScalar)
 		 //		) const -> std::string;
+
+			//---- Decimal conversion ------------------------------------------
+			//
+			//	FromDec() (defined in subclasses) parses a string of decimal
+			//	digits, optionally preceded by a '+' or '-' sign. (UIntVal
+			//	throws NegUnsigned if the value is negative.) Anything else,
+			//	including an empty string or a sign without digits, throws
+			//	std::invalid_argument.
+			//
+			//	asDec() (defined in subclasses) returns the value as a decimal
+			//	string. Big integers are converted 9 digits at a time, so it is
+			//	far cheaper than going through asHex() and a big integer
+			//	library just to print one.
+
+		 //	static auto FromDec(const HyStr& dec) -> IntVal/UIntVal;
+		 //	auto asDec() const -> std::string;
 		};
 	constexpr bool kSkipNormalize = false;
 
+	namespace details {
+
+		//	VectScalar() converts the big-endian bytes of a vector form
+		//	integer into a scalar, keeping only the least-significant 64 bits
+		//	if there are too many. Signed values are sign-extended.
+		template<typename Scalar>
+			auto VectScalar(const std::byte* p, std::size_t n) noexcept
+				-> Scalar;
+	}
+
 	//	When printing an integer value, it will either print the scalar or a
 	//	hexadecimal version of the vector, depending on which variant is
 	//	available.
@@ -170,6 +208,8 @@ namespace binon {
 		auto asHex(
 			bool zerox = true, std::size_t wordSize = sizeof(TScalar)
 			) const -> std::string;
+		static auto FromDec(const HyStr& dec) -> IntVal;
+		auto asDec() const -> std::string;
 
 		template<typename, typename> friend struct IntBase;
 
@@ -198,6 +238,8 @@ namespace binon {
 		auto asHex(
 			bool zerox = true, std::size_t wordSize = sizeof(TScalar)
 			) const -> std::string;
+		static auto FromDec(const HyStr& dec) -> UIntVal;
+		auto asDec() const -> std::string;
 
 		template<typename, typename> friend struct IntBase;
 
@@ -223,7 +265,6 @@ namespace binon {
 		StdAcc<IntObj>,
 		StdEq<IntObj>,
 		StdHash<IntObj>,
-		StdHasDefVal<IntObj>,
 		StdPrintArgs<IntObj>,
 		StdCodec<IntObj>
 	{
@@ -233,6 +274,7 @@ namespace binon {
 		TValue mValue;
 		explicit IntObj(const UIntObj& obj);
 		IntObj(const IntObj&) = default;
+		IntObj(IntObj&&) noexcept = default;
 		IntObj(TValue v);
 		IntObj() = default;
 		auto operator= (const IntObj&) -> IntObj& = default;
@@ -241,16 +283,38 @@ namespace binon {
 			{ return equals(rhs); }
 		auto operator!= (const IntObj& rhs) const noexcept
 			{ return !equals(rhs); }
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const IntObj&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> IntObj&;
+		using StdCodec<IntObj>::encodeData;
+		using StdCodec<IntObj>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const IntObj&;
+		auto decodeData(ByteReader& reader) -> IntObj&;
+		auto encodedDataSize() const -> std::size_t;
+
+		//	hasDefVal() looks for a scalar 0 directly rather than converting
+		//	mValue to TScalar (as StdHasDefVal would), which throws IntTrunc
+		//	for a big integer.
+		auto hasDefVal() const noexcept -> bool {
+			auto p = std::get_if<IntVal::TScalar>(&mValue);
+			return p && *p == 0;
+		}
+
+		//	EncodeScalar() and EncodedDataSize() are what encodeData() and
+		//	encodedDataSize() amount to for an IntObj holding the scalar v.
+		//	They let typed containers (see nativeelem.hpp) encode native
+		//	integers without wrapping them in objects first.
+		static void EncodeScalar(IntVal::TScalar v, ByteWriter& writer);
+		static auto EncodedDataSize(IntVal::TScalar v) noexcept
+			-> std::size_t;
+
+		//	DecodeScalar() decodes the rest of the data once its first byte
+		//	has been read, provided that byte is not 0xf1 (which introduces
+		//	the variable-length vector form). It never allocates memory.
+		static auto DecodeScalar(std::byte byte0, ByteReader& reader)
+			-> IntVal::TScalar;
 	};
 	struct UIntObj:
 		StdAcc<UIntObj>,
 		StdEq<UIntObj>,
 		StdHash<UIntObj>,
-		StdHasDefVal<UIntObj>,
 		StdPrintArgs<UIntObj>,
 		StdCodec<UIntObj>
 	{
@@ -260,6 +324,7 @@ namespace binon {
 		TValue mValue;
 		explicit UIntObj(const IntObj& obj);
 		UIntObj(const UIntObj&) = default;
+		UIntObj(UIntObj&&) noexcept = default;
 		UIntObj(TValue v);
 		UIntObj() = default;
 		auto operator= (const UIntObj&) -> UIntObj& = default;
@@ -268,10 +333,41 @@ namespace binon {
 			{ return equals(rhs); }
 		auto operator!= (const UIntObj& rhs) const noexcept
 			{ return !equals(rhs); }
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const UIntObj&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> UIntObj&;
+		using StdCodec<UIntObj>::encodeData;
+		using StdCodec<UIntObj>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const UIntObj&;
+		auto decodeData(ByteReader& reader) -> UIntObj&;
+		auto encodedDataSize() const -> std::size_t;
+
+		//	hasDefVal() looks for a scalar 0 directly rather than converting
+		//	mValue to TScalar (as StdHasDefVal would), which throws IntTrunc
+		//	for a big integer.
+		auto hasDefVal() const noexcept -> bool {
+			auto p = std::get_if<UIntVal::TScalar>(&mValue);
+			return p && *p == 0;
+		}
+
+		//	EncodedDataSize() returns what encodedDataSize() would for a
+		//	UIntObj holding the scalar v. It is handy for working out the size
+		//	of the length/count fields that start string and container data.
+		//	EncodeScalar() likewise writes what encodeData() would.
+		static auto EncodedDataSize(UIntVal::TScalar v) noexcept
+			-> std::size_t;
+		static void EncodeScalar(UIntVal::TScalar v, ByteWriter& writer);
+
+		//	DecodeScalar() decodes the rest of the data once its first byte
+		//	has been read, provided that byte is not 0xf1 (which introduces
+		//	the variable-length vector form). It never allocates memory.
+		static auto DecodeScalar(std::byte byte0, ByteReader& reader)
+			-> UIntVal::TScalar;
+
+		//	DecodeSize() decodes UIntObj data serving as a length or element
+		//	count, as found at the start of string and container data. It
+		//	accepts the vector form too, without allocating memory, but throws
+		//	IntTrunc if the value does not fit a std::size_t (which includes
+		//	a vector form whose byte count is itself in vector form). The
+		//	byte count is also subject to ByteReader::checkLength().
+		static auto DecodeSize(ByteReader& reader) -> std::size_t;
 	};
 
 	namespace types {
@@ -280,6 +376,26 @@ namespace binon {
 
 	//==== Template Implementation =============================================
 
+	template<typename Scalar>
+		auto details::VectScalar(const std::byte* p, std::size_t n) noexcept
+			-> Scalar
+		{
+			std::uint64_t u = 0;
+			if(n >= sizeof u) {
+				std::memcpy(&u, p + n - sizeof u, sizeof u);
+				return static_cast<Scalar>(LittleEndian() ? SwapBytes(u) : u);
+			}
+			if(std::is_signed_v<Scalar> && n > 0u &&
+				(p[0] & std::byte{0x80}) != std::byte{0x00})
+			{
+				u = ~std::uint64_t{0};
+			}
+			for(std::size_t i = 0; i < n; ++i) {
+				u = u << 8 | std::to_integer<std::uint64_t>(p[i]);
+			}
+			return static_cast<Scalar>(u);
+		}
+
 	//---- IntBase -------------------------------------------------------------
 
 	template<typename Child, typename Scalar>
@@ -326,29 +442,15 @@ namespace binon {
 			std::function<ReturnType(const TVect&)> callback
 			) const -> ReturnType
 		{
-			using std::get;
-			using Callback = std::function<ReturnType(const TVect&)>;
-			if(isScalar()) {
-				auto i = get<TScalar>(*this);
-				TVect v;
-				v.reserve(sizeof(TScalar));
-				auto n = sizeof(TScalar) << 3;
-				while((n -= 8u) > 0u) {
-					v.push_back(ToByte(i >> n & 0xff));
-				}
-				if constexpr(std::is_same_v<ReturnType,void>) {
-					callback(v);
+			if(auto pScalar = std::get_if<TScalar>(this); pScalar) {
+				TVect v(sizeof(TScalar), std::byte{0});
+				auto i = *pScalar;
+				for(auto n = sizeof(TScalar); n-->0u; i >>= 8) {
+					v[n] = ToByte(i & 0xff);
 				}
-				else {
-					return callback(v);
-				}
-			}
-			if constexpr(std::is_same_v<ReturnType,void>) {
-				callback(get<TVect>(*this));
-			}
-			else {
-				return callback(get<TVect>(*this));
+				return callback(v);
 			}
+			return callback(std::get<TVect>(*this));
 		}
 	template<typename Child, typename Scalar>
 		void IntBase<Child,Scalar>::normalize(bool shrinkToFit) const
@@ -358,66 +460,39 @@ namespace binon {
 		if(!pVect) {
 			return; // it's already a scalar
 		}
-		TVect::size_type trim = 0, sigBytes;
-		if constexpr(std::is_unsigned_v<TScalar>) {
-			for(auto& byt: *pVect) {
 
-				//	In an unsigned integer, any 0x00 bytes in the most-significant positions can be trimmed off.
-				if(byt != 0x00_byte) {
-					break;
-				}
+		//	Leading pad bytes (0x00 or, for a negative IntVal, 0xff) carry no
+		//	significant bits and can be trimmed off. In the signed case,
+		//	though, the last one must stay if the byte after it does not share
+		//	its sign bit. (0x0080 represents 128 rather than the -128 that
+		//	0x80 alone would.)
+		auto& v = *pVect;
+		auto n = v.size();
+		std::size_t trim = 0;
+		if constexpr(std::is_unsigned_v<TScalar>) {
+			while(trim < n && v[trim] == std::byte{0x00}) {
 				++trim;
 			}
-
-			//	The number of signficant bytes remaining would simply be the
-			//	ones that are not trimmed. (Technically, you could wind up with
-			//	0 significant bytes which would be weird, but it doesn't really
-			//	matter since anything less than 8 will get the value converted
-			//	to scalar.)
-			sigBytes = pVect->length() - trim;
 		}
-		else {
-
-			//	In the signed integer case, the pad bytes could be either a
-			//	series of 0x00 or 0xff bytes. We need to track which ones we are
-			//	seeing.
-			std::byte padByte = 0x00_byte;
-			for(auto& byt: *pVect) {
-				switch(std::to_integer<unsigned>(byt)) {
-				 case 0x00u:
-					if(byt != padByte) {
-						goto endFor;
-					}
-					break;
-				 case 0xffu:
-					if(trim == 0) {
-						padByte = 0xff_byte;
-					}
-					else if(byt != padByte) {
-						goto endFor;
-					}
-				}
+		else if(n > 0u) {
+			auto pad = (v[0] & std::byte{0x80}) != std::byte{0x00} ?
+				std::byte{0xff} : std::byte{0x00};
+			while(trim + 1u < n && v[trim] == pad &&
+				((v[trim + 1u] ^ pad) & std::byte{0x80}) == std::byte{0x00})
+			{
 				++trim;
 			}
-		 endFor:
-			sigBytes = pVect->length() - trim;
-
-			//	There is a special case for a single 0x00 "pad byte" that should
-			//	NOT be trimmed off. When the most-significant bit of the
-			//	most-significant byte is set, IntVal treats the number as
-			//	negative. In other words, that bit is sign-extended. But say you
-			//	wanted to encode 0x80 as the positive number 128 rather than
-			//	-128. You would need go with 0x0080 to distinguish it from
-			//	0xff80.
-			if(trim == 1 && padByte == 0x00_byte) {
-				trim = 0;
-			}
 		}
-		if(sigBytes <= sizeof(TScalar)) {
-			*mutThis = static_cast<const Child*>(this)->asScalar();
+		if(n - trim <= sizeof(TScalar)) {
+			*mutThis = details::VectScalar<TScalar>(v.data() + trim, n - trim);
 		}
-		else if(trim > 0u) {
-			pVect->erase(0u, trim);
+		else {
+			if(trim > 0u) {
+				v.erase(0u, trim);
+			}
+			if(shrinkToFit) {
+				v.shrink_to_fit();
+			}
 		}
 	}
 	template<typename Child, typename Scalar>
@@ -0,0 +1,189 @@
+#ifndef BINON_LAZYOBJ_HPP
+#define BINON_LAZYOBJ_HPP
+
+#include "objhelpers.hpp"
+
+#include <atomic>
+#include <memory>
+
+namespace binon {
+
+	/*
+	LazyObj class
+
+	LazyObj is a read-only view of a BinON object sitting in an encoded
+	buffer. Rather than decoding the whole tree up front the way
+	BinONObj::Decode() does, it only decodes the parts you actually touch.
+
+	Example:
+
+		auto bytes = std::make_shared<const TBytes>(LoadMessage());
+		LazyObj msg{bytes};
+		auto name = GetObjVal<std::string>(msg.find("name").value());
+		auto score = msg.find("scores").value()[3].get<double>();
+
+	The first time you index into a container, LazyObj walks over its
+	elements once (using SkipObj() and friends from skipobj.hpp) to record
+	where each one begins. The elements themselves are LazyObjs, which in turn
+	index their own contents only when you reach into them. Dict lookups
+	decode the keys (but not the values) on the first call to find() and hash
+	them for subsequent calls. Scalars and strings are decoded each time you
+	call decode() or get(), using the same codecs BinONObj::Decode() would.
+
+	An index, once built, is shared by all copies of the LazyObj, so copying
+	one is cheap. It is not thread-safe, however, for two threads to trigger
+	the building of the same index at the same time.
+
+	Codec context:
+		You can pass the constructors a CodecContext (see byteio.hpp) to be
+		applied to every reader LazyObj uses on the buffer, both to skip over
+		elements while indexing and to decode them. Element LazyObjs inherit
+		it from their container. Note that the limits apply to each skip or
+		decode individually, so maxDepth is counted from the object being
+		skipped or decoded rather than from the root of the buffer. The
+		exception is maxNullCount. Since indexes persist, the NullObj
+		elements they hold are counted across every LazyObj on the buffer
+		(i.e. the one you constructed and all the elements reached from it).
+
+	Memory management:
+		If you supply a shared_ptr owning the buffer, every LazyObj holds a
+		reference to it, and decode() can lend string data out in
+		BorrowMode::kShared form (see byteio.hpp). Otherwise, it is up to you
+		to keep the buffer alive as long as any LazyObj refers to it.
+	*/
+	class LazyObj {
+	 public:
+
+		//	The constructors read the code byte of the object at the start of
+		//	the buffer (throwing BufOverrun if there is none). Nothing else is
+		//	read until you ask for it.
+		LazyObj(
+			const std::byte* data, std::size_t size,
+			std::shared_ptr<const void> owner = {},
+			const CodecContext& context = {}
+			);
+		explicit LazyObj(
+			const TBytes& bytes, const CodecContext& context = {}
+			);
+		explicit LazyObj(
+			std::shared_ptr<const TBytes> bytes,
+			const CodecContext& context = {}
+			);
+
+		//	typeCode() returns the same thing BinONObj::typeCode() would
+		//	after decoding the object.
+		auto typeCode() const noexcept -> CodeByte;
+
+		//	isList() is true for a ListObj or SList and isDict() for a DictObj,
+		//	SKDict, or SDict.
+		auto isList() const noexcept -> bool;
+		auto isDict() const noexcept -> bool;
+
+		//	size() returns the number of elements in a list or entries in a
+		//	dict. It throws NonCtnrType for anything else.
+		auto size() const -> std::size_t;
+
+		//	The subscript operator returns the list element (or dict value)
+		//	at a given index. key() returns the dict key at an index. Both
+		//	throw std::out_of_range if the index is too large. Dict entries
+		//	appear in the order in which they were encoded. The references
+		//	stay valid as long as this LazyObj (or a copy of it) does.
+		auto operator[] (std::size_t index) const -> const LazyObj&;
+		auto key(std::size_t index) const -> const LazyObj&;
+
+		//	find() looks up the value associated with a dict key. The key can
+		//	be any type TypeConv knows, as with FindObj() in dicthelpers.hpp.
+		//	For an SKDict or SDict, it is converted to the dict's key type
+		//	first. find() returns std::nullopt if there is no such key.
+		template<typename Key>
+			auto find(const Key& key) const -> OptRef<const LazyObj>;
+
+		//	decode() fully decodes the object (including any contents, in the
+		//	case of a container). With kShared, string data is lent out as
+		//	views if the LazyObj owns its buffer or copied otherwise.
+		auto decode(BorrowMode mode = BorrowMode::kShared) const -> BinONObj;
+
+		//	get() is shorthand for GetObjVal<T>(decode()).
+		template<typename T> auto get() const
+			BINON_CONCEPTS_FN(TCType<T>, kIsTCType<T>, TGetObjVal<T>);
+
+		//	data() points to the start of the object in the buffer and
+		//	extent() returns its byte length. (Elements of simple containers
+		//	have no code bytes of their own, so data() points to their data.
+		//	Packed bools have an extent of 0.)
+		auto data() const noexcept -> const std::byte*;
+		auto extent() const -> std::size_t;
+
+	 private:
+		struct Index;
+
+		const std::byte* mBuf = nullptr;
+		std::size_t mBufSize = 0;
+		std::shared_ptr<const void> mOwner;
+		std::size_t mStart = 0;
+		std::size_t mDataPos = 0;
+		CodeByte mCode;
+		CodecContext mContext;
+		std::shared_ptr<std::atomic<std::size_t>> mNullCount;
+		mutable std::shared_ptr<const Index> mIndex;
+
+		LazyObj(const LazyObj& parent, std::size_t start, std::size_t dataPos,
+			CodeByte code);
+		auto reader(BorrowMode mode) const -> SpanReader;
+		auto index() const -> const Index&;
+		auto findObj(const BinONObj& key) const -> OptRef<const LazyObj>;
+		auto keyCode() const -> CodeByte;
+	};
+
+	//	These overloads let you treat a LazyObj much like a BinONObj when
+	//	using the helpers in objhelpers.hpp and dicthelpers.hpp.
+	//
+	//template<TCType T>
+	//	auto GetObjVal(const LazyObj& obj) -> TGetObjVal<T>;
+	//template<TCType Key>
+	//	auto FindObj(const LazyObj& dict, const Key& key)
+	//	-> OptRef<const LazyObj>;
+
+	//==== Template Implementation =============================================
+
+	//---- LazyObj -------------------------------------------------------------
+
+	template<typename Key> auto LazyObj::find(const Key& key) const
+		-> OptRef<const LazyObj>
+	{
+		auto code = keyCode();
+		if constexpr(std::is_base_of_v<BinONObj,Key>) {
+			if(code == kNoObjCode) {
+				return findObj(key);
+			}
+			return findObj(key.asTypeCodeObj(code));
+		}
+		else {
+			if(code == kNoObjCode) {
+				return findObj(MakeObj(key));
+			}
+			return findObj(MakeTypeCodeObj(code, key));
+		}
+	}
+	template<typename T> auto LazyObj::get() const
+		BINON_CONCEPTS_FN(TCType<T>, kIsTCType<T>, TGetObjVal<T>)
+	{
+		return GetObjVal<T>(decode());
+	}
+
+	//---- Helper functions ----------------------------------------------------
+
+	template<typename T> auto GetObjVal(const LazyObj& obj)
+		BINON_CONCEPTS_FN(TCType<T>, kIsTCType<T>, TGetObjVal<T>)
+	{
+		return obj.get<T>();
+	}
+	template<typename Key>
+		auto FindObj(const LazyObj& dict, const Key& key)
+			-> OptRef<const LazyObj>
+	{
+		return dict.find(key);
+	}
+}
+
+#endif
@@ -149,10 +149,10 @@ namespace binon {
 		)
 	{
 		if constexpr(std::is_base_of_v<SList,List>) {
-			list.value().push_back(MakeTypeCodeObj(list.mElemCode, v));
+			list.updateValue().push_back(MakeTypeCodeObj(list.mElemCode, v));
 		}
 		else {
-			list.value().push_back(MakeObj(v));
+			list.updateValue().push_back(MakeObj(v));
 		}
 		return list;
 	}
@@ -165,10 +165,12 @@ namespace binon {
 		)
 	{
 		if constexpr(std::is_base_of_v<SList,List>) {
-			list.value().push_back(MakeTypeCodeObj(list.mElemCode, std::move(v)));
+			list.updateValue().push_back(
+				MakeTypeCodeObj(list.mElemCode, std::move(v))
+				);
 		}
 		else {
-			list.value().push_back(MakeObj(std::move(v)));
+			list.updateValue().push_back(MakeObj(std::move(v)));
 		}
 
 		return list;
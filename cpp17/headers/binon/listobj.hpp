@@ -18,7 +18,10 @@ namespace binon {
 	using TList = std::vector<BinONObj,BINON_ALLOCATOR<BinONObj>>;
 
 	//	ListBase implements a number of methods shared by ListObj and SList.
-	struct ListBase {
+	//	It is a HashCache (see hashutil.hpp), so hashing a list can be O(1)
+	//	after the first time if BINON_HASH_CACHE is defined true. Its value()
+	//	and updateValue() methods work like StdAcc's (see mixins.hpp).
+	struct ListBase: HashCache {
 		using TValue = TList;
 		ListBase(const ListBase&) = default;
 		ListBase(ListBase&&) noexcept = default;
@@ -27,9 +30,10 @@ namespace binon {
 		auto operator = (ListBase&&) noexcept -> ListBase& = default;
 		auto operator == (const ListBase& rhs) const -> bool;
 		auto operator != (const ListBase& rhs) const -> bool;
-		auto value() & -> TValue& { return mValue; }
-		auto value() && -> TValue { return std::move(mValue); }
+		auto value() & -> TValue& { return lendValue(), mValue; }
+		auto value() && -> TValue { return resetHash(), std::move(mValue); }
 		auto value() const& -> const TValue& { return mValue; }
+		auto updateValue() & -> TValue& { return resetHash(), mValue; }
 		auto size() const -> std::size_t;
 		auto hasDefVal() const -> bool { return size() == 0; }
 
@@ -45,10 +49,11 @@ namespace binon {
 		ListObj(const TList& list);
 		ListObj(TList&& list) noexcept;
 		using ListBase::ListBase;
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const ListObj&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> ListObj&;
+		using StdCodec<ListObj>::encodeData;
+		using StdCodec<ListObj>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const ListObj&;
+		auto encodedDataSize() const -> std::size_t;
+		auto decodeData(ByteReader& reader) -> ListObj&;
 		auto hash() const -> std::size_t;
 		void printArgs(std::ostream& stream) const;
 	};
@@ -60,10 +65,11 @@ namespace binon {
 		SList(const TList& list, CodeByte elemCode);
 		SList(TList&& list, CodeByte elemCode) noexcept;
 		SList(CodeByte elemCode = kNoObjCode);
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const SList&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> SList&;
+		using StdCodec<SList>::encodeData;
+		using StdCodec<SList>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const SList&;
+		auto encodedDataSize() const -> std::size_t;
+		auto decodeData(ByteReader& reader) -> SList&;
 		auto hash() const -> std::size_t;
 		void printArgs(std::ostream& stream) const;
 	};
@@ -43,6 +43,46 @@ static_assert(__cplusplus > 201402L, "BinON requires C++17 or later");
 	#define BINON_STREAM_BYTE std::ios::char_type
 #endif
 
+//	If BINON_INLINE_BIGINT is defined true, IntVal and UIntVal keep the bytes
+//	of their vector (big integer) form in a SmallBytes (see smallbytes.hpp)
+//	that holds up to 32 bytes without allocating memory, rather than in a
+//	std::basic_string<std::byte>. It must be defined the same way for the
+//	library and your own code.
+#ifndef BINON_INLINE_BIGINT
+	#define BINON_INLINE_BIGINT false
+#endif
+
+//	BINON_DICT_STORAGE selects the container behind TDict (see dictobj.hpp).
+//	By default, it is BINON_DICT_STD: a std::unordered_map. BINON_DICT_FLAT
+//	makes it a FlatMap (see flatmap.hpp) instead, an open-addressing table
+//	that keeps its entries in one contiguous array and stores dicts of up to
+//	8 entries as a packed array rather than a hash table. BINON_DICT_ORDERED
+//	makes it an OrderedMap (see orderedmap.hpp), which iterates and encodes
+//	dicts in the order their keys were inserted (or decoded), so the same
+//	dict always encodes to the same bytes regardless of the hash salt. As
+//	with BINON_INLINE_BIGINT, it must be defined the same way for the
+//	library and your own code.
+#define BINON_DICT_STD 0
+#define BINON_DICT_FLAT 1
+#define BINON_DICT_ORDERED 2
+#ifndef BINON_DICT_STORAGE
+	#define BINON_DICT_STORAGE BINON_DICT_STD
+#endif
+
+//	If BINON_HASH_CACHE is defined true, StrObj, BufferObj, and the list and
+//	dict object types remember their hash() the first time it is computed
+//	and return it directly after that (see HashCache in hashutil.hpp). This
+//	helps if you use strings or containers as dict keys, or hash the same
+//	large objects repeatedly. An object stops caching once its value() &
+//	method has handed out a reference that could be written through later,
+//	but updateValue() only clears the cache (see StdAcc in mixins.hpp). Also
+//	note that hashing the same object from more than one thread at a time is
+//	then no longer safe, since hash() writes to the cache. It must be defined
+//	the same way for the library and your own code.
+#ifndef BINON_HASH_CACHE
+	#define BINON_HASH_CACHE false
+#endif
+
 //	Macros that kick in if C++20 or later is available.
 #if __cplusplus > 201703L
 	#define BINON_CPP20 true
@@ -81,6 +121,16 @@ static_assert(__cplusplus > 201402L, "BinON requires C++17 or later");
 		#endif
 	#endif
 
+	//	BINON_MMAP is set true if the POSIX memory-mapping API is available.
+	//	(MMapFile in mmapfile.hpp falls back on reading the whole file into
+	//	memory otherwise.) You can define it false yourself to force the
+	//	fallback.
+	#ifndef BINON_MMAP
+		#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+			#define BINON_MMAP true
+		#endif
+	#endif
+
 	//	See if C++20 concepts are available.
 	#if BINON_CPP20 && __has_include(<concepts>)
 		#include <concepts>
@@ -202,6 +252,9 @@ static_assert(__cplusplus > 201402L, "BinON requires C++17 or later");
 #ifndef BINON_CONCEPTS
 	#define BINON_CONCEPTS false
 #endif
+#ifndef BINON_MMAP
+	#define BINON_MMAP false
+#endif
 #if !BINON_CONCEPTS
 	#define BINON_IF_CONCEPTS(code)
 	#define BINON_NO_CONCEPTS(code) code
@@ -242,4 +295,16 @@ static_assert(__cplusplus > 201402L, "BinON requires C++17 or later");
 	#define BINON_RESTRICT
 #endif
 
+//	BINON_X86_SIMD is set true when building for x86-64 with GCC or Clang.
+//	The bulk integer decoders (see varint.hpp) then check at runtime whether
+//	the CPU supports AVX2 or SSE4.1 and use it if so. You can define it false
+//	yourself to stick to plain C++.
+#ifndef BINON_X86_SIMD
+	#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+		#define BINON_X86_SIMD true
+	#else
+		#define BINON_X86_SIMD false
+	#endif
+#endif
+
 #endif
@@ -0,0 +1,435 @@
+#ifndef BINON_MAPBASE_HPP
+#define BINON_MAPBASE_HPP
+
+#include "typeutil.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace binon {
+
+	/*
+	MapBase class template
+
+	MapBase implements the part of the std::unordered_map interface that
+	FlatMap (see flatmap.hpp) and OrderedMap (see orderedmap.hpp) share. TDict
+	is one of these when BINON_DICT_STORAGE says so (see macros.hpp), so
+	between them, they support the subset of the interface BinON itself uses,
+	including extract() and node handles.
+
+	MapBase is a CRTP mix-in (see mixins.hpp). The Child class supplies the
+	storage: its constructors, begin(), end(), size(), reserve(), clear(),
+	swap(), and the iterator overloads of erase() and extract(). (It needs
+	using-declarations for MapBase's erase and extract, which these would
+	otherwise hide.) It must also give MapBase access to these 2 methods,
+	which everything else here is built on:
+
+		template<typename Q>
+			auto findKey(const Q& key) -> iterator;
+		template<typename KArg, typename... Args>
+			auto tryEmplace(KArg&& key, Args&&... args)
+			-> std::pair<iterator,bool>;
+
+	findKey() returns end() if there is no match, and tryEmplace() constructs
+	the mapped value from args only if key is not there yet.
+
+	The main difference from std::unordered_map is that inserting may move
+	entries around in memory, invalidating references as well as iterators.
+	(Erasing only invalidates iterators and references to the erased entry,
+	except as noted for the Child class.)
+
+	Both maps assume the allocator is stateless, and they may be instantiated
+	with incomplete key and mapped types (as TDict is, inside DictBase)
+	provided they are complete by the time you call any of their methods.
+	*/
+	template<
+		typename Child, typename K, typename V,
+		typename Hash, typename Eq, typename Alloc
+		>
+	class MapBase {
+	 public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<const K,V>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using hasher = Hash;
+		using key_equal = Eq;
+		using allocator_type = Alloc;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		class node_type;
+		template<typename It> struct InsertReturn;
+		template<typename Q> using TEnableIfLookup = std::enable_if_t<
+			kIsTransparent<Hash> && kIsTransparent<Eq> &&
+			std::is_invocable_v<const Hash&, const Q&> &&
+			!std::is_convertible_v<const Q&, const K&>
+			>;
+
+		//	Methods that return the Child's iterators deduce their return
+		//	types, since the Child is still incomplete where MapBase gets
+		//	instantiated.
+		auto cbegin() const noexcept { return child().begin(); }
+		auto cend() const noexcept { return child().end(); }
+		auto empty() const noexcept { return child().size() == 0u; }
+
+		auto find(const K& key);
+		auto find(const K& key) const;
+
+		//	If Hash and Eq are both transparent (see kIsTransparent in
+		//	typeutil.hpp), find() also accepts any type of key they can hash
+		//	and compare against a K, as std::unordered_map does in C++20.
+		//	(Types that convert to K still get converted first, rather than
+		//	being converted anew for every hash and comparison.)
+		template<typename Q, typename = TEnableIfLookup<Q>>
+			auto find(const Q& key);
+		template<typename Q, typename = TEnableIfLookup<Q>>
+			auto find(const Q& key) const;
+		auto count(const K& key) const -> size_type;
+		auto contains(const K& key) const -> bool;
+		auto at(const K& key) -> V&;
+		auto at(const K& key) const -> const V&;
+		auto operator[] (const K& key) -> V&;
+		auto operator[] (K&& key) -> V&;
+
+		template<typename... Args>
+			auto emplace(Args&&... args);
+		template<typename... Args>
+			auto try_emplace(const K& key, Args&&... args);
+		template<typename... Args>
+			auto try_emplace(K&& key, Args&&... args);
+		template<typename M>
+			auto insert_or_assign(const K& key, M&& obj);
+		template<typename M>
+			auto insert_or_assign(K&& key, M&& obj);
+		auto insert(const value_type& value);
+		auto insert(value_type&& value);
+		template<typename InputIt> void insert(InputIt first, InputIt last);
+		void insert(std::initializer_list<value_type> init);
+		auto insert(node_type&& node);
+
+		auto erase(const K& key) -> size_type;
+		auto extract(const K& key) -> node_type;
+
+		auto hash_function() const { return Hash{}; }
+		auto key_eq() const { return Eq{}; }
+
+		//	Equality requires the same keys mapped to equal values. As with
+		//	std::unordered_map, the order of iteration does not matter.
+		auto operator== (const Child& rhs) const -> bool;
+		auto operator!= (const Child& rhs) const -> bool
+			{ return !(*this == rhs); }
+
+	 protected:
+
+		//	Mix() scrambles the bits of a hash. std::hash is often the
+		//	identity function for integers (with BinONObj's salt xor-ed in),
+		//	which would leave runs of consecutive keys probing the same part
+		//	of the table.
+		static auto Mix(std::size_t hash) noexcept -> std::uint64_t;
+
+		//	MakeNode() moves an entry that is about to be erased into a node.
+		static auto MakeNode(value_type& entry) -> node_type;
+
+	 private:
+		auto child() noexcept -> Child&
+			{ return *static_cast<Child*>(this); }
+		auto child() const noexcept -> const Child&
+			{ return *static_cast<const Child*>(this); }
+	};
+
+	//	node_type is a cut-down version of the std::unordered_map node handle.
+	//	It holds an entry after extract() and lets you modify the key before
+	//	insert() puts it back.
+	template<
+		typename Child, typename K, typename V,
+		typename Hash, typename Eq, typename Alloc
+		>
+		class MapBase<Child,K,V,Hash,Eq,Alloc>::node_type {
+		 public:
+			using key_type = K;
+			using mapped_type = V;
+			node_type() noexcept = default;
+			auto empty() const noexcept { return !mEntry.has_value(); }
+			explicit operator bool() const noexcept { return !empty(); }
+			auto key() const -> K& { return mEntry->first; }
+			auto mapped() const -> V& { return mEntry->second; }
+		 private:
+			friend class MapBase;
+			mutable std::optional<std::pair<K,V>> mEntry;
+		};
+
+	//	The Child defines insert_return_type as InsertReturn<iterator>.
+	template<
+		typename Child, typename K, typename V,
+		typename Hash, typename Eq, typename Alloc
+		>
+	template<typename It>
+		struct MapBase<Child,K,V,Hash,Eq,Alloc>::InsertReturn {
+			It position;
+			bool inserted;
+			node_type node;
+		};
+
+	//==== Template Implementation =============================================
+
+	//---- MapBase -------------------------------------------------------------
+
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::find(const K& key)
+	{
+		return child().findKey(key);
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::find(const K& key) const
+	{
+		using TIter = typename C::const_iterator;
+		return TIter{const_cast<C&>(child()).findKey(key)};
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+	template<typename Q, typename>
+		auto MapBase<C,K,V,H,E,A>::find(const Q& key)
+	{
+		return child().findKey(key);
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+	template<typename Q, typename>
+		auto MapBase<C,K,V,H,E,A>::find(const Q& key) const
+	{
+		using TIter = typename C::const_iterator;
+		return TIter{const_cast<C&>(child()).findKey(key)};
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::count(const K& key) const -> size_type
+	{
+		return find(key) == child().end() ? 0u : 1u;
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::contains(const K& key) const -> bool
+	{
+		return find(key) != child().end();
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::at(const K& key) -> V&
+	{
+		auto it = find(key);
+		if(it == child().end()) {
+			throw std::out_of_range{"map key not found"};
+		}
+		return it->second;
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::at(const K& key) const -> const V&
+	{
+		return const_cast<MapBase*>(this)->at(key);
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::operator[] (const K& key) -> V&
+	{
+		return child().tryEmplace(key).first->second;
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::operator[] (K&& key) -> V&
+	{
+		return child().tryEmplace(std::move(key)).first->second;
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+	template<typename... Args>
+		auto MapBase<C,K,V,H,E,A>::emplace(Args&&... args)
+	{
+		std::pair<K,V> entry(std::forward<Args>(args)...);
+		return child().tryEmplace(
+			std::move(entry.first), std::move(entry.second)
+			);
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+	template<typename... Args>
+		auto MapBase<C,K,V,H,E,A>::try_emplace(const K& key, Args&&... args)
+	{
+		return child().tryEmplace(key, std::forward<Args>(args)...);
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+	template<typename... Args>
+		auto MapBase<C,K,V,H,E,A>::try_emplace(K&& key, Args&&... args)
+	{
+		return child().tryEmplace(std::move(key), std::forward<Args>(args)...);
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+	template<typename M>
+		auto MapBase<C,K,V,H,E,A>::insert_or_assign(const K& key, M&& obj)
+	{
+		auto res = child().tryEmplace(key, std::forward<M>(obj));
+		if(!res.second) {
+			res.first->second = std::forward<M>(obj);
+		}
+		return res;
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+	template<typename M>
+		auto MapBase<C,K,V,H,E,A>::insert_or_assign(K&& key, M&& obj)
+	{
+		auto res = child().tryEmplace(std::move(key), std::forward<M>(obj));
+		if(!res.second) {
+			res.first->second = std::forward<M>(obj);
+		}
+		return res;
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::insert(const value_type& value)
+	{
+		return child().tryEmplace(value.first, value.second);
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::insert(value_type&& value)
+	{
+		return child().tryEmplace(value.first, std::move(value.second));
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+	template<typename InputIt>
+		void MapBase<C,K,V,H,E,A>::insert(InputIt first, InputIt last)
+	{
+		if constexpr(std::is_base_of_v<
+			std::forward_iterator_tag,
+			typename std::iterator_traits<InputIt>::iterator_category
+			>)
+		{
+			child().reserve(child().size() + std::distance(first, last));
+		}
+		for(; first != last; ++first) {
+			insert(*first);
+		}
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		void MapBase<C,K,V,H,E,A>::insert(
+			std::initializer_list<value_type> init)
+	{
+		insert(init.begin(), init.end());
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::insert(node_type&& node)
+	{
+		using TReturn = typename C::insert_return_type;
+		if(node.empty()) {
+			return TReturn{child().end(), false, {}};
+		}
+		auto res = child().tryEmplace(
+			std::move(node.mEntry->first), std::move(node.mEntry->second)
+			);
+		if(res.second) {
+			return TReturn{res.first, true, {}};
+		}
+		return TReturn{res.first, false, std::move(node)};
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::erase(const K& key) -> size_type
+	{
+		auto it = find(key);
+		if(it == child().end()) {
+			return 0u;
+		}
+		child().erase(it);
+		return 1u;
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::extract(const K& key) -> node_type
+	{
+		auto it = find(key);
+		return it == child().end() ? node_type{} : child().extract(it);
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::operator== (const C& rhs) const -> bool
+	{
+		if(child().size() != rhs.size()) {
+			return false;
+		}
+		for(auto& entry: child()) {
+			auto it = rhs.find(entry.first);
+			if(it == rhs.end() || !(it->second == entry.second)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::Mix(std::size_t hash) noexcept
+		-> std::uint64_t
+	{
+		//	This is the 64-bit finalizer from MurmurHash3.
+		std::uint64_t x = hash;
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdu;
+		x ^= x >> 33;
+		return x;
+	}
+	template<
+		typename C, typename K, typename V, typename H, typename E, typename A
+		>
+		auto MapBase<C,K,V,H,E,A>::MakeNode(value_type& entry) -> node_type
+	{
+		//	The key is const only to keep callers from changing it while it
+		//	is in the map. Since the entry is about to be destroyed, moving
+		//	out of it is fine.
+		node_type node;
+		node.mEntry.emplace(
+			std::move(const_cast<K&>(entry.first)), std::move(entry.second)
+			);
+		return node;
+	}
+}
+
+#endif
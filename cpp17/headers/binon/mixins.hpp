@@ -18,18 +18,25 @@ Every specific BinON class implements the following minimum public interface:
 	auto value() & -> TValue&;
 	auto value() const& -> const TValue&;
 	auto value() && -> TValue; // where relevant
+	auto updateValue() & -> TValue&; // where relevant
 	auto operator== (OBJECT_TYPE) const -> bool;
 	auto operator!= (OBJECT_TYPE) const -> bool;
 	auto hash() const -> std::size_t;
 	auto hasDefVal() const -> bool;
 	auto encode(TOStream& stream, bool requireIO = true) const
 		-> const OBJECT_TYPE&;
+	auto encode(ByteWriter& writer) const -> const OBJECT_TYPE&;
 	auto decode(CodeByte cb, TIStream& stream, bool requireIO = true)
 		-> OBJECT_TYPE&;
+	auto decode(CodeByte cb, ByteReader& reader) -> OBJECT_TYPE&;
 	auto encodeData(TOStream& stream, bool requireIO = true) const
 		-> const OBJECT_TYPE&;
+	auto encodeData(ByteWriter& writer) const -> const OBJECT_TYPE&;
 	auto decodeData(TIStream& stream, bool requireIO = true)
 		-> OBJECT_TYPE&;
+	auto decodeData(ByteReader& reader) -> OBJECT_TYPE&;
+	auto encodedSize() const -> std::size_t;
+	auto encodedDataSize() const -> std::size_t;
 	void printArgs(std::ostream& stream) const;
 
 Note that in the current implementation, operator== and operator!= will throw
@@ -37,27 +44,61 @@ NoComparing and hash() will throw NoHashing for container types.
 
 BinONObj::print() combines kClsName with printArgs() to form the text
 representation of the object.
+
+The ByteWriter/ByteReader (see byteio.hpp) overloads of encodeData() and
+decodeData() are where the actual work gets done. Each class implements these
+itself, while StdCodec supplies the stream overloads, which wrap the stream in a
+StreamWriter/StreamReader and call them. (A class that uses StdCodec needs
+using-declarations for StdCodec's encodeData and decodeData, since its own
+overloads would otherwise hide them.)
+
+encodedDataSize() returns the exact number of bytes encodeData() would write,
+and encodedSize() the number encode() would write. They walk the object
+without encoding anything, so you can size an output buffer (e.g. reserve a
+TBytes for a VectorWriter or allocate one for a SpanWriter) before encoding
+into it. Each class implements encodedDataSize(), while StdCodec supplies
+encodedSize().
 */
 
 #include "codebyte.hpp"
 #include "hashutil.hpp"
 #include <any>
 #include <sstream>
+#include <type_traits>
 
 namespace binon {
 
-	//	Builds value() methods around an mValue data member.
+	//	Builds value() methods around an mValue data member. If the child
+	//	class is a HashCache (see hashutil.hpp), value() & lends it the value
+	//	and value() && resets it. updateValue() returns the same reference as
+	//	value() & but only resets the cache, so it is for code that is done
+	//	writing through the reference before the object is next hashed.
 	template<typename Child>
 		struct StdAcc {
 			auto& value() & {
-					return static_cast<Child*>(this)->mValue;
+					auto& child = *static_cast<Child*>(this);
+					if constexpr(std::is_base_of_v<HashCache,Child>) {
+						child.lendValue();
+					}
+					return child.mValue;
 				}
 			auto value() && {
-					return std::move(static_cast<Child*>(this)->mValue);
+					auto& child = *static_cast<Child*>(this);
+					if constexpr(std::is_base_of_v<HashCache,Child>) {
+						child.resetHash();
+					}
+					return std::move(child.mValue);
 				}
 			auto& value() const& {
 					return static_cast<const Child*>(this)->mValue;
 				}
+			auto& updateValue() & {
+					auto& child = *static_cast<Child*>(this);
+					if constexpr(std::is_base_of_v<HashCache,Child>) {
+						child.resetHash();
+					}
+					return child.mValue;
+				}
 		};
 
 	//	Has operators == and != directly compare value()'s results on 2 objects.
@@ -71,15 +112,24 @@ namespace binon {
 		};
 
 	//	Implements hash() method. This is done by combining the hash of the
-	//	class type code with a hash of the value()'s result.
+	//	class type code with a hash of the value()'s result. If the child
+	//	class is a HashCache, the result goes through its cachedHash().
 	template<typename Child>
 		struct StdHash {
-			auto hash() const noexcept {
+			auto hash() const noexcept -> std::size_t {
 					using TValue = typename Child::TValue;
 					auto& child = *static_cast<const Child*>(this);
-					auto codeHash = std::hash<CodeByte>{}(child.kTypeCode);
-					auto valHash = std::hash<TValue>{}(child.mValue);
-					return HashCombine(codeHash, valHash);
+					auto calc = [&child]() noexcept -> std::size_t {
+						auto codeHash = std::hash<CodeByte>{}(child.kTypeCode);
+						auto valHash = std::hash<TValue>{}(child.mValue);
+						return HashCombine(codeHash, valHash);
+					};
+					if constexpr(std::is_base_of_v<HashCache,Child>) {
+						return child.cachedHash(calc);
+					}
+					else {
+						return calc();
+					}
 				}
 		};
 
@@ -102,20 +152,31 @@ namespace binon {
 		};
 
 	//	Implements encode() and decode() methods by calling encodeData()
-	//	and decodeData() internally.
+	//	and decodeData() internally. It also implements the stream versions of
+	//	encodeData() and decodeData() by calling the ByteWriter/ByteReader
+	//	versions the child class defines.
 	template<typename Child>
 		struct StdCodec {
 			static void Encode(
 				const Child& child, TOStream& stream, bool requireIO = true
 				);
+			static void Encode(const Child& child, ByteWriter& writer);
 			static void Decode(
 				Child& child, CodeByte cb, TIStream& stream,
 				bool requireIO = true
 				);
+			static void Decode(Child& child, CodeByte cb, ByteReader& reader);
 			auto encode(TOStream& stream, bool requireIO = true) const
 				-> const Child&;
+			auto encode(ByteWriter& writer) const -> const Child&;
 			auto decode(CodeByte cb, TIStream& stream, bool requireIO = true)
 				-> Child&;
+			auto decode(CodeByte cb, ByteReader& reader) -> Child&;
+			auto encodeData(TOStream& stream, bool requireIO = true) const
+				-> const Child&;
+			auto decodeData(TIStream& stream, bool requireIO = true)
+				-> Child&;
+			auto encodedSize() const -> std::size_t;
 		};
 
 	//==== Template Implementation =============================================
@@ -127,15 +188,20 @@ namespace binon {
 			const Child& child, TOStream& stream, bool requireIO
 			)
 		{
-			RequireIO rio{stream, requireIO};
+			StreamWriter writer{stream, requireIO};
+			child.encode(writer);
+			writer.flush();
+		}
+	template<typename Child>
+		void StdCodec<Child>::Encode(const Child& child, ByteWriter& writer) {
 			CodeByte cb = Child::kTypeCode;
 			bool hasDefVal = child.hasDefVal();
 			if(hasDefVal) {
 				Subtype{cb} = Subtype::kDefault;
 			}
-			cb.write(stream, kSkipRequireIO);
+			cb.write(writer);
 			if(!hasDefVal) {
-				child.encodeData(stream, kSkipRequireIO);
+				child.encodeData(writer);
 			}
 		}
 	template<typename Child>
@@ -143,9 +209,16 @@ namespace binon {
 			Child& child, CodeByte cb, TIStream& stream, bool requireIO
 			)
 		{
-			RequireIO rio{stream, requireIO};
+			StreamReader reader{stream, requireIO};
+			child.decode(cb, reader);
+		}
+	template<typename Child>
+		void StdCodec<Child>::Decode(
+			Child& child, CodeByte cb, ByteReader& reader
+			)
+		{
 			if(Subtype(cb) != Subtype::kDefault) {
-				child.decodeData(stream, kSkipRequireIO);
+				child.decodeData(reader);
 			}
 		}
 	template<typename Child>
@@ -157,6 +230,13 @@ namespace binon {
 			Encode(child, stream, requireIO);
 			return child;
 		}
+	template<typename Child>
+		auto StdCodec<Child>::encode(ByteWriter& writer) const -> const Child&
+		{
+			auto& child = *static_cast<const Child*>(this);
+			Encode(child, writer);
+			return child;
+		}
 	template<typename Child>
 		auto StdCodec<Child>::decode(
 			CodeByte cb, TIStream& stream, bool requireIO
@@ -166,6 +246,40 @@ namespace binon {
 			Decode(child, cb, stream, requireIO);
 			return child;
 		}
+	template<typename Child>
+		auto StdCodec<Child>::decode(CodeByte cb, ByteReader& reader)
+			-> Child&
+		{
+			auto& child = *static_cast<Child*>(this);
+			Decode(child, cb, reader);
+			return child;
+		}
+	template<typename Child>
+		auto StdCodec<Child>::encodeData(
+			TOStream& stream, bool requireIO
+			) const -> const Child&
+		{
+			auto& child = *static_cast<const Child*>(this);
+			StreamWriter writer{stream, requireIO};
+			child.encodeData(writer);
+			writer.flush();
+			return child;
+		}
+	template<typename Child>
+		auto StdCodec<Child>::decodeData(
+			TIStream& stream, bool requireIO
+			) -> Child&
+		{
+			auto& child = *static_cast<Child*>(this);
+			StreamReader reader{stream, requireIO};
+			child.decodeData(reader);
+			return child;
+		}
+	template<typename Child>
+		auto StdCodec<Child>::encodedSize() const -> std::size_t {
+			auto& child = *static_cast<const Child*>(this);
+			return child.hasDefVal() ? 1u : 1u + child.encodedDataSize();
+		}
 }
 
 #endif
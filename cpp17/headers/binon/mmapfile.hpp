@@ -0,0 +1,114 @@
+#ifndef BINON_MMAPFILE_HPP
+#define BINON_MMAPFILE_HPP
+
+#include "byteio.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+
+namespace binon {
+
+	/*
+	MMapFile class
+
+	MMapFile maps a file into memory read-only so that you can decode it with a
+	SpanReader. This avoids copying the file through a stream buffer, and since
+	the mapping is reference-counted, it combines naturally with
+	BorrowMode::kShared: decoded strings and buffers can be views straight into
+	the mapped file that keep the mapping alive for as long as they exist.
+
+	Example:
+
+		auto file = MMapFile::Open("snapshot.binon");
+		auto reader = file->reader();
+		auto obj = BinONObj::Decode(reader);
+		// file can go out of scope now; obj's string views keep it mapped
+
+	Files of any size the address space can accommodate are supported. (On a
+	64-bit system, that means files well beyond 4 GiB. On a 32-bit system, a
+	file that does not fit std::size_t throws std::length_error.)
+
+	Where mmap() is unavailable (see BINON_MMAP in macros.hpp), MMapFile reads
+	the whole file into memory instead. The interface is the same either way.
+
+	MMapFile instances can only be created by Open(), which returns a
+	std::shared_ptr to one.
+	*/
+	class MMapFile: public std::enable_shared_from_this<MMapFile> {
+	 public:
+
+		//	These advice flags map onto the corresponding madvise() hints. You
+		//	can combine them with |. (They are ignored in the non-mmap
+		//	fallback.)
+		//
+		//	kAdviseSequential: the file will be read front to back, so the
+		//		kernel should read ahead aggressively and may drop pages once
+		//		they have been read
+		//	kAdviseRandom: the file will be accessed randomly, so read-ahead
+		//		is pointless
+		//	kAdviseWillNeed: start paging the file (or range) in now
+		static constexpr unsigned
+			kAdviseNormal = 0x0u,
+			kAdviseSequential = 0x1u,
+			kAdviseRandom = 0x2u,
+			kAdviseWillNeed = 0x4u;
+		static constexpr std::size_t kToEnd
+			= std::numeric_limits<std::size_t>::max();
+
+		//	Open() maps the file at path and applies the advice flags to the
+		//	whole mapping. The default advice suits decoding a file from start
+		//	to finish.
+		//
+		//	It throws std::system_error if the file cannot be opened or mapped.
+		static auto Open(
+			const std::string& path,
+			unsigned advice = kAdviseSequential | kAdviseWillNeed
+			) -> std::shared_ptr<const MMapFile>;
+
+		MMapFile(const MMapFile&) = delete;
+		auto operator= (const MMapFile&) -> MMapFile& = delete;
+		~MMapFile();
+
+		auto data() const noexcept -> const std::byte*;
+		auto size() const noexcept -> std::size_t;
+
+		//	advise() applies advice flags to a byte range of the file. For
+		//	example, if you know you are about to decode an object at a
+		//	particular offset, you could call
+		//
+		//		file->advise(MMapFile::kAdviseWillNeed, offset, length);
+		//
+		//	to have the kernel start reading it in. The range is expanded to
+		//	page boundaries as needed. Advice is only a hint, so failures are
+		//	silently ignored.
+		void advise(
+			unsigned advice, std::size_t offset = 0, std::size_t length = kToEnd
+			) const noexcept;
+
+		//	reader() returns a SpanReader over the whole file (or the part
+		//	starting at offset). It defaults to BorrowMode::kShared, so that
+		//	borrowed views keep the file mapped.
+		auto reader(
+			BorrowMode mode = BorrowMode::kShared, std::size_t offset = 0
+			) const -> SpanReader;
+
+	 private:
+		struct PrivateTag {};
+
+		const std::byte* mData = nullptr;
+		std::size_t mSize = 0;
+	 #if !BINON_MMAP
+		TBytes mBytes;
+	 #endif
+
+	 public:
+		//	Only usable by Open() (hence the private tag type), but it needs
+		//	to be public for std::make_shared.
+		MMapFile(PrivateTag, const std::string& path, unsigned advice);
+	};
+
+}
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef BINON_NATIVEELEM_HPP
+#define BINON_NATIVEELEM_HPP
+
+#include "bitvec.hpp"
+#include "objhelpers.hpp"
+#include "varint.hpp"
+
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace binon {
+
+	/*
+	NativeElem struct template
+
+	NativeElem<T> describes how a native C++ type T is encoded as an element
+	of a simple container (SList, SKDict, or SDict) without being wrapped in a
+	BinONObj first. The typed containers (see slistt.hpp) use it to encode and
+	decode their elements directly.
+
+	NativeElem supports the following types:
+
+		T                     Element Code
+		_                     ____________
+
+		bool                  kBoolObjCode
+		signed integers       kIntObjCode
+		unsigned integers     kUIntCode
+		TFloat64              kFloatObjCode
+		TFloat32              kFloat32Code
+		std::string           kStrObjCode
+
+	Each specialization looks something like this:
+
+		static constexpr CodeByte kElemCode = ...;
+		static void Encode(const T& v, ByteWriter& writer);
+		static auto Decode(ByteReader& reader) -> T;
+		static auto EncodedSize(const T& v) -> std::size_t;
+
+	bool is the exception in that it has only kElemCode. Bools get packed 8 to
+	a byte, so they can only be encoded and decoded as a run, which is what the
+	PackNative and UnpackNative helpers below are for.
+
+	Decode() throws IntTrunc if a decoded integer will not fit T. (GetObjVal()
+	would simply static_cast it, but a typed container cannot store a value it
+	would misrepresent when encoding it again.) The integer specializations
+	also have a Narrow() function that performs this check on a scalar
+	decoded some other way, as by ReadVarintRun() (see varint.hpp).
+
+	kIsNativeElem<T> tells you whether NativeElem supports T.
+	*/
+	template<typename T, typename Enable = void>
+		struct NativeElem;
+
+	//	The integer specializations call this when a value is out of range.
+	[[ noreturn ]] void ThrowNativeElemTrunc();
+
+	//	CheckNativeElemCode() throws BadElemType if the element code read from
+	//	the input is not the one a typed container expects.
+	void CheckNativeElemCode(CodeByte elemCode, CodeByte expected);
+
+	template<typename T, typename Enable = void>
+		constexpr bool kIsNativeElem = false;
+	template<typename T>
+		constexpr bool kIsNativeElem<
+			T, std::void_t<decltype(NativeElem<T>::kElemCode)>
+			> = true;
+ BINON_IF_CONCEPTS(
+	template<typename T> concept NativeElemType = kIsNativeElem<T>;
+ )
+
+	template<>
+		struct NativeElem<bool> {
+			static constexpr CodeByte kElemCode = kBoolObjCode;
+		};
+ #if BINON_CONCEPTS
+	template<std::signed_integral T>
+		struct NativeElem<T>
+ #else
+	template<typename T>
+		struct NativeElem<
+			T, std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>>
+			>
+ #endif
+		{
+			static constexpr CodeByte kElemCode = kIntObjCode;
+			static void Encode(T v, ByteWriter& writer) {
+					IntObj::EncodeScalar(v, writer);
+				}
+			static auto Decode(ByteReader& reader) -> T {
+					auto byte0 = reader.get();
+					if(byte0 == 0xf1_byte) {
+						ThrowNativeElemTrunc();
+					}
+					return Narrow(IntObj::DecodeScalar(byte0, reader));
+				}
+			static auto Narrow(IntVal::TScalar v) -> T {
+					if constexpr(sizeof(T) < sizeof v) {
+						if(v < std::numeric_limits<T>::min() ||
+							v > std::numeric_limits<T>::max())
+						{
+							ThrowNativeElemTrunc();
+						}
+					}
+					return static_cast<T>(v);
+				}
+			static auto EncodedSize(T v) noexcept -> std::size_t {
+					return IntObj::EncodedDataSize(v);
+				}
+		};
+ #if BINON_CONCEPTS
+	template<std::unsigned_integral T>
+		requires (!std::same_as<T,bool>)
+		struct NativeElem<T>
+ #else
+	template<typename T>
+		struct NativeElem<
+			T, std::enable_if_t<
+				std::is_unsigned_v<T> && !std::is_same_v<T,bool>
+				>
+			>
+ #endif
+		{
+			static constexpr CodeByte kElemCode = kUIntCode;
+			static void Encode(T v, ByteWriter& writer) {
+					UIntObj::EncodeScalar(v, writer);
+				}
+			static auto Decode(ByteReader& reader) -> T {
+					auto byte0 = reader.get();
+					if(byte0 == 0xf1_byte) {
+						ThrowNativeElemTrunc();
+					}
+					return Narrow(UIntObj::DecodeScalar(byte0, reader));
+				}
+			static auto Narrow(UIntVal::TScalar v) -> T {
+					if constexpr(sizeof(T) < sizeof v) {
+						if(v > std::numeric_limits<T>::max()) {
+							ThrowNativeElemTrunc();
+						}
+					}
+					return static_cast<T>(v);
+				}
+			static auto EncodedSize(T v) noexcept -> std::size_t {
+					return UIntObj::EncodedDataSize(v);
+				}
+		};
+	template<>
+		struct NativeElem<types::TFloat64> {
+			static constexpr CodeByte kElemCode = kFloatObjCode;
+			static void Encode(types::TFloat64 v, ByteWriter& writer) {
+					BytePack(v, writer);
+				}
+			static auto Decode(ByteReader& reader) -> types::TFloat64 {
+					return ByteUnpack<types::TFloat64>(reader);
+				}
+			static constexpr auto EncodedSize(types::TFloat64) noexcept
+				-> std::size_t { return sizeof(types::TFloat64); }
+		};
+	template<>
+		struct NativeElem<types::TFloat32> {
+			static constexpr CodeByte kElemCode = kFloat32Code;
+			static void Encode(types::TFloat32 v, ByteWriter& writer) {
+					BytePack(v, writer);
+				}
+			static auto Decode(ByteReader& reader) -> types::TFloat32 {
+					return ByteUnpack<types::TFloat32>(reader);
+				}
+			static constexpr auto EncodedSize(types::TFloat32) noexcept
+				-> std::size_t { return sizeof(types::TFloat32); }
+		};
+	template<>
+		struct NativeElem<std::string> {
+			static constexpr CodeByte kElemCode = kStrObjCode;
+			static void Encode(const std::string& v, ByteWriter& writer);
+			static auto Decode(ByteReader& reader) -> std::string;
+			static auto EncodedSize(const std::string& v) noexcept
+				-> std::size_t;
+		};
+
+	//	PackNative and UnpackNative encode and decode a run of native elements
+	//	one at a time, much as PackElems and UnpackElems do for BinONObj
+	//	elements (see packelems.hpp). With bools, you must call flush() after
+	//	the last element to write out any partial byte.
+	template<typename T>
+		struct PackNative {
+			explicit PackNative(ByteWriter& writer) noexcept:
+				mWriter{writer} {}
+			void operator() (const T& v) { NativeElem<T>::Encode(v, mWriter); }
+			void flush() {}
+		 private:
+			ByteWriter& mWriter;
+		};
+	template<>
+		struct PackNative<bool> {
+			explicit PackNative(ByteWriter& writer) noexcept;
+			void operator() (bool v);
+			void flush();
+		 private:
+			ByteWriter& mWriter;
+			std::byte mByte;
+			unsigned mBits;
+		};
+	template<typename T>
+		struct UnpackNative {
+			explicit UnpackNative(ByteReader& reader) noexcept:
+				mReader{reader} {}
+			auto operator() () -> T { return NativeElem<T>::Decode(mReader); }
+		 private:
+			ByteReader& mReader;
+		};
+	template<>
+		struct UnpackNative<bool> {
+			explicit UnpackNative(ByteReader& reader) noexcept;
+			auto operator() () -> bool;
+		 private:
+			ByteReader& mReader;
+			std::byte mByte;
+			unsigned mBits;
+		};
+
+	//	PackNativeRun() encodes proj(elem) for every elem in range, which is
+	//	how the typed containers pack their elements, keys, or values.
+	//	Integers are encoded in bulk by WriteIntVarints() or
+	//	WriteUIntVarints() (see varint.hpp), and everything else one at a
+	//	time by PackNative.
+	template<typename T, typename Range, typename Proj>
+		void PackNativeRun(const Range& range, Proj proj, ByteWriter& writer)
+		{
+			if constexpr(std::is_integral_v<T> && !std::is_same_v<T,bool>) {
+				using TScalar = std::conditional_t<
+					std::is_signed_v<T>, IntVal::TScalar, UIntVal::TScalar
+					>;
+				constexpr std::size_t kChunk = 0x100;
+				std::array<TScalar,kChunk> buf;
+				std::size_t m = 0;
+				auto writeBuf = [&] {
+					if constexpr(std::is_signed_v<T>) {
+						WriteIntVarints(buf.data(), m, writer);
+					}
+					else {
+						WriteUIntVarints(buf.data(), m, writer);
+					}
+					m = 0;
+				};
+				for(auto&& elem: range) {
+					buf[m++] = static_cast<TScalar>(proj(elem));
+					if(m == kChunk) {
+						writeBuf();
+					}
+				}
+				writeBuf();
+			}
+			else {
+				PackNative<T> pack{writer};
+				for(auto&& elem: range) {
+					pack(proj(elem));
+				}
+				pack.flush();
+			}
+		}
+
+	//	UnpackNativeRun() decodes n native elements, appending them to out (a
+	//	std::vector or the like). Integers are decoded in bulk by
+	//	ReadVarintRun() (see varint.hpp), bools by reading all their packed
+	//	bytes into a BitVec (see bitvec.hpp) at once, and everything else one
+	//	at a time by UnpackNative.
+	template<typename T, typename Vector>
+		void UnpackNativeRun(std::size_t n, Vector& out, ByteReader& reader) {
+			if constexpr(std::is_integral_v<T> && !std::is_same_v<T,bool>) {
+				using TScalar = std::conditional_t<
+					std::is_signed_v<T>, IntVal::TScalar, UIntVal::TScalar
+					>;
+				ReadVarintRun<TScalar>(
+					reader, n,
+					[&out](TScalar v) {
+						out.push_back(NativeElem<T>::Narrow(v));
+					},
+					[&out, &reader] {
+						out.push_back(NativeElem<T>::Decode(reader));
+					}
+					);
+			}
+			else if constexpr(std::is_same_v<T,bool>) {
+				BitVec bits;
+				bits.read(reader, n);
+				for(std::size_t i = 0; i < bits.size(); ++i) {
+					out.push_back(bits[i]);
+				}
+			}
+			else {
+				UnpackNative<T> unpack{reader};
+				for(; n > 0; --n) {
+					out.push_back(unpack());
+				}
+			}
+		}
+}
+
+#endif
@@ -22,6 +22,10 @@ namespace binon {
 			const noexcept {}
 		constexpr void decodeData(TIStream&, bool requireIO = true)
 			noexcept {}
+		constexpr void encodeData(ByteWriter&) const noexcept {}
+		constexpr void decodeData(ByteReader&) noexcept {}
+		constexpr auto encodedDataSize() const noexcept -> std::size_t
+			{ return 0u; }
 		constexpr void printArgs(std::ostream&) const noexcept {}
 	};
 }
@@ -0,0 +1,84 @@
+#ifndef BINON_OPTIMALOBJ_HPP
+#define BINON_OPTIMALOBJ_HPP
+
+#include "binonobj.hpp"
+
+namespace binon {
+
+	/*
+	OptimalObj function
+
+	OptimalObj() is the C++ counterpart to BinONObj.OptimalObj() in the Python
+	interface. It returns a copy of your object tree in which every object has
+	been swapped for whichever type encodes it most compactly:
+
+		IntObj -> UIntObj
+			for positive values (and zero within a container)
+		FloatObj -> Float32Obj
+			for nonzero values (or zero within a container) that survive the
+			conversion to single precision exactly
+		ListObj -> SList
+			if all the elements can share an element code
+		DictObj -> SKDict or SDict
+			if all the keys (and values) can share an element code
+
+	Elements whose types differ only in subtype are unified by widening them.
+	For example, a list of the IntObj -1 and the UIntObj 2 becomes an SList
+	of IntObj, and one mixing FloatObj and Float32Obj becomes an SList of
+	FloatObj. Since widening can make an element larger (a Float32Obj needs 4
+	more bytes as a FloatObj), OptimalObj() totals up both ways of encoding
+	the elements and keeps the ListObj or DictObj when that is smaller. Bools
+	end up packed 8 to a byte in an SList whenever they can.
+
+	SList, SKDict, and SDict objects are left exactly as you made them, on the
+	assumption that you chose their element codes for a reason. So are the
+	keys of a DictObj that mixes IntObj keys with UIntObj keys (or FloatObj
+	with Float32Obj), since 2 distinct keys like IntObj 1 and UIntObj 1 would
+	otherwise collapse into one. Likewise, if optimizing the container keys
+	of a DictObj would make any 2 of them equal (e.g. a ListObj of IntObj 1
+	and a ListObj of UIntObj 1 would both become an SList of UIntObj 1), all
+	of its container keys are left as they were. Distinct keys therefore
+	never collapse.
+
+	All of this takes a pass over each element that can cost about as much as
+	encoding it. Containers with more than OptimizeOpts::cheapCount elements
+	are therefore handled in cheap mode instead. Here, the scalar elements are
+	left as they are, and the container becomes an SList (or SKDict/SDict)
+	only if its elements (or keys and values) already share the exact same
+	type code. Working that out is a matter of comparing type codes, so it
+	costs next to nothing next to the encoding. Nested containers still get
+	optimized according to their own sizes, of course.
+
+	OptimalObj() throws DepthErr if containers are nested more than
+	OptimizeOpts::maxDepth deep. (Note that you can give your writer's
+	CodecContext a maxDepth of its own, which the encoder checks.)
+
+	If you do not need the original object anymore, move it into OptimalObj()
+	to avoid copying the tree:
+
+		auto obj = OptimalObj(std::move(tree));
+		obj.encode(writer);
+
+	EncodeOptimal() is shorthand for OptimalObj(obj).encode(writer). It is
+	what Encode(..., optimize=True) does in the Python interface.
+	*/
+	inline constexpr std::size_t kDefCheapCount = 0x10000;
+	struct OptimizeOpts {
+		std::size_t cheapCount = kDefCheapCount;
+		std::size_t maxDepth = kDefMaxDepth;
+	};
+	auto OptimalObj(const BinONObj& obj, const OptimizeOpts& opts = {})
+		-> BinONObj;
+	auto OptimalObj(BinONObj&& obj, const OptimizeOpts& opts = {})
+		-> BinONObj;
+	void EncodeOptimal(
+		const BinONObj& obj, ByteWriter& writer,
+		const OptimizeOpts& opts = {}
+		);
+	void EncodeOptimal(
+		const BinONObj& obj, TOStream& stream, bool requireIO = true,
+		const OptimizeOpts& opts = {}
+		);
+}
+
+#endif
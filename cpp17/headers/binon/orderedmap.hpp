@@ -0,0 +1,649 @@
+#ifndef BINON_ORDEREDMAP_HPP
+#define BINON_ORDEREDMAP_HPP
+
+#include "mapbase.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace binon {
+
+	/*
+	OrderedMap class template
+
+	OrderedMap is a hash map that remembers the order in which its keys were
+	inserted, laid out the way CPython has laid out its dicts since 3.6. The
+	entries go into a dense array in insertion order, each alongside its
+	(scrambled) hash. A separate index table, which is the actual hash
+	table, maps hashes to positions in the entry array. Since the index
+	table only holds small integers (1, 2, 4, or 8 bytes wide depending on
+	the capacity), it can afford to be sparse while the entries stay packed.
+
+	Iteration walks the entry array from front to back, so it is both
+	cache-friendly and deterministic: a dict built or decoded the same way
+	always iterates, and therefore encodes, in the same order, regardless of
+	the hash salt. Lookups compare the stored hashes before comparing keys,
+	and growing the table never needs to rehash a key.
+
+	Erasing an entry leaves a hole in the entry array (which iteration
+	skips) rather than shifting the ones after it down. The holes are
+	squeezed out the next time the array fills up and gets reallocated.
+
+	Small maps (up to kSmallSize entries) have no index table at all. A
+	lookup simply scans their stored hashes.
+
+	TDict is an OrderedMap when BINON_DICT_STORAGE is BINON_DICT_ORDERED (see
+	macros.hpp). Most of its interface comes from MapBase (see mapbase.hpp).
+	Erasing only invalidates iterators and references to the erased entry.
+	Equality does not depend on order.
+	*/
+	template<
+		typename K, typename V,
+		typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+		typename Alloc = std::allocator<std::pair<const K,V>>
+		>
+	class OrderedMap:
+		public MapBase<OrderedMap<K,V,Hash,Eq,Alloc>,K,V,Hash,Eq,Alloc>
+	{
+		using TBase = MapBase<OrderedMap,K,V,Hash,Eq,Alloc>;
+	 public:
+		using typename TBase::value_type;
+		using typename TBase::size_type;
+		using typename TBase::node_type;
+		static constexpr std::size_t kSmallSize = 8;
+		template<bool Const> class Iter;
+		using iterator = Iter<false>;
+		using const_iterator = Iter<true>;
+		using insert_return_type =
+			typename TBase::template InsertReturn<iterator>;
+
+		OrderedMap() noexcept = default;
+		OrderedMap(std::initializer_list<value_type> init);
+		template<typename InputIt> OrderedMap(InputIt first, InputIt last);
+		OrderedMap(const OrderedMap& map);
+		OrderedMap(OrderedMap&& map) noexcept;
+		~OrderedMap();
+		auto operator= (const OrderedMap& map) -> OrderedMap&;
+		auto operator= (OrderedMap&& map) noexcept -> OrderedMap&;
+		auto operator= (std::initializer_list<value_type> init)
+			-> OrderedMap&;
+
+		auto begin() noexcept -> iterator;
+		auto begin() const noexcept -> const_iterator;
+		auto end() noexcept -> iterator;
+		auto end() const noexcept -> const_iterator;
+		auto size() const noexcept { return mSize; }
+
+		//	capacity() is the length of the entry array, erased entries
+		//	included. reserve(n) makes enough room for n entries.
+		auto capacity() const noexcept { return mCapacity; }
+		void reserve(size_type n);
+		void clear() noexcept;
+
+		using TBase::erase;
+		using TBase::extract;
+		auto erase(const_iterator pos) -> iterator;
+		auto erase(iterator pos) -> iterator;
+		auto extract(const_iterator pos) -> node_type;
+		void swap(OrderedMap& map) noexcept;
+
+	 private:
+		template<typename, typename, typename, typename, typename, typename>
+			friend class MapBase;
+		struct Entry;
+		using TEntryAlloc = typename std::allocator_traits<Alloc>::
+			template rebind_alloc<Entry>;
+		static constexpr std::uint64_t kErased = ~std::uint64_t{0};
+
+		//	mEntries has room for mCapacity entries, the first mUsed of which
+		//	have been filled. mSize of those have not been erased since, and
+		//	mBegin is the position of the first of these.
+		//
+		//	mIndex follows the entries in the same allocation. Each of its
+		//	mIndexSize slots is mIndexWidth bytes wide and holds either 0
+		//	(empty) or 1 + the position of an entry. It is at most 2/3 full.
+		//	Slots are not cleared when their entries are erased. Since an
+		//	erased entry's hash is kErased, which no key hashes to, lookups
+		//	simply probe past it.
+		Entry* mEntries = nullptr;
+		unsigned char* mIndex = nullptr;
+		size_type mSize = 0;
+		size_type mUsed = 0;
+		size_type mBegin = 0;
+		size_type mCapacity = 0;
+		size_type mIndexSize = 0;
+		size_type mIndexWidth = 0;
+
+		template<typename Q>
+			static auto HashOf(const Q& key) -> std::uint64_t;
+		static auto CapacityFor(size_type n) noexcept -> size_type;
+		static auto IndexSizeFor(size_type capacity) noexcept -> size_type;
+		static auto IndexWidth(size_type capacity) noexcept -> size_type;
+		static auto MaxLoad(size_type indexSize) noexcept
+			{ return indexSize - indexSize / 3u; }
+		static auto AllocCount(size_type capacity) noexcept -> size_type;
+
+		auto indexAt(size_type slot) const noexcept -> size_type;
+		void setIndex(size_type slot, size_type i) noexcept;
+		template<typename Q>
+			auto findKey(const Q& key) -> iterator;
+		template<typename Q>
+			auto findEntry(const Q& key, std::uint64_t mixed) const
+			-> size_type;
+		void indexEntry(size_type i) noexcept;
+		template<typename... Args>
+			void append(std::uint64_t mixed, Args&&... args);
+		auto iterAt(size_type i) noexcept -> iterator;
+		void eraseAt(size_type i) noexcept;
+		void rebuild(size_type n);
+		void allocate(size_type capacity);
+		void deallocate() noexcept;
+		void destroyAll() noexcept;
+		template<typename KArg, typename... Args>
+			auto tryEmplace(KArg&& key, Args&&... args)
+			-> std::pair<iterator,bool>;
+	};
+
+	//	An Entry's pair only exists while mMixed is something other than
+	//	kErased. (The union keeps it from being constructed or destroyed
+	//	along with the Entry.)
+	template<typename K, typename V, typename H, typename E, typename A>
+		struct OrderedMap<K,V,H,E,A>::Entry {
+			std::uint64_t mMixed;
+			union { value_type mPair; };
+			Entry() noexcept {}
+			~Entry() {}
+		};
+
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<bool Const>
+		class OrderedMap<K,V,H,E,A>::Iter {
+		 public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename OrderedMap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<
+				Const, const value_type*, value_type*
+				>;
+			using reference = std::conditional_t<
+				Const, const value_type&, value_type&
+				>;
+
+			Iter() noexcept = default;
+			template<bool C = Const, typename = std::enable_if_t<C>>
+				Iter(const Iter<false>& it) noexcept:
+					mEntry{it.mEntry}, mEnd{it.mEnd} {}
+			auto operator* () const noexcept -> reference
+				{ return mEntry->mPair; }
+			auto operator-> () const noexcept -> pointer
+				{ return &mEntry->mPair; }
+			auto operator++ () noexcept -> Iter&
+				{ ++mEntry; skipErased(); return *this; }
+			auto operator++ (int) noexcept -> Iter
+				{ auto it = *this; ++*this; return it; }
+			template<bool C> auto operator== (const Iter<C>& rhs)
+				const noexcept { return mEntry == rhs.mEntry; }
+			template<bool C> auto operator!= (const Iter<C>& rhs)
+				const noexcept { return mEntry != rhs.mEntry; }
+
+		 private:
+			friend class OrderedMap;
+			template<bool> friend class Iter;
+			Entry* mEntry = nullptr;
+			Entry* mEnd = nullptr;
+
+			Iter(Entry* pEntry, Entry* pEnd) noexcept:
+				mEntry{pEntry}, mEnd{pEnd} {}
+			void skipErased() noexcept {
+				while(mEntry != mEnd && mEntry->mMixed == kErased) {
+					++mEntry;
+				}
+			}
+		};
+
+	template<typename K, typename V, typename H, typename E, typename A>
+		void swap(
+			OrderedMap<K,V,H,E,A>& a, OrderedMap<K,V,H,E,A>& b) noexcept
+			{ a.swap(b); }
+
+	//==== Template Implementation =============================================
+
+	//---- OrderedMap ----------------------------------------------------------
+
+	template<typename K, typename V, typename H, typename E, typename A>
+		OrderedMap<K,V,H,E,A>::OrderedMap(
+			std::initializer_list<value_type> init)
+	{
+		this->insert(init);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename InputIt>
+		OrderedMap<K,V,H,E,A>::OrderedMap(InputIt first, InputIt last)
+	{
+		this->insert(first, last);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		OrderedMap<K,V,H,E,A>::OrderedMap(const OrderedMap& map)
+	{
+		if(map.mSize == 0u) {
+			return;
+		}
+		allocate(CapacityFor(map.mSize));
+		try {
+			for(auto i = map.mBegin; i < map.mUsed; ++i) {
+				auto& entry = map.mEntries[i];
+				if(entry.mMixed != kErased) {
+					append(entry.mMixed, entry.mPair);
+				}
+			}
+		}
+		catch(...) {
+			destroyAll();
+			deallocate();
+			throw;
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		OrderedMap<K,V,H,E,A>::OrderedMap(OrderedMap&& map) noexcept:
+			mEntries{std::exchange(map.mEntries, nullptr)},
+			mIndex{std::exchange(map.mIndex, nullptr)},
+			mSize{std::exchange(map.mSize, 0u)},
+			mUsed{std::exchange(map.mUsed, 0u)},
+			mBegin{std::exchange(map.mBegin, 0u)},
+			mCapacity{std::exchange(map.mCapacity, 0u)},
+			mIndexSize{std::exchange(map.mIndexSize, 0u)},
+			mIndexWidth{std::exchange(map.mIndexWidth, 0u)}
+	{
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		OrderedMap<K,V,H,E,A>::~OrderedMap()
+	{
+		destroyAll();
+		deallocate();
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::operator= (const OrderedMap& map)
+		-> OrderedMap&
+	{
+		if(this != &map) {
+			OrderedMap copy{map};
+			swap(copy);
+		}
+		return *this;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::operator= (OrderedMap&& map) noexcept
+		-> OrderedMap&
+	{
+		if(this != &map) {
+			OrderedMap tmp{std::move(map)};
+			swap(tmp);
+		}
+		return *this;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::operator= (
+			std::initializer_list<value_type> init) -> OrderedMap&
+	{
+		clear();
+		this->insert(init);
+		return *this;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::begin() noexcept -> iterator
+	{
+		return iterator{mEntries + mBegin, mEntries + mUsed};
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::begin() const noexcept -> const_iterator
+	{
+		return const_cast<OrderedMap*>(this)->begin();
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::end() noexcept -> iterator
+	{
+		return iterator{mEntries + mUsed, mEntries + mUsed};
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::end() const noexcept -> const_iterator
+	{
+		return const_cast<OrderedMap*>(this)->end();
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void OrderedMap<K,V,H,E,A>::reserve(size_type n)
+	{
+		if(n > mSize && n - mSize > mCapacity - mUsed) {
+			rebuild(n);
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void OrderedMap<K,V,H,E,A>::clear() noexcept
+	{
+		destroyAll();
+		if(mIndexSize != 0u) {
+			std::memset(mIndex, 0, mIndexSize * mIndexWidth);
+		}
+		mSize = mUsed = mBegin = 0u;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::erase(const_iterator pos) -> iterator
+	{
+		auto i = static_cast<size_type>(pos.mEntry - mEntries);
+		eraseAt(i);
+		if(mSize == 0u) {
+			return end();
+		}
+		auto it = iterAt(i);
+		it.skipErased();
+		return it;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::erase(iterator pos) -> iterator
+	{
+		return erase(const_iterator{pos});
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::extract(const_iterator pos) -> node_type
+	{
+		auto node = TBase::MakeNode(pos.mEntry->mPair);
+		eraseAt(static_cast<size_type>(pos.mEntry - mEntries));
+		return node;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void OrderedMap<K,V,H,E,A>::swap(OrderedMap& map) noexcept
+	{
+		std::swap(mEntries, map.mEntries);
+		std::swap(mIndex, map.mIndex);
+		std::swap(mSize, map.mSize);
+		std::swap(mUsed, map.mUsed);
+		std::swap(mBegin, map.mBegin);
+		std::swap(mCapacity, map.mCapacity);
+		std::swap(mIndexSize, map.mIndexSize);
+		std::swap(mIndexWidth, map.mIndexWidth);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename Q>
+		auto OrderedMap<K,V,H,E,A>::HashOf(const Q& key) -> std::uint64_t
+	{
+		//	The hash gets mixed as in FlatMap, since the low bits pick the
+		//	first index slot to probe. The rare key that comes out as
+		//	kErased is nudged off it.
+		auto x = TBase::Mix(H{}(key));
+		return x == kErased ? x - 1u : x;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::CapacityFor(size_type n) noexcept
+		-> size_type
+	{
+		return n <= kSmallSize ? n : MaxLoad(IndexSizeFor(n));
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::IndexSizeFor(size_type capacity) noexcept
+		-> size_type
+	{
+		if(capacity <= kSmallSize) {
+			return 0u;
+		}
+		size_type indexSize = 16;
+		while(MaxLoad(indexSize) < capacity) {
+			indexSize <<= 1;
+		}
+		return indexSize;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::IndexWidth(size_type capacity) noexcept
+		-> size_type
+	{
+		if(capacity <= 0xffu) {
+			return 1u;
+		}
+		if(capacity <= 0xffffu) {
+			return 2u;
+		}
+		return capacity <= 0xffffffffu ? 4u : 8u;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::AllocCount(size_type capacity) noexcept
+		-> size_type
+	{
+		//	This is the number of entries needed to cover the entries
+		//	themselves plus the index table that follows them.
+		auto n = IndexSizeFor(capacity) * IndexWidth(capacity)
+			+ sizeof(Entry) - 1u;
+		return capacity + n / sizeof(Entry);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::indexAt(size_type slot) const noexcept
+		-> size_type
+	{
+		auto p = mIndex + slot * mIndexWidth;
+		switch(mIndexWidth) {
+			case 1u:
+				return *p;
+			case 2u: {
+				std::uint16_t i;
+				std::memcpy(&i, p, sizeof i);
+				return i;
+			}
+			case 4u: {
+				std::uint32_t i;
+				std::memcpy(&i, p, sizeof i);
+				return i;
+			}
+			default: {
+				std::uint64_t i;
+				std::memcpy(&i, p, sizeof i);
+				return static_cast<size_type>(i);
+			}
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void OrderedMap<K,V,H,E,A>::setIndex(size_type slot, size_type i)
+			noexcept
+	{
+		auto p = mIndex + slot * mIndexWidth;
+		switch(mIndexWidth) {
+			case 1u:
+				*p = static_cast<unsigned char>(i);
+				break;
+			case 2u: {
+				auto j = static_cast<std::uint16_t>(i);
+				std::memcpy(p, &j, sizeof j);
+				break;
+			}
+			case 4u: {
+				auto j = static_cast<std::uint32_t>(i);
+				std::memcpy(p, &j, sizeof j);
+				break;
+			}
+			default: {
+				auto j = static_cast<std::uint64_t>(i);
+				std::memcpy(p, &j, sizeof j);
+			}
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename Q>
+		auto OrderedMap<K,V,H,E,A>::findKey(const Q& key) -> iterator
+	{
+		if(mSize == 0u) {
+			return end();
+		}
+		return iterAt(findEntry(key, HashOf(key)));
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename Q>
+		auto OrderedMap<K,V,H,E,A>::findEntry(
+			const Q& key, std::uint64_t mixed) const -> size_type
+	{
+		if(mIndexSize == 0u) {
+			for(auto i = mBegin; i < mUsed; ++i) {
+				auto& entry = mEntries[i];
+				if(entry.mMixed == mixed && E{}(entry.mPair.first, key)) {
+					return i;
+				}
+			}
+			return mUsed;
+		}
+
+		//	Slots are probed the way CPython does it: slot * 5 + 1 visits
+		//	every slot of a power-of-2 table, and perturb folds the
+		//	higher bits of the hash in along the way.
+		auto mask = mIndexSize - 1u;
+		auto slot = static_cast<size_type>(mixed) & mask;
+		for(auto perturb = mixed; ; ) {
+			auto j = indexAt(slot);
+			if(j == 0u) {
+				return mUsed;
+			}
+			auto& entry = mEntries[j - 1u];
+			if(entry.mMixed == mixed && E{}(entry.mPair.first, key)) {
+				return j - 1u;
+			}
+			perturb >>= 5;
+			slot = (slot * 5u + 1u + static_cast<size_type>(perturb)) & mask;
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void OrderedMap<K,V,H,E,A>::indexEntry(size_type i) noexcept
+	{
+		auto mixed = mEntries[i].mMixed;
+		auto mask = mIndexSize - 1u;
+		auto slot = static_cast<size_type>(mixed) & mask;
+		for(auto perturb = mixed; indexAt(slot) != 0u; ) {
+			perturb >>= 5;
+			slot = (slot * 5u + 1u + static_cast<size_type>(perturb)) & mask;
+		}
+		setIndex(slot, i + 1u);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename... Args>
+		void OrderedMap<K,V,H,E,A>::append(
+			std::uint64_t mixed, Args&&... args)
+	{
+		auto i = mUsed;
+		auto pEntry = new(mEntries + i) Entry;
+		new(&pEntry->mPair) value_type(std::forward<Args>(args)...);
+		pEntry->mMixed = mixed;
+		if(mIndexSize != 0u) {
+			indexEntry(i);
+		}
+		++mUsed;
+		++mSize;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		auto OrderedMap<K,V,H,E,A>::iterAt(size_type i) noexcept -> iterator
+	{
+		return iterator{mEntries + i, mEntries + mUsed};
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void OrderedMap<K,V,H,E,A>::eraseAt(size_type i) noexcept
+	{
+		mEntries[i].mPair.~value_type();
+		mEntries[i].mMixed = kErased;
+		if(--mSize == 0u) {
+
+			//	With nothing left, the entry array can start over from the
+			//	front.
+			clear();
+		}
+		else if(i == mBegin) {
+			while(mEntries[mBegin].mMixed == kErased) {
+				++mBegin;
+			}
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void OrderedMap<K,V,H,E,A>::rebuild(size_type n)
+	{
+		//	The entries are moved over in order, leaving out the erased
+		//	ones. Their hashes come along with them. The new table is
+		//	allocated first so that a failure leaves the map as it was.
+		OrderedMap table;
+		table.allocate(CapacityFor(n));
+		for(auto i = mBegin; i < mUsed; ++i) {
+			auto& entry = mEntries[i];
+			if(entry.mMixed != kErased) {
+				table.append(
+					entry.mMixed,
+					std::move(const_cast<K&>(entry.mPair.first)),
+					std::move(entry.mPair.second)
+					);
+			}
+		}
+		swap(table);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void OrderedMap<K,V,H,E,A>::allocate(size_type capacity)
+	{
+		TEntryAlloc entryAlloc;
+		mEntries = std::allocator_traits<TEntryAlloc>::allocate(
+			entryAlloc, AllocCount(capacity)
+			);
+		mIndex = reinterpret_cast<unsigned char*>(mEntries + capacity);
+		mCapacity = capacity;
+		mIndexSize = IndexSizeFor(capacity);
+		mIndexWidth = IndexWidth(capacity);
+		std::memset(mIndex, 0, mIndexSize * mIndexWidth);
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void OrderedMap<K,V,H,E,A>::deallocate() noexcept
+	{
+		if(mCapacity == 0u) {
+			return;
+		}
+		TEntryAlloc entryAlloc;
+		std::allocator_traits<TEntryAlloc>::deallocate(
+			entryAlloc, mEntries, AllocCount(mCapacity)
+			);
+		mEntries = nullptr;
+		mIndex = nullptr;
+		mSize = mUsed = mBegin = mCapacity = mIndexSize = mIndexWidth = 0u;
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+		void OrderedMap<K,V,H,E,A>::destroyAll() noexcept
+	{
+		if constexpr(!std::is_trivially_destructible_v<value_type>) {
+			for(auto i = mBegin; i < mUsed; ++i) {
+				if(mEntries[i].mMixed != kErased) {
+					mEntries[i].mPair.~value_type();
+				}
+			}
+		}
+	}
+	template<typename K, typename V, typename H, typename E, typename A>
+	template<typename KArg, typename... Args>
+		auto OrderedMap<K,V,H,E,A>::tryEmplace(KArg&& key, Args&&... args)
+		-> std::pair<iterator,bool>
+	{
+		auto mixed = HashOf(key);
+		if(mSize != 0u) {
+			if(auto i = findEntry(key, mixed); i != mUsed) {
+				return {iterAt(i), false};
+			}
+		}
+		if(mUsed == mCapacity) {
+
+			//	Doubling the live entries (rather than the capacity) means
+			//	that an array full of erased entries may not need to grow.
+			rebuild(std::max(mSize * 2u, size_type{4}));
+		}
+		append(
+			mixed, std::piecewise_construct,
+			std::forward_as_tuple(std::forward<KArg>(key)),
+			std::forward_as_tuple(std::forward<Args>(args)...)
+			);
+		return {iterAt(mUsed - 1u), true};
+	}
+}
+
+#endif
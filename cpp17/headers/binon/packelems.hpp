@@ -2,27 +2,100 @@
 #define BINON_PACKELEMS_HPP
 
 #include "binonobj.hpp"
+#include <memory>
 
 namespace binon {
+
+	//	PackElems encodes the elements of a simple container (SList, SKDict,
+	//	or SDict) one at a time. Since bools get packed 8 to a byte, you must
+	//	call flush() after the last element to write out any partial byte.
+	//
+	//	Given a TOStream rather than a ByteWriter, PackElems writes through a
+	//	StreamWriter of its own, and its destructor calls flush() for you
+	//	before writing the buffered bytes out to the stream. (Any exception
+	//	this throws is swallowed, so call flush() yourself if you want to
+	//	hear about it.)
 	struct PackElems {
-		PackElems(CodeByte elemCode, TOStream& stream);
-		void operator() (const BinONObj& obj, bool requireIO = true);
+		PackElems(CodeByte elemCode, ByteWriter& writer);
+		PackElems(CodeByte elemCode, TOStream& stream, bool requireIO = true);
+		PackElems(PackElems&&) noexcept = default;
 		~PackElems();
+		void operator() (const BinONObj& obj);
+		void flush();
+
+		//	expect() checks the type of an element and counts it without
+		//	writing anything. The encoder in treecodec.cpp calls it for
+		//	container elements, whose data it writes itself.
+		void expect(const BinONObj& obj);
 	 private:
+		std::unique_ptr<StreamWriter> mStreamWriter;
 		CodeByte mElemCode;
-		TOStream& mStream;
+		ByteWriter& mWriter;
 		std::byte mByte;
 		std::size_t mIndex;
+
+		void checkType(const BinONObj& obj) const;
+	};
+	//	PackedSize adds up the number of bytes PackElems would write for the
+	//	same sequence of elements, without checking their types.
+	struct PackedSize {
+		PackedSize(CodeByte elemCode) noexcept;
+		void operator() (const BinONObj& obj);
+		auto size() const noexcept -> std::size_t;
+	 private:
+		CodeByte mElemCode;
+		std::size_t mSize;
+		std::size_t mIndex;
 	};
 	struct UnpackElems {
-		UnpackElems(CodeByte elemCode, TIStream& stream);
-		auto operator() (bool requireIO = true) -> BinONObj;
+		UnpackElems(CodeByte elemCode, ByteReader& reader);
+		auto operator() () -> BinONObj;
+
+		//	unpackBool() is what operator() calls for kBoolObjCode elements.
+		//	You can call it directly to read the next packed bool without
+		//	going through a BinONObj.
+		auto unpackBool() -> bool;
 	 private:
 		CodeByte mElemCode;
-		TIStream& mStream;
+		ByteReader& mReader;
 		std::byte mByte;
 		std::size_t mIndex;
 	};
+
+	//	PackRun() and UnpackRun() encode and decode a whole run of simple
+	//	container elements at once. Rather than work out what to do with each
+	//	element as it comes the way PackElems and UnpackElems do, they pick a
+	//	kernel specialized for the element code up front and make one pass
+	//	over the run with it. Floats get byte-swapped a buffer at a time, for
+	//	example, and bools packed 64 to a word. The encoder and decoder in
+	//	treecodec.cpp use these for SLists, SKDicts, and SDicts whose elements
+	//	are not themselves containers.
+	//
+	//	Like PackElems, PackRun() throws BadElemType if an element's type code
+	//	does not match elemCode. PackKeys() and PackValues() pack the keys or
+	//	values of a dict in iteration order. UnpackRun() appends n elements to
+	//	list.
+	void PackRun(CodeByte elemCode, const TList& list, ByteWriter& writer);
+	void PackKeys(CodeByte keyCode, const TDict& dict, ByteWriter& writer);
+	void PackValues(CodeByte valCode, const TDict& dict, ByteWriter& writer);
+	void UnpackRun(
+		CodeByte elemCode, std::size_t n, TList& list, ByteReader& reader
+		);
+
+	//	Decoders call CheckElemCount() after reading a container's element
+	//	count (and element code, if any) but before allocating anything for
+	//	the elements. It throws LimitErr if the count exceeds the reader's
+	//	CodecContext::maxCount. Then it calls the reader's checkNulls() for
+	//	NullObj elements or else its checkAvail() with the fewest bytes that
+	//	many elements could occupy. Pass kNoObjCode for the elements of a ListObj
+	//	or DictObj, each of which has a code byte.
+	//
+	//	Containers then reserve no more than kMaxReserve elements up front,
+	//	growing the rest of the way as their elements actually arrive.
+	void CheckElemCount(
+		std::size_t count, CodeByte elemCode, ByteReader& reader
+		);
+	inline constexpr std::size_t kMaxReserve = 0x400;
 }
 
 #endif
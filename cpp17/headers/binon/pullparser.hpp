@@ -0,0 +1,190 @@
+#ifndef BINON_PULLPARSER_HPP
+#define BINON_PULLPARSER_HPP
+
+#include "packelems.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace binon {
+
+	/*
+	TokenType enum
+
+	Each token a PullParser returns is one of these types.
+
+	kEnd: the top-level object has been completely parsed
+	kNull: NullObj
+	kBool: BoolObj (value in Token::mBool)
+	kInt: IntObj (value in Token::mInt)
+	kUInt: UIntObj (value in Token::mUInt)
+	kBigInt, kBigUInt: IntObj or UIntObj in variable-length (0xf1) form
+		The big-endian bytes are described by Token::mData and mCount.
+	kFloat, kFloat32: FloatObj or Float32Obj (value in Token::mFloat)
+	kBuffer, kStr: BufferObj or StrObj
+		The data is described by Token::mData and mCount.
+	kListBegin: start of a ListObj or SList
+		Token::mCount is the element count. For an SList, Token::mElemCode is
+		the element type code.
+	kListEnd: end of the most recent list
+	kDictKeysBegin: start of a DictObj, SKDict, or SDict
+		All the keys follow before any of the values. Token::mCount is the
+		number of entries, and Token::mElemCode is the key code for an SKDict
+		or SDict.
+	kDictValuesBegin: the keys are done and the values are coming up
+		Token::mCount is again the number of entries, and Token::mElemCode is
+		the value code for an SDict.
+	kDictEnd: end of the most recent dict
+	*/
+	enum class TokenType: std::uint8_t {
+		kEnd,
+		kNull,
+		kBool,
+		kInt,
+		kUInt,
+		kBigInt,
+		kBigUInt,
+		kFloat,
+		kFloat32,
+		kBuffer,
+		kStr,
+		kListBegin,
+		kListEnd,
+		kDictKeysBegin,
+		kDictValuesBegin,
+		kDictEnd
+	};
+
+	/*
+	Token struct
+
+	Only the data members relevant to a given mType are meaningful.
+
+	mTypeCode is the type code of the object the token belongs to (e.g.
+	kSListCode for the kListBegin of an SList). It is kNoObjCode for kEnd.
+
+	mElemCode is only set by the begin tokens of simple containers. Otherwise,
+	it is kNoObjCode.
+
+	For kBuffer, kStr, kBigInt, and kBigUInt, mData points to the mCount bytes
+	of data in the input if the parser could borrow them from its ByteReader.
+	If it could not (say, because the ByteReader wraps a stream), mData is
+	nullptr and you can call PullParser::read() to fetch the data yourself.
+	Either way, no memory is allocated.
+	*/
+	struct Token {
+		TokenType mType = TokenType::kEnd;
+		CodeByte mTypeCode = kNoObjCode;
+		CodeByte mElemCode = kNoObjCode;
+		std::size_t mCount = 0;
+		const std::byte* mData = nullptr;
+		bool mBool = false;
+		IntVal::TScalar mInt = 0;
+		UIntVal::TScalar mUInt = 0;
+		types::TFloat64 mFloat = 0.0;
+
+		//	These return mData/mCount as a string or buffer view. They
+		//	return an empty view if mData is nullptr.
+		auto str() const noexcept -> HyStr::TView;
+		auto buffer() const noexcept -> BufferVal::TView;
+	};
+
+	/*
+	PullParser class
+
+	Where BinONObj::Decode() builds a whole tree of BinON objects, PullParser
+	lets you walk through the encoding one token at a time. This suits code
+	that only needs a few fields out of a large message. Since containers are
+	reported as begin/end tokens rather than decoded into TList/TDict values,
+	the only heap memory PullParser allocates is its stack of open containers.
+	(The constructor reserves room for up to kDefMaxDepth levels of nesting,
+	so that is a single allocation unless your data nest deeper.)
+
+	Example:
+
+		SpanReader reader{bytes};
+		PullParser parser{reader};
+		while(parser.next().mType != TokenType::kEnd) {
+			auto& tok = parser.token();
+			if(tok.mType == TokenType::kStr) {
+				std::cout << tok.str() << '\n';
+			}
+		}
+
+	next() returns kEnd once a complete top-level object has been parsed. If
+	the input contains several objects back to back, calling next() again
+	starts on the next one.
+
+	A kCopy ByteReader is switched over to BorrowMode::kView for the lifetime
+	of the parser so that string data can be lent out as views (the previous
+	mode gets restored by the destructor). The views in a Token remain valid
+	as long as the input memory does.
+
+	Containers may be nested up to the maxDepth of the reader's CodecContext
+	(see byteio.hpp), beyond which next() throws DepthErr, just as with
+	BinONObj::Decode(). PullParser cannot be copied.
+	*/
+	class PullParser {
+	 public:
+		explicit PullParser(ByteReader& reader);
+		PullParser(const PullParser&) = delete;
+		auto operator= (const PullParser&) -> PullParser& = delete;
+		~PullParser();
+
+		//	next() parses the next token and returns it. The reference
+		//	remains valid until the next call.
+		auto next() -> const Token&;
+
+		//	token() returns the token most recently returned by next().
+		auto token() const noexcept -> const Token&;
+
+		//	depth() returns the number of containers currently open.
+		auto depth() const noexcept -> std::size_t;
+
+		//	If the current token is a kBuffer, kStr, kBigInt, or kBigUInt whose
+		//	data could not be borrowed, read() copies up to n bytes of it to p
+		//	and returns the number of bytes copied. Any data you do not read
+		//	gets skipped by the next call to next().
+		auto read(std::byte* p, std::size_t n) -> std::size_t;
+
+		//	skipCtnr() can be called right after a kListBegin or
+		//	kDictKeysBegin token. It skips past the rest of the container and
+		//	returns its kListEnd or kDictEnd token. Right after a begin token,
+		//	it uses SkipObj() and friends (see skipobj.hpp) rather than
+		//	parsing each element.
+		auto skipCtnr() -> const Token&;
+
+	 private:
+		struct Frame {
+			CodeByte mTypeCode;
+			CodeByte mElemCode;
+			std::size_t mCount;
+			std::size_t mLeft;
+			bool mInKeys;
+			bool mHasData;
+			std::optional<UnpackElems> mUnpack;
+		};
+
+		ByteReader& mReader;
+		BorrowMode mOldMode;
+		Token mToken;
+		std::size_t mPending = 0;
+		std::size_t mDepth = 0;
+		bool mFinished = false;
+		std::vector<Frame> mFrames;
+
+		auto readCount() -> std::size_t;
+		void skipLeft(Frame& frame);
+		void readBytes(TokenType type, std::size_t n);
+		void parseObj(CodeByte cb);
+		void parseData(CodeByte typeCode);
+		void pushFrame(
+			CodeByte typeCode, std::size_t count, CodeByte elemCode,
+			bool hasData
+			);
+		void endFrame();
+	};
+}
+
+#endif
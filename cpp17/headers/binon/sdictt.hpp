@@ -0,0 +1,391 @@
+#ifndef BINON_SDICTT_HPP
+#define BINON_SDICTT_HPP
+
+#include "nativeelem.hpp"
+#include "packelems.hpp"
+
+#include <algorithm>
+#include <initializer_list>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace binon {
+
+	/*
+	SKDictT and SDictT class templates
+
+	These are the dict counterparts to SListT (see slistt.hpp). SKDictT<K>
+	encodes like an SKDict whose key code is NativeElem<K>::kElemCode, and
+	SDictT<K,V> like an SDict with the key and value codes of K and V. But
+	rather than a TDict, they store their entries in a std::unordered_map
+	keyed on the native type. A std::string -> int counter is therefore
+	hashed and compared as plain strings, and its keys (and values, for
+	SDictT) are packed straight from the map when encoding.
+
+	SKDictT values are still full BinONObjs, since an SKDict's values can be
+	of any type.
+
+	Example:
+
+		SDictT<std::string,int> counts;
+		++counts.mValue["foo"];
+		counts.encode(writer);
+
+	As with SListT, decoding throws BadElemType if the key (or value) code in
+	the input does not match the native type. Use toSKDict()/toSDict() and the
+	explicit constructors to convert to and from the BinONVariant types. hash()
+	returns the same value as it would for the converted dict.
+	*/
+	template<typename K>
+		struct SKDictT:
+			StdAcc<SKDictT<K>>,
+			StdEq<SKDictT<K>>,
+			StdCodec<SKDictT<K>>
+		{
+			using TKey = K;
+			using TValue = std::unordered_map<K,BinONObj>;
+			static constexpr auto kTypeCode = kSKDictCode;
+			static constexpr auto kKeyCode = NativeElem<K>::kElemCode;
+			static constexpr auto kClsName = std::string_view{"SKDictT"};
+			TValue mValue;
+			SKDictT(const TValue& v);
+			SKDictT(TValue&& v) noexcept;
+			SKDictT(std::initializer_list<typename TValue::value_type> init);
+			SKDictT() = default;
+			explicit SKDictT(const SKDict& obj);
+			auto operator== (const SKDictT& rhs) const
+				{ return this->equals(rhs); }
+			auto operator!= (const SKDictT& rhs) const
+				{ return !this->equals(rhs); }
+			auto size() const noexcept { return mValue.size(); }
+			auto hasDefVal() const noexcept { return mValue.empty(); }
+			auto toSKDict() const -> SKDict;
+			using StdCodec<SKDictT>::encodeData;
+			using StdCodec<SKDictT>::decodeData;
+			auto encodeData(ByteWriter& writer) const -> const SKDictT&;
+			auto encodedDataSize() const -> std::size_t;
+			auto decodeData(ByteReader& reader) -> SKDictT&;
+			auto hash() const -> std::size_t;
+			void printArgs(std::ostream& stream) const;
+		};
+
+	template<typename K, typename V>
+		struct SDictT:
+			StdAcc<SDictT<K,V>>,
+			StdEq<SDictT<K,V>>,
+			StdCodec<SDictT<K,V>>
+		{
+			using TKey = K;
+			using TMapped = V;
+			using TValue = std::unordered_map<K,V>;
+			static constexpr auto kTypeCode = kSDictCode;
+			static constexpr auto kKeyCode = NativeElem<K>::kElemCode;
+			static constexpr auto kValCode = NativeElem<V>::kElemCode;
+			static constexpr auto kClsName = std::string_view{"SDictT"};
+			TValue mValue;
+			SDictT(const TValue& v);
+			SDictT(TValue&& v) noexcept;
+			SDictT(std::initializer_list<typename TValue::value_type> init);
+			SDictT() = default;
+			explicit SDictT(const SDict& obj);
+			auto operator== (const SDictT& rhs) const
+				{ return this->equals(rhs); }
+			auto operator!= (const SDictT& rhs) const
+				{ return !this->equals(rhs); }
+			auto size() const noexcept { return mValue.size(); }
+			auto hasDefVal() const noexcept { return mValue.empty(); }
+			auto toSDict() const -> SDict;
+			using StdCodec<SDictT>::encodeData;
+			using StdCodec<SDictT>::decodeData;
+			auto encodeData(ByteWriter& writer) const -> const SDictT&;
+			auto encodedDataSize() const -> std::size_t;
+			auto decodeData(ByteReader& reader) -> SDictT&;
+			auto hash() const -> std::size_t;
+			void printArgs(std::ostream& stream) const;
+		};
+
+	//	These print the dicts the way BinONObj::print() would print an object.
+	template<typename K>
+		auto operator<< (std::ostream& stream, const SKDictT<K>& obj)
+			-> std::ostream&;
+	template<typename K, typename V>
+		auto operator<< (std::ostream& stream, const SDictT<K,V>& obj)
+			-> std::ostream&;
+
+	//==== Template Implementation =============================================
+
+	namespace details {
+
+		//	Returns the packed size of the keys (or values) of a map.
+		template<typename T, typename Map, typename Proj>
+			auto NativeMapSize(const Map& map, Proj proj) -> std::size_t
+		{
+			auto n = map.size();
+			if constexpr(std::is_same_v<T,bool>) {
+				return (n + 7u) >> 3;
+			}
+			else if constexpr(std::is_floating_point_v<T>) {
+				return n * sizeof(T);
+			}
+			else {
+				std::size_t size = 0;
+				for(auto& pair: map) {
+					size += NativeElem<T>::EncodedSize(proj(pair));
+				}
+				return size;
+			}
+		}
+
+		//	Reads the count and key code of an SKDict or SDict, followed by
+		//	the keys themselves.
+		template<typename K>
+			auto UnpackNativeKeys(ByteReader& reader) -> std::vector<K>
+		{
+			auto n = UIntObj::DecodeSize(reader);
+			auto keyCode = CodeByte::Read(reader);
+			CheckNativeElemCode(keyCode, NativeElem<K>::kElemCode);
+			CheckElemCount(n, keyCode, reader);
+			std::vector<K> keys;
+			keys.reserve(std::min(n, kMaxReserve));
+			UnpackNativeRun<K>(n, keys, reader);
+			return keys;
+		}
+	}
+
+	//---- SKDictT -------------------------------------------------------------
+
+	template<typename K>
+		SKDictT<K>::SKDictT(const TValue& v):
+			mValue{v}
+		{
+		}
+	template<typename K>
+		SKDictT<K>::SKDictT(TValue&& v) noexcept:
+			mValue{std::move(v)}
+		{
+		}
+	template<typename K>
+		SKDictT<K>::SKDictT(
+			std::initializer_list<typename TValue::value_type> init
+			):
+			mValue{init}
+		{
+		}
+	template<typename K>
+		SKDictT<K>::SKDictT(const SKDict& obj) {
+			auto& dict = obj.value();
+			mValue.reserve(dict.size());
+			for(auto& [k, v]: dict) {
+				mValue.try_emplace(GetObjVal<K>(k), v);
+			}
+		}
+	template<typename K>
+		auto SKDictT<K>::toSKDict() const -> SKDict {
+			TDict dict;
+			dict.reserve(mValue.size());
+			for(auto& [k, v]: mValue) {
+				dict.try_emplace(MakeObj(k), v);
+			}
+			return SKDict{std::move(dict), kKeyCode};
+		}
+	template<typename K>
+		auto SKDictT<K>::encodeData(ByteWriter& writer) const
+			-> const SKDictT&
+		{
+			UIntObj::EncodeScalar(mValue.size(), writer);
+			kKeyCode.write(writer);
+			PackNativeRun<K>(
+				mValue, [](auto& pair) -> auto& { return pair.first; }, writer
+				);
+			for(auto& pair: mValue) {
+				pair.second.encode(writer);
+			}
+			return *this;
+		}
+	template<typename K>
+		auto SKDictT<K>::encodedDataSize() const -> std::size_t {
+			auto size = UIntObj::EncodedDataSize(mValue.size()) + 1u;
+			size += details::NativeMapSize<K>(
+				mValue, [](auto& pair) -> auto& { return pair.first; }
+				);
+			for(auto& pair: mValue) {
+				size += pair.second.encodedSize();
+			}
+			return size;
+		}
+	template<typename K>
+		auto SKDictT<K>::decodeData(ByteReader& reader) -> SKDictT& {
+			auto keys = details::UnpackNativeKeys<K>(reader);
+			CheckElemCount(keys.size(), kNoObjCode, reader);
+			mValue.clear();
+			mValue.reserve(keys.size());
+			for(auto&& k: keys) {
+				mValue.insert_or_assign(std::move(k), BinONObj::Decode(reader));
+			}
+			return *this;
+		}
+	template<typename K>
+		auto SKDictT<K>::hash() const -> std::size_t {
+			CommutativeHash ch;
+			for(auto& [k, v]: mValue) {
+				ch.extend(HashCombineObjs(BinONObj{MakeObj(k)}, v));
+			}
+			return ch;
+		}
+	template<typename K>
+		void SKDictT<K>::printArgs(std::ostream& stream) const {
+			stream << "SKDictT::TValue{";
+			bool first = true;
+			for(auto& [k, v]: mValue) {
+				if(first) {
+					first = false;
+				}
+				else {
+					stream << ", ";
+				}
+				stream << '{';
+				BinONObj{MakeObj(k)}.print(stream);
+				stream << ", ";
+				v.print(stream);
+				stream << '}';
+			}
+			stream << "}, ";
+			kKeyCode.printRepr(stream);
+		}
+
+	//---- SDictT --------------------------------------------------------------
+
+	template<typename K, typename V>
+		SDictT<K,V>::SDictT(const TValue& v):
+			mValue{v}
+		{
+		}
+	template<typename K, typename V>
+		SDictT<K,V>::SDictT(TValue&& v) noexcept:
+			mValue{std::move(v)}
+		{
+		}
+	template<typename K, typename V>
+		SDictT<K,V>::SDictT(
+			std::initializer_list<typename TValue::value_type> init
+			):
+			mValue{init}
+		{
+		}
+	template<typename K, typename V>
+		SDictT<K,V>::SDictT(const SDict& obj) {
+			auto& dict = obj.value();
+			mValue.reserve(dict.size());
+			for(auto& [k, v]: dict) {
+				mValue.try_emplace(GetObjVal<K>(k), GetObjVal<V>(v));
+			}
+		}
+	template<typename K, typename V>
+		auto SDictT<K,V>::toSDict() const -> SDict {
+			TDict dict;
+			dict.reserve(mValue.size());
+			for(auto& [k, v]: mValue) {
+				dict.try_emplace(MakeObj(k), MakeObj(v));
+			}
+			return SDict{std::move(dict), kKeyCode, kValCode};
+		}
+	template<typename K, typename V>
+		auto SDictT<K,V>::encodeData(ByteWriter& writer) const
+			-> const SDictT&
+		{
+			UIntObj::EncodeScalar(mValue.size(), writer);
+			kKeyCode.write(writer);
+			PackNativeRun<K>(
+				mValue, [](auto& pair) -> auto& { return pair.first; }, writer
+				);
+			kValCode.write(writer);
+			PackNativeRun<V>(
+				mValue, [](auto& pair) -> auto& { return pair.second; }, writer
+				);
+			return *this;
+		}
+	template<typename K, typename V>
+		auto SDictT<K,V>::encodedDataSize() const -> std::size_t {
+			auto size = UIntObj::EncodedDataSize(mValue.size()) + 2u;
+			size += details::NativeMapSize<K>(
+				mValue, [](auto& pair) -> auto& { return pair.first; }
+				);
+			size += details::NativeMapSize<V>(
+				mValue, [](auto& pair) -> auto& { return pair.second; }
+				);
+			return size;
+		}
+	template<typename K, typename V>
+		auto SDictT<K,V>::decodeData(ByteReader& reader) -> SDictT& {
+			auto keys = details::UnpackNativeKeys<K>(reader);
+			auto valCode = CodeByte::Read(reader);
+			CheckNativeElemCode(valCode, kValCode);
+			CheckElemCount(keys.size(), valCode, reader);
+			std::vector<V> vals;
+			vals.reserve(std::min(keys.size(), kMaxReserve));
+			UnpackNativeRun<V>(keys.size(), vals, reader);
+
+			//	Packed bools can come up short if the input runs out without
+			//	requireIO (see BitVec::read()).
+			mValue.clear();
+			mValue.reserve(vals.size());
+			for(std::size_t i = 0; i < vals.size(); ++i) {
+				mValue.insert_or_assign(std::move(keys[i]), std::move(vals[i]));
+			}
+			return *this;
+		}
+	template<typename K, typename V>
+		auto SDictT<K,V>::hash() const -> std::size_t {
+			CommutativeHash ch;
+			for(auto& [k, v]: mValue) {
+				ch.extend(
+					HashCombineObjs(BinONObj{MakeObj(k)}, BinONObj{MakeObj(v)})
+					);
+			}
+			return ch;
+		}
+	template<typename K, typename V>
+		void SDictT<K,V>::printArgs(std::ostream& stream) const {
+			stream << "SDictT::TValue{";
+			bool first = true;
+			for(auto& [k, v]: mValue) {
+				if(first) {
+					first = false;
+				}
+				else {
+					stream << ", ";
+				}
+				stream << '{';
+				BinONObj{MakeObj(k)}.print(stream);
+				stream << ", ";
+				BinONObj{MakeObj(v)}.print(stream);
+				stream << '}';
+			}
+			stream << "}, ";
+			kKeyCode.printRepr(stream);
+			stream << ", ";
+			kValCode.printRepr(stream);
+		}
+
+	//---- Helper functions ----------------------------------------------------
+
+	template<typename K>
+		auto operator<< (std::ostream& stream, const SKDictT<K>& obj)
+			-> std::ostream&
+	{
+		stream << obj.kClsName << '(';
+		obj.printArgs(stream);
+		return stream << ')';
+	}
+	template<typename K, typename V>
+		auto operator<< (std::ostream& stream, const SDictT<K,V>& obj)
+			-> std::ostream&
+	{
+		stream << obj.kClsName << '(';
+		obj.printArgs(stream);
+		return stream << ')';
+	}
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef BINON_SKIPOBJ_HPP
+#define BINON_SKIPOBJ_HPP
+
+#include "intobj.hpp"
+
+namespace binon {
+
+	//	These functions step over encoded BinON data without decoding it. They
+	//	read just enough to work out where each object ends (code bytes, sizes,
+	//	and the first byte of each integer) and skip the rest, so they never
+	//	allocate memory. Packed bools and fixed-size elements of simple
+	//	containers are skipped in one go.
+	//
+	//	Skipping is the basis for random access into large encodings. For
+	//	example, you might record the offset of each element in a huge list by
+	//	calling SkipObj() repeatedly on a SpanReader and checking count().
+	//
+	//	Containers may be nested up to the maxDepth of the reader's
+	//	CodecContext (see byteio.hpp), beyond which DepthErr is thrown, just
+	//	as with decoding. (Skipping recurses once per level of nesting, so
+	//	the call stack grows with the depth of the data up to that limit.) As
+	//	with decoding, a SpanReader will throw BufOverrun if the data are
+	//	truncated.
+
+	//	SkipObj() reads past the next complete object (code byte and data) and
+	//	returns the number of bytes it occupied.
+	auto SkipObj(ByteReader& reader) -> std::size_t;
+
+	//	SkipData() reads past the data of an object whose type code you already
+	//	know (e.g. an element of an SList) and returns its byte length.
+	auto SkipData(CodeByte typeCode, ByteReader& reader) -> std::size_t;
+
+	//	SkipElems() reads past n elements of a simple container sharing the
+	//	element code elemCode. (These are data only, with bools packed 8 to a
+	//	byte.) It returns the total byte length.
+	auto SkipElems(CodeByte elemCode, std::size_t n, ByteReader& reader)
+		-> std::size_t;
+
+	//	EncodedExtent() returns the byte length of the object encoded at the
+	//	start of a memory buffer (or at a given offset into a TBytes buffer).
+	//	It skips the object with a SpanReader using the context you supply.
+	auto EncodedExtent(
+		const std::byte* data, std::size_t size,
+		const CodecContext& context = {}
+		) -> std::size_t;
+	auto EncodedExtent(
+		const TBytes& bytes, std::size_t offset = 0,
+		const CodecContext& context = {}
+		) -> std::size_t;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef BINON_SLISTBITS_HPP
+#define BINON_SLISTBITS_HPP
+
+#include "bitvec.hpp"
+#include "nativeelem.hpp"
+#include "packelems.hpp"
+
+#include <initializer_list>
+#include <ostream>
+
+namespace binon {
+
+	/*
+	SListBits class
+
+	SListBits is SListT<bool> (see slistt.hpp) done the way BinON packs bools
+	on the wire: it stores its elements in a BitVec, 1 bit apiece. Encoding
+	and decoding copy the packed bytes in one go rather than handling a bit
+	at a time, and a list of a million flags takes up 125 KB in memory.
+
+	Example:
+
+		SListBits flags;
+		flags.decode(CodeByte::Read(reader), reader);
+		SListBits other = ...;
+		auto both = (flags.value() & other.value()).count();
+
+	Decoding throws BadElemType if the elements are not BoolObjs. As with
+	SListT, use toSList() and the explicit SList constructor to convert to and
+	from the BinONVariant type. hash() returns the same value as it would for
+	the SList.
+	*/
+	struct SListBits:
+		StdAcc<SListBits>,
+		StdEq<SListBits>,
+		StdCodec<SListBits>
+	{
+		using TValue = BitVec;
+		static constexpr auto kTypeCode = kSListCode;
+		static constexpr auto kElemCode = kBoolObjCode;
+		static constexpr auto kClsName = std::string_view{"SListBits"};
+		TValue mValue;
+		SListBits(const TValue& v);
+		SListBits(TValue&& v) noexcept;
+		SListBits(std::initializer_list<bool> init);
+		SListBits() = default;
+		explicit SListBits(const SList& obj);
+		auto operator== (const SListBits& rhs) const
+			{ return this->equals(rhs); }
+		auto operator!= (const SListBits& rhs) const
+			{ return !this->equals(rhs); }
+		auto size() const noexcept { return mValue.size(); }
+		auto hasDefVal() const noexcept { return mValue.empty(); }
+		auto toSList() const -> SList;
+		using StdCodec<SListBits>::encodeData;
+		using StdCodec<SListBits>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const SListBits&;
+		auto encodedDataSize() const -> std::size_t;
+		auto decodeData(ByteReader& reader) -> SListBits&;
+		auto hash() const -> std::size_t;
+		void printArgs(std::ostream& stream) const;
+	};
+
+	//	Prints an SListBits the way BinONObj::print() would print an object.
+	auto operator<< (std::ostream& stream, const SListBits& obj)
+		-> std::ostream&;
+}
+
+#endif
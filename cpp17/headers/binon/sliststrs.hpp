@@ -0,0 +1,177 @@
+#ifndef BINON_SLISTSTRS_HPP
+#define BINON_SLISTSTRS_HPP
+
+#include "nativeelem.hpp"
+#include "packelems.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace binon {
+
+	/*
+	StrColumn class
+
+	StrColumn is a sequence of strings stored in columnar form (as in Apache
+	Arrow): all the characters go into one contiguous arena, and a second
+	array records where each string ends. So however many strings there are,
+	they take up 2 memory allocations rather than 1 apiece, and you access
+	them as std::string_views into the arena.
+
+	Strings can be appended but not modified in place. Iterating gives you
+	std::string_views too.
+
+	SListStrs wraps a StrColumn to encode and decode SLists of StrObjs.
+	*/
+	class StrColumn {
+	 public:
+		class const_iterator;
+		using iterator = const_iterator;
+		using value_type = std::string_view;
+
+		StrColumn() noexcept = default;
+		StrColumn(std::initializer_list<std::string_view> init);
+
+		auto size() const noexcept { return mEnds.size(); }
+		auto empty() const noexcept { return mEnds.empty(); }
+		auto operator[] (std::size_t i) const noexcept -> std::string_view;
+		auto begin() const noexcept -> const_iterator;
+		auto end() const noexcept -> const_iterator;
+
+		//	reserve() makes room for n strings adding up to nChars characters.
+		void push_back(std::string_view sv);
+		void reserve(std::size_t n, std::size_t nChars);
+		void clear() noexcept;
+
+		//	chars() and charCount() describe the arena, while ends() gives the
+		//	offset into it just past the end of each string.
+		auto chars() const noexcept -> const char* { return mChars.data(); }
+		auto charCount() const noexcept { return mChars.size(); }
+		auto ends() const noexcept -> const std::vector<std::size_t>&
+			{ return mEnds; }
+
+		auto operator== (const StrColumn& rhs) const noexcept -> bool;
+		auto operator!= (const StrColumn& rhs) const noexcept -> bool
+			{ return !(*this == rhs); }
+
+		//	read() replaces the contents with n strings read from reader, each
+		//	encoded as StrObj data (a UIntObj length followed by the
+		//	characters). write() writes them out the same way, and
+		//	encodedSize() returns how many bytes that takes.
+		//
+		//	When the reader has all n strings in its memory window, read()
+		//	measures them first so that the arena and offsets are allocated
+		//	exactly once. Otherwise, they grow as the strings arrive.
+		void read(ByteReader& reader, std::size_t n);
+		void write(ByteWriter& writer) const;
+		auto encodedSize() const noexcept -> std::size_t;
+
+	 private:
+		std::string mChars;
+		std::vector<std::size_t> mEnds;
+	};
+
+	class StrColumn::const_iterator {
+	 public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = std::string_view;
+
+		const_iterator() noexcept = default;
+		const_iterator(const StrColumn* pCol, std::size_t i) noexcept:
+			mPCol{pCol}, mI{i} {}
+		auto operator* () const noexcept { return (*mPCol)[mI]; }
+		auto operator++ () noexcept -> const_iterator&
+			{ ++mI; return *this; }
+		auto operator++ (int) noexcept -> const_iterator
+			{ auto it = *this; ++mI; return it; }
+		auto operator== (const const_iterator& rhs) const noexcept
+			{ return mI == rhs.mI; }
+		auto operator!= (const const_iterator& rhs) const noexcept
+			{ return mI != rhs.mI; }
+	 private:
+		const StrColumn* mPCol = nullptr;
+		std::size_t mI = 0;
+	};
+
+	/*
+	SListStrs class
+
+	SListStrs is the string counterpart to SListBits (see slistbits.hpp). It
+	encodes like an SList of StrObjs but stores the strings in a StrColumn,
+	so decoding a list of N labels costs 2 allocations rather than N + 1
+	(not counting the BinONObj variants an SList would need on top of that).
+
+	Example:
+
+		SListStrs tags{"red", "green", "blue"};
+		tags.value().push_back("cyan");
+		tags.encode(writer);
+		...
+		SListStrs decoded;
+		decoded.decode(CodeByte::Read(reader), reader);
+		for(std::string_view tag: decoded.value()) {...}
+
+	Decoding throws BadElemType if the elements are not StrObjs. Use toSList()
+	and the explicit SList constructor to convert to and from the BinONVariant
+	type. hash() returns the same value as it would for the SList.
+	*/
+	struct SListStrs:
+		StdAcc<SListStrs>,
+		StdEq<SListStrs>,
+		StdCodec<SListStrs>
+	{
+		using TValue = StrColumn;
+		static constexpr auto kTypeCode = kSListCode;
+		static constexpr auto kElemCode = kStrObjCode;
+		static constexpr auto kClsName = std::string_view{"SListStrs"};
+		TValue mValue;
+		SListStrs(const TValue& v);
+		SListStrs(TValue&& v) noexcept;
+		SListStrs(std::initializer_list<std::string_view> init);
+		SListStrs() = default;
+		explicit SListStrs(const SList& obj);
+		auto operator== (const SListStrs& rhs) const
+			{ return this->equals(rhs); }
+		auto operator!= (const SListStrs& rhs) const
+			{ return !this->equals(rhs); }
+		auto size() const noexcept { return mValue.size(); }
+		auto hasDefVal() const noexcept { return mValue.empty(); }
+		auto toSList() const -> SList;
+		using StdCodec<SListStrs>::encodeData;
+		using StdCodec<SListStrs>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const SListStrs&;
+		auto encodedDataSize() const -> std::size_t;
+		auto decodeData(ByteReader& reader) -> SListStrs&;
+		auto hash() const -> std::size_t;
+		void printArgs(std::ostream& stream) const;
+	};
+
+	//	Prints an SListStrs the way BinONObj::print() would print an object.
+	auto operator<< (std::ostream& stream, const SListStrs& obj)
+		-> std::ostream&;
+
+	//==== Inline Implementation ===============================================
+
+	inline auto StrColumn::operator[] (std::size_t i) const noexcept
+		-> std::string_view
+	{
+		auto beg = i == 0u ? std::size_t{0} : mEnds[i - 1u];
+		return std::string_view{mChars.data() + beg, mEnds[i] - beg};
+	}
+	inline auto StrColumn::begin() const noexcept -> const_iterator {
+		return const_iterator{this, 0u};
+	}
+	inline auto StrColumn::end() const noexcept -> const_iterator {
+		return const_iterator{this, mEnds.size()};
+	}
+}
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef BINON_SLISTT_HPP
+#define BINON_SLISTT_HPP
+
+#include "nativeelem.hpp"
+#include "packelems.hpp"
+
+#include <algorithm>
+#include <initializer_list>
+#include <ostream>
+#include <vector>
+
+namespace binon {
+
+	/*
+	SListT class template
+
+	SListT<T> encodes exactly like an SList whose element code is
+	NativeElem<T>::kElemCode, but it stores its elements in a std::vector<T>
+	rather than a TList of BinONObj variants. A million doubles therefore take
+	up 8 MB rather than a million variants' worth, and encoding or decoding
+	them is a straight loop over native values with no per-element type checks
+	or dispatch.
+
+	Example:
+
+		SListT<double> scores{1.5, 2.25, 3.0};
+		scores.value().push_back(4.0);
+		scores.encode(writer);
+		...
+		SListT<double> decoded;
+		decoded.decode(CodeByte::Read(reader), reader);
+
+	T can be any type NativeElem supports (see nativeelem.hpp). Decoding throws
+	BadElemType if the element code in the input does not match T's, so an
+	SListT<std::int64_t> will not accept a list of UIntObj elements, say. (You
+	can always decode an SList and convert it instead.) For bools, consider
+	SListBits (see slistbits.hpp), which keeps them packed 1 bit apiece.
+	Likewise, SListStrs (see sliststrs.hpp) keeps strings in a single arena.
+
+	SListT is not itself one of the BinONVariant alternatives. To put one in a
+	BinONObj, call toSList(). To get one back out, construct the SListT from
+	the SList (with the usual GetObjVal() conversions applied to each
+	element). hash() returns the same value as it would for the SList.
+	*/
+	template<typename T>
+		struct SListT:
+			StdAcc<SListT<T>>,
+			StdEq<SListT<T>>,
+			StdCodec<SListT<T>>
+		{
+			using TElem = T;
+			using TValue = std::vector<T>;
+			static constexpr auto kTypeCode = kSListCode;
+			static constexpr auto kElemCode = NativeElem<T>::kElemCode;
+			static constexpr auto kClsName = std::string_view{"SListT"};
+			TValue mValue;
+			SListT(const TValue& v);
+			SListT(TValue&& v) noexcept;
+			SListT(std::initializer_list<T> init);
+			SListT() = default;
+			explicit SListT(const SList& obj);
+			auto operator== (const SListT& rhs) const
+				{ return this->equals(rhs); }
+			auto operator!= (const SListT& rhs) const
+				{ return !this->equals(rhs); }
+			auto size() const noexcept { return mValue.size(); }
+			auto hasDefVal() const noexcept { return mValue.empty(); }
+			auto toSList() const -> SList;
+			using StdCodec<SListT>::encodeData;
+			using StdCodec<SListT>::decodeData;
+			auto encodeData(ByteWriter& writer) const -> const SListT&;
+			auto encodedDataSize() const -> std::size_t;
+			auto decodeData(ByteReader& reader) -> SListT&;
+			auto hash() const -> std::size_t;
+			void printArgs(std::ostream& stream) const;
+		};
+
+	//	Prints an SListT the way BinONObj::print() would print an object.
+	template<typename T>
+		auto operator<< (std::ostream& stream, const SListT<T>& obj)
+			-> std::ostream&;
+
+	//==== Template Implementation =============================================
+
+	//---- SListT --------------------------------------------------------------
+
+	template<typename T>
+		SListT<T>::SListT(const TValue& v):
+			mValue{v}
+		{
+		}
+	template<typename T>
+		SListT<T>::SListT(TValue&& v) noexcept:
+			mValue{std::move(v)}
+		{
+		}
+	template<typename T>
+		SListT<T>::SListT(std::initializer_list<T> init):
+			mValue{init}
+		{
+		}
+	template<typename T>
+		SListT<T>::SListT(const SList& obj) {
+			auto& list = obj.value();
+			mValue.reserve(list.size());
+			for(auto& elem: list) {
+				mValue.push_back(GetObjVal<T>(elem));
+			}
+		}
+	template<typename T>
+		auto SListT<T>::toSList() const -> SList {
+			TList list;
+			list.reserve(mValue.size());
+			for(auto&& v: mValue) {
+				list.push_back(MakeObj(static_cast<const T&>(v)));
+			}
+			return SList{std::move(list), kElemCode};
+		}
+	template<typename T>
+		auto SListT<T>::encodeData(ByteWriter& writer) const -> const SListT&
+		{
+			UIntObj::EncodeScalar(mValue.size(), writer);
+			kElemCode.write(writer);
+			PackNativeRun<T>(
+				mValue, [](auto&& v) -> const T& { return v; }, writer
+				);
+			return *this;
+		}
+	template<typename T>
+		auto SListT<T>::encodedDataSize() const -> std::size_t {
+			auto n = mValue.size();
+			auto size = UIntObj::EncodedDataSize(n) + 1u;
+			if constexpr(std::is_same_v<T,bool>) {
+				size += (n + 7u) >> 3;
+			}
+			else if constexpr(std::is_floating_point_v<T>) {
+				size += n * sizeof(T);
+			}
+			else {
+				for(auto& v: mValue) {
+					size += NativeElem<T>::EncodedSize(v);
+				}
+			}
+			return size;
+		}
+	template<typename T>
+		auto SListT<T>::decodeData(ByteReader& reader) -> SListT& {
+			auto n = UIntObj::DecodeSize(reader);
+			auto elemCode = CodeByte::Read(reader);
+			CheckNativeElemCode(elemCode, kElemCode);
+			CheckElemCount(n, elemCode, reader);
+			mValue.clear();
+			mValue.reserve(std::min(n, kMaxReserve));
+			UnpackNativeRun<T>(n, mValue, reader);
+			return *this;
+		}
+	template<typename T>
+		auto SListT<T>::hash() const -> std::size_t {
+			auto seed = std::hash<CodeByte>{}(kTypeCode);
+			for(auto&& v: mValue) {
+				seed = HashCombine(
+					seed,
+					std::hash<BinONObj>{}(MakeObj(static_cast<const T&>(v)))
+					);
+			}
+			return seed;
+		}
+	template<typename T>
+		void SListT<T>::printArgs(std::ostream& stream) const {
+			stream << "SListT::TValue{";
+			bool first = true;
+			for(auto&& v: mValue) {
+				if(first) {
+					first = false;
+				}
+				else {
+					stream << ", ";
+				}
+				BinONObj{MakeObj(static_cast<const T&>(v))}.print(stream);
+			}
+			stream << "}, ";
+			kElemCode.printRepr(stream);
+		}
+
+	//---- Helper functions ----------------------------------------------------
+
+	template<typename T>
+		auto operator<< (std::ostream& stream, const SListT<T>& obj)
+			-> std::ostream&
+	{
+		stream << obj.kClsName << '(';
+		obj.printArgs(stream);
+		return stream << ')';
+	}
+}
+
+#endif
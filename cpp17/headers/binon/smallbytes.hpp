@@ -0,0 +1,220 @@
+#ifndef BINON_SMALLBYTES_HPP
+#define BINON_SMALLBYTES_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace binon {
+
+	/*
+	SmallBytes class template
+
+	SmallBytes is a byte string that keeps up to N bytes inside the object
+	itself and only goes to the heap once it grows past that. IntVal and
+	UIntVal use it for their vector form when BINON_INLINE_BIGINT is defined
+	true (see intobj.hpp), so that 128- or 256-bit integers never allocate.
+
+	It implements the subset of the std::basic_string<std::byte> interface
+	that BinON itself needs (size(), data(), insert(), erase(), etc.), so that
+	code written against the vector form works either way. Unlike a string's,
+	resize() leaves the new bytes unspecified if you omit the fill byte, which
+	saves zeroing a buffer you are about to read into.
+	*/
+	template<std::size_t N>
+		class SmallBytes {
+		 public:
+			using value_type = std::byte;
+			using size_type = std::size_t;
+			using iterator = std::byte*;
+			using const_iterator = const std::byte*;
+			static constexpr size_type kInlineSize = N;
+
+			SmallBytes() noexcept = default;
+			SmallBytes(size_type n, std::byte b);
+			SmallBytes(const std::byte* p, size_type n);
+			SmallBytes(const SmallBytes& other);
+			SmallBytes(SmallBytes&& other) noexcept;
+			auto operator= (const SmallBytes& other) -> SmallBytes&;
+			auto operator= (SmallBytes&& other) noexcept -> SmallBytes&;
+
+			auto data() noexcept -> std::byte*;
+			auto data() const noexcept -> const std::byte*;
+			auto size() const noexcept { return mSize; }
+			auto length() const noexcept { return mSize; }
+			auto capacity() const noexcept { return mCap; }
+			auto empty() const noexcept { return mSize == 0u; }
+			auto begin() noexcept { return data(); }
+			auto begin() const noexcept { return data(); }
+			auto end() noexcept { return data() + mSize; }
+			auto end() const noexcept { return data() + mSize; }
+			auto operator[] (size_type i) noexcept -> std::byte&
+				{ return data()[i]; }
+			auto operator[] (size_type i) const noexcept -> std::byte
+				{ return data()[i]; }
+
+			void reserve(size_type n);
+			void resize(size_type n);
+			void resize(size_type n, std::byte b);
+			void clear() noexcept { mSize = 0u; }
+			void push_back(std::byte b);
+			auto insert(size_type pos, size_type n, std::byte b)
+				-> SmallBytes&;
+			auto erase(size_type pos = 0, size_type n = kNPos)
+				-> SmallBytes&;
+			void shrink_to_fit();
+
+			auto operator== (const SmallBytes& rhs) const noexcept -> bool;
+			auto operator!= (const SmallBytes& rhs) const noexcept -> bool
+				{ return !(*this == rhs); }
+
+		 private:
+			static constexpr size_type kNPos = ~size_type{0};
+			size_type mSize = 0u, mCap = N;
+			std::unique_ptr<std::byte[]> mHeap;
+			std::array<std::byte,N> mInline;
+
+			void grow(size_type n);
+		};
+
+	//==== Template Implementation =============================================
+
+	template<std::size_t N>
+		SmallBytes<N>::SmallBytes(size_type n, std::byte b) {
+			resize(n, b);
+		}
+	template<std::size_t N>
+		SmallBytes<N>::SmallBytes(const std::byte* p, size_type n) {
+			resize(n);
+			std::memcpy(data(), p, n);
+		}
+	template<std::size_t N>
+		SmallBytes<N>::SmallBytes(const SmallBytes& other):
+			SmallBytes(other.data(), other.size())
+		{
+		}
+	template<std::size_t N>
+		SmallBytes<N>::SmallBytes(SmallBytes&& other) noexcept {
+			*this = std::move(other);
+		}
+	template<std::size_t N>
+		auto SmallBytes<N>::operator= (const SmallBytes& other)
+			-> SmallBytes&
+		{
+			if(this != &other) {
+				resize(other.size());
+				std::memcpy(data(), other.data(), mSize);
+			}
+			return *this;
+		}
+	template<std::size_t N>
+		auto SmallBytes<N>::operator= (SmallBytes&& other) noexcept
+			-> SmallBytes&
+		{
+			if(this != &other) {
+				if(other.mHeap) {
+					mHeap = std::move(other.mHeap);
+					mCap = other.mCap;
+				}
+				else {
+					mHeap.reset();
+					mCap = N;
+					std::memcpy(
+						mInline.data(), other.mInline.data(), other.mSize
+						);
+				}
+				mSize = other.mSize;
+				other.mSize = 0u;
+				other.mCap = N;
+			}
+			return *this;
+		}
+	template<std::size_t N>
+		auto SmallBytes<N>::data() noexcept -> std::byte* {
+			return mHeap ? mHeap.get() : mInline.data();
+		}
+	template<std::size_t N>
+		auto SmallBytes<N>::data() const noexcept -> const std::byte* {
+			return mHeap ? mHeap.get() : mInline.data();
+		}
+	template<std::size_t N>
+		void SmallBytes<N>::reserve(size_type n) {
+			if(n > mCap) {
+				grow(n);
+			}
+		}
+	template<std::size_t N>
+		void SmallBytes<N>::resize(size_type n) {
+			reserve(n);
+			mSize = n;
+		}
+	template<std::size_t N>
+		void SmallBytes<N>::resize(size_type n, std::byte b) {
+			auto n0 = mSize;
+			resize(n);
+			if(n > n0) {
+				std::fill(data() + n0, data() + n, b);
+			}
+		}
+	template<std::size_t N>
+		void SmallBytes<N>::push_back(std::byte b) {
+			if(mSize == mCap) {
+				grow(mCap * 2u);
+			}
+			data()[mSize++] = b;
+		}
+	template<std::size_t N>
+		auto SmallBytes<N>::insert(size_type pos, size_type n, std::byte b)
+			-> SmallBytes&
+		{
+			if(pos > mSize) {
+				throw std::out_of_range{"SmallBytes::insert position"};
+			}
+			auto n0 = mSize;
+			resize(n0 + n);
+			auto p = data();
+			std::memmove(p + pos + n, p + pos, n0 - pos);
+			std::fill(p + pos, p + pos + n, b);
+			return *this;
+		}
+	template<std::size_t N>
+		auto SmallBytes<N>::erase(size_type pos, size_type n) -> SmallBytes& {
+			if(pos > mSize) {
+				throw std::out_of_range{"SmallBytes::erase position"};
+			}
+			n = std::min(n, mSize - pos);
+			auto p = data();
+			std::memmove(p + pos, p + pos + n, mSize - pos - n);
+			mSize -= n;
+			return *this;
+		}
+	template<std::size_t N>
+		void SmallBytes<N>::shrink_to_fit() {
+			if(mHeap && mSize <= N) {
+				std::memcpy(mInline.data(), mHeap.get(), mSize);
+				mHeap.reset();
+				mCap = N;
+			}
+		}
+	template<std::size_t N>
+		auto SmallBytes<N>::operator== (const SmallBytes& rhs) const noexcept
+			-> bool
+		{
+			return mSize == rhs.mSize
+				&& std::memcmp(data(), rhs.data(), mSize) == 0;
+		}
+	template<std::size_t N>
+		void SmallBytes<N>::grow(size_type n) {
+			n = std::max(n, mCap * 2u);
+			auto heap = std::make_unique<std::byte[]>(n);
+			std::memcpy(heap.get(), data(), mSize);
+			mHeap = std::move(heap);
+			mCap = n;
+		}
+}
+
+#endif
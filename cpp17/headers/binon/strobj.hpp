@@ -6,16 +6,27 @@
 
 namespace binon {
 
+	//	When decoding from a ByteReader with borrowing enabled (see BorrowMode
+	//	in byteio.hpp), decodeData() leaves mValue as a view into the input
+	//	rather than copying it into a string.
+	//
+	//	StrObj is a HashCache (see hashutil.hpp), so it can remember its
+	//	hash() if BINON_HASH_CACHE is defined true. In that case, mValue is
+	//	private so that the cache cannot be bypassed. Use value() or
+	//	updateValue() instead (see StdAcc in mixins.hpp).
+	//
+	//	Note: The common interface to all BinONObj types is described in
+	//	mixins.hpp.
 	struct StrObj:
 		StdAcc<StrObj>,
 		StdEq<StrObj>,
 		StdHash<StrObj>,
-		StdCodec<StrObj>
+		StdCodec<StrObj>,
+		HashCache
 	{
 		using TValue = HyStr;
 		static constexpr auto kTypeCode = kStrObjCode;
 		static constexpr auto kClsName = std::string_view{"StrObj"};
-		TValue mValue;
 		StrObj(TValue v);
 		StrObj() = default;
 		auto operator== (const StrObj& rhs) const noexcept
@@ -23,11 +34,19 @@ namespace binon {
 		auto operator!= (const StrObj& rhs) const noexcept
 			{ return !equals(rhs); }
 		auto hasDefVal() const noexcept -> bool;
-		auto encodeData(TOStream& stream, bool requireIO = true) const
-			-> const StrObj&;
-		auto decodeData(TIStream& stream, bool requireIO = true)
-			-> StrObj&;
+		using StdCodec<StrObj>::encodeData;
+		using StdCodec<StrObj>::decodeData;
+		auto encodeData(ByteWriter& writer) const -> const StrObj&;
+		auto encodedDataSize() const noexcept -> std::size_t;
+		auto decodeData(ByteReader& reader) -> StrObj&;
 		void printArgs(std::ostream& stream) const;
+
+	 #if BINON_HASH_CACHE
+	 private:
+		friend struct StdAcc<StrObj>;
+		friend struct StdHash<StrObj>;
+	 #endif
+		TValue mValue;
 	};
 }
 
@@ -0,0 +1,52 @@
+#ifndef BINON_TREECODEC_HPP
+#define BINON_TREECODEC_HPP
+
+#include "binonobj.hpp"
+
+namespace binon {
+
+	//	These functions are the engine behind BinONObj::Decode() and encode(),
+	//	as well as the decodeData() and encodeData() methods of the container
+	//	classes. You would not normally call them yourself.
+	//
+	//	Rather than have each container recurse into its elements through
+	//	std::visit, the engine walks the whole object tree in a single loop,
+	//	keeping a stack of open containers in heap memory. Each object is
+	//	dispatched through a table of functions: indexed by code byte when
+	//	decoding or by variant index when encoding.
+	//
+	//	The stack may grow as deep as the maxDepth of the reader or writer's
+	//	CodecContext (see byteio.hpp). Beyond that, DepthErr is thrown. So a
+	//	hostile input nested a million levels deep fails quickly rather than
+	//	overflowing the call stack. (Writers are not depth-limited unless you
+	//	set their maxDepth.)
+
+	//	DecodeTree() reads a code byte and then the object data that follows.
+	auto DecodeTree(ByteReader& reader) -> BinONObj;
+
+	//	EncodeTree() writes an object's code byte and data, while
+	//	EncodeTreeData() writes the data only.
+	void EncodeTree(const BinONObj& obj, ByteWriter& writer);
+	void EncodeTreeData(const BinONObj& obj, ByteWriter& writer);
+
+	//	These overloads decode or encode the data of a specific container.
+	//	DecodeTreeData() replaces any existing contents.
+	void DecodeTreeData(ListObj& obj, ByteReader& reader);
+	void DecodeTreeData(SList& obj, ByteReader& reader);
+	void DecodeTreeData(DictObj& obj, ByteReader& reader);
+	void DecodeTreeData(SKDict& obj, ByteReader& reader);
+	void DecodeTreeData(SDict& obj, ByteReader& reader);
+	void EncodeTreeData(const ListObj& obj, ByteWriter& writer);
+	void EncodeTreeData(const SList& obj, ByteWriter& writer);
+	void EncodeTreeData(const DictObj& obj, ByteWriter& writer);
+	void EncodeTreeData(const SKDict& obj, ByteWriter& writer);
+	void EncodeTreeData(const SDict& obj, ByteWriter& writer);
+
+	//	CheckEncodeDepth() throws DepthErr if opening a container at the given
+	//	depth (0 being the top level) would exceed the writer's maxDepth.
+	//	Encoders that walk the tree themselves (e.g. EncodePlanCache) call
+	//	it too.
+	void CheckEncodeDepth(std::size_t depth, const ByteWriter& writer);
+}
+
+#endif
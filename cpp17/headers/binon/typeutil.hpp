@@ -55,6 +55,16 @@ namespace binon {
 		concept VariantMember = kIsVariantMember<T,Variant>;
  #endif
 
+	//	kIsTransparent<T> is true if T has an is_transparent member type, the
+	//	way std::less<> does. Hash tables look for it in both their hasher and
+	//	key-equality types before allowing lookups by other types of key.
+	template<typename T, typename = void>
+		constexpr bool kIsTransparent = false;
+	template<typename T>
+		constexpr bool kIsTransparent<
+			T, std::void_t<typename T::is_transparent>
+			> = true;
+
 	//---- CustomFold class ---------------------------------------------------
 	//
 	//	This class template allows you to customize the behaviour of fold
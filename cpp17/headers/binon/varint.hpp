@@ -0,0 +1,241 @@
+#ifndef BINON_VARINT_HPP
+#define BINON_VARINT_HPP
+
+#include "byteio.hpp"
+#include "byteutil.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace binon {
+
+	/*
+	Varint encoding and decoding
+
+	IntObj and UIntObj data use a variable-length encoding in which the
+	leading 1 bits of the first byte give the length: 0 for 1 byte, 10 for 2
+	bytes, 110 for 4, and 1110 for 8. A first byte of 0xf0 is followed by the
+	raw 64-bit value, while 0xf1 introduces the arbitrary-length vector form.
+
+	UIntVarintSize() and IntVarintSize() return the encoded length of a
+	scalar. Rather than comparing the value against each range in turn, they
+	count its significant bits with CountLZero() (see byteutil.hpp) and look
+	the length up in a table.
+
+	StoreUIntVarint() and StoreIntVarint() encode a scalar at p and return
+	its length. The length prefix and value bits are combined into a single
+	64-bit word and stored with one unaligned write (plus the 0xf0 byte in the
+	9-byte case), so there must be kMaxVarintSize bytes of room at p whatever
+	the length turns out to be.
+
+	WriteUIntVarint() and WriteIntVarint() do the same through a ByteWriter,
+	going through a scratch buffer when the writer's window is shorter than
+	kMaxVarintSize. WriteUIntVarints() and WriteIntVarints() write n integers
+	at a time, checking the room once per integer rather than calling into
+	the writer. IntObj::EncodeScalar() and UIntObj::EncodeScalar() are built
+	on these, as are the encoders of SLists and dict blocks of integers and
+	of the typed containers.
+
+	DecodeUIntRun() and DecodeIntRun() decode up to n integers straight out
+	of the size bytes at p into out. They return how many they decoded and
+	how many bytes that took. They stop early at a 0xf1 byte or at an integer
+	that runs past the end of the bytes, leaving that one for you to decode
+	the usual way (with UIntObj::decodeData() or the like).
+
+	Since the length of each integer is found in its first byte, the integers
+	in a run cannot be located independently of one another. What can be
+	done in parallel is finding out how many 1-byte integers come next, which
+	is the common case in practice. So when BINON_X86_SIMD is enabled (see
+	macros.hpp), the decoders check once at runtime whether the CPU supports
+	AVX2 or SSE4.1. If it does, they classify 32 or 16 bytes at a time by
+	their top bits and widen any 1-byte integers among them with vector
+	instructions. The longer integers, and all the integers on other CPUs,
+	are decoded by a branch-light scalar routine. VarintDecoderISA() tells
+	you which of "avx2", "sse4.1", or "scalar" was picked.
+
+	ForceVarintDecoderISA() is a testing hook that switches the decoders over
+	to those of the named ISA. It returns false and changes nothing if the
+	CPU or build cannot run them. An empty isa restores the automatic pick.
+	It is not safe to call while another thread may be decoding.
+
+	ReadVarintRun() does the same from a ByteReader. It decodes as much as it
+	can in place from the reader's memory window (see ByteReader::window()),
+	calling emit(v) for each integer. Wherever an integer cannot be decoded
+	this way, it calls slow() to read a single element from the reader
+	instead. TScalar must be IntVal::TScalar or UIntVal::TScalar.
+
+	The decoders in treecodec.cpp use these for SLists and dict key/value
+	blocks of IntObj or UIntObj, as do SListT, SKDictT, and SDictT for native
+	integers.
+	*/
+	inline constexpr std::size_t kMaxVarintSize = 9;
+	constexpr auto UIntVarintSize(std::uint64_t v) noexcept -> std::size_t;
+	constexpr auto IntVarintSize(std::int64_t v) noexcept -> std::size_t;
+	auto StoreUIntVarint(std::uint64_t v, std::byte* p) noexcept
+		-> std::size_t;
+	auto StoreIntVarint(std::int64_t v, std::byte* p) noexcept -> std::size_t;
+	void WriteUIntVarint(std::uint64_t v, ByteWriter& writer);
+	void WriteIntVarint(std::int64_t v, ByteWriter& writer);
+	void WriteUIntVarints(
+		const std::uint64_t* p, std::size_t n, ByteWriter& writer
+		);
+	void WriteIntVarints(
+		const std::int64_t* p, std::size_t n, ByteWriter& writer
+		);
+
+	struct VarintRun {
+		std::size_t count;
+		std::size_t size;
+	};
+	auto DecodeUIntRun(
+		const std::byte* p, std::size_t size, std::uint64_t* out,
+		std::size_t n
+		) noexcept -> VarintRun;
+	auto DecodeIntRun(
+		const std::byte* p, std::size_t size, std::int64_t* out,
+		std::size_t n
+		) noexcept -> VarintRun;
+	auto VarintDecoderISA() noexcept -> std::string_view;
+	auto ForceVarintDecoderISA(std::string_view isa) noexcept -> bool;
+
+	template<typename TScalar, typename Emit, typename Slow>
+		void ReadVarintRun(
+			ByteReader& reader, std::size_t n, Emit emit, Slow slow
+			);
+
+	//==== Template Implementation =============================================
+
+	namespace details {
+
+		//	kVarintSizes maps the number of bits needed to represent a value
+		//	(including the sign bit if it is signed) to its encoded length.
+		inline constexpr auto kVarintSizes = [] {
+			std::array<unsigned char,65> sizes{};
+			for(std::size_t bits = 0; bits < sizes.size(); ++bits) {
+				sizes[bits] =
+					bits <= 7u ? 1u : bits <= 14u ? 2u :
+					bits <= 29u ? 4u : bits <= 60u ? 8u : 9u;
+			}
+			return sizes;
+		}();
+
+		//	kVarintPrefixes holds the length prefix of each encoded length
+		//	(below 9), already shifted to the top of a 64-bit word, and
+		//	kVarintPrefixBits the number of bits it takes up.
+		inline constexpr std::array<std::uint64_t,9> kVarintPrefixes{
+			0, 0x00000000'00000000, 0x80000000'00000000, 0,
+			0xC0000000'00000000, 0, 0, 0, 0xE0000000'00000000
+		};
+		inline constexpr std::array<unsigned char,9> kVarintPrefixBits{
+			0,1,2,0, 3,0,0,0, 4
+		};
+
+		template<bool Signed>
+			inline auto StoreVarint(std::uint64_t u, std::byte* p) noexcept
+				-> std::size_t
+		{
+			auto len = Signed ?
+				IntVarintSize(static_cast<std::int64_t>(u)) :
+				UIntVarintSize(u);
+			if(len == kMaxVarintSize) {
+				*p++ = std::byte{0xf0};
+			}
+			else {
+				u <<= 64u - 8u * len;
+				if constexpr(Signed) {
+					//	Clear the sign bits that would overlap the prefix.
+					u &= ~std::uint64_t{0} >> kVarintPrefixBits[len];
+				}
+				u |= kVarintPrefixes[len];
+			}
+			if(LittleEndian()) {
+				u = SwapBytes(u);
+			}
+			std::memcpy(p, &u, sizeof u);
+			return len;
+		}
+
+		//	These handle the case in which the writer's window is too short.
+		void WriteUIntVarintSlow(std::uint64_t v, ByteWriter& writer);
+		void WriteIntVarintSlow(std::int64_t v, ByteWriter& writer);
+	}
+
+	constexpr auto UIntVarintSize(std::uint64_t v) noexcept -> std::size_t {
+		return details::kVarintSizes[64u - CountLZero(v | 1u)];
+	}
+	constexpr auto IntVarintSize(std::int64_t v) noexcept -> std::size_t {
+		//	Flipping the bits of a negative value leaves its magnitude bits
+		//	counted the same way as for a positive one.
+		auto u = static_cast<std::uint64_t>(v);
+		u ^= std::uint64_t{0} - (u >> 63);
+		return details::kVarintSizes[65u - CountLZero(u | 1u)];
+	}
+
+	inline auto StoreUIntVarint(std::uint64_t v, std::byte* p) noexcept
+		-> std::size_t
+	{
+		return details::StoreVarint<false>(v, p);
+	}
+	inline auto StoreIntVarint(std::int64_t v, std::byte* p) noexcept
+		-> std::size_t
+	{
+		return details::StoreVarint<true>(static_cast<std::uint64_t>(v), p);
+	}
+	inline void WriteUIntVarint(std::uint64_t v, ByteWriter& writer) {
+		if(writer.windowSize() >= kMaxVarintSize) {
+			writer.advance(StoreUIntVarint(v, writer.window()));
+		}
+		else {
+			details::WriteUIntVarintSlow(v, writer);
+		}
+	}
+	inline void WriteIntVarint(std::int64_t v, ByteWriter& writer) {
+		if(writer.windowSize() >= kMaxVarintSize) {
+			writer.advance(StoreIntVarint(v, writer.window()));
+		}
+		else {
+			details::WriteIntVarintSlow(v, writer);
+		}
+	}
+	template<typename TScalar, typename Emit, typename Slow>
+		void ReadVarintRun(
+			ByteReader& reader, std::size_t n, Emit emit, Slow slow
+			)
+	{
+		static_assert(
+			std::is_same_v<TScalar,std::int64_t> ||
+			std::is_same_v<TScalar,std::uint64_t>
+			);
+		constexpr std::size_t kChunk = 0x100;
+		std::array<TScalar,kChunk> buf;
+		while(n > 0) {
+			auto m = std::min(n, kChunk);
+			VarintRun run;
+			if constexpr(std::is_signed_v<TScalar>) {
+				run = DecodeIntRun(
+					reader.window(), reader.windowSize(), buf.data(), m
+					);
+			}
+			else {
+				run = DecodeUIntRun(
+					reader.window(), reader.windowSize(), buf.data(), m
+					);
+			}
+			reader.consume(run.size);
+			for(std::size_t i = 0; i < run.count; ++i) {
+				emit(buf[i]);
+			}
+			n -= run.count;
+			if(run.count < m) {
+				slow();
+				--n;
+			}
+		}
+	}
+}
+
+#endif
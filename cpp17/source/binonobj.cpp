@@ -1,17 +1,15 @@
 #include "binon/objhelpers.hpp"
+#include "binon/treecodec.hpp"
 
 #include <iostream>
 
 namespace binon {
 	auto BinONObj::Decode(TIStream& stream, bool requireIO) -> BinONObj {
-		RequireIO rio{stream, requireIO};
-		CodeByte cb = CodeByte::Read(stream, kSkipRequireIO);
-		auto varObj{FromTypeCode(cb.typeCode())};
-		std::visit(
-			[&](auto& obj) { obj.decode(cb, stream, kSkipRequireIO); },
-			varObj.value()
-			);
-		return varObj;
+		StreamReader reader{stream, requireIO};
+		return Decode(reader);
+	}
+	auto BinONObj::Decode(ByteReader& reader) -> BinONObj {
+		return DecodeTree(reader);
 	}
 	auto BinONObj::FromTypeCode(CodeByte typeCode) -> BinONObj {
 		switch(typeCode.asUInt()) {
@@ -128,26 +126,50 @@ namespace binon {
 	auto BinONObj::encode(TOStream& stream, bool requireIO) const
 		-> const BinONObj&
 	{
-		std::visit(
-			[&](const auto& obj) { obj.encode(stream, requireIO); },
-		 	value()
-			);
+		StreamWriter writer{stream, requireIO};
+		encode(writer);
+		writer.flush();
+		return *this;
+	}
+	auto BinONObj::encode(ByteWriter& writer) const -> const BinONObj& {
+		EncodeTree(*this, writer);
 		return *this;
 	}
 	auto BinONObj::encodeData(TOStream& stream, bool requireIO) const
 		-> const BinONObj&
 	{
-		std::visit(
-			[&](const auto& obj) { obj.encodeData(stream, requireIO); },
+		StreamWriter writer{stream, requireIO};
+		encodeData(writer);
+		writer.flush();
+		return *this;
+	}
+	auto BinONObj::encodeData(ByteWriter& writer) const -> const BinONObj& {
+		EncodeTreeData(*this, writer);
+		return *this;
+	}
+	auto BinONObj::encodedSize() const -> std::size_t {
+		return std::visit(
+			[](const auto& obj) -> std::size_t { return obj.encodedSize(); },
+			value()
+			);
+	}
+	auto BinONObj::encodedDataSize() const -> std::size_t {
+		return std::visit(
+			[](const auto& obj) -> std::size_t {
+				return obj.encodedDataSize();
+			},
 			value()
 			);
-		return *this;
 	}
 	auto BinONObj::decodeData(TIStream& stream, bool requireIO)
 		-> BinONObj&
 	{
+		StreamReader reader{stream, requireIO};
+		return decodeData(reader);
+	}
+	auto BinONObj::decodeData(ByteReader& reader) -> BinONObj& {
 		std::visit(
-			[&](auto& obj) { obj.decodeData(stream, requireIO); },
+			[&](auto& obj) { obj.decodeData(reader); },
 			value()
 			);
 		return *this;
@@ -176,17 +198,74 @@ namespace binon {
 		obj.print(stream);
 		return stream;
 	}
+
+	//---- KeyHash -------------------------------------------------------------
+
+	//	The native key overloads hash temporary objects that do not allocate
+	//	anything (the StrObj holds a view), so that the hashes are sure to
+	//	match.
+	auto KeyHash::operator() (const BinONObj& key) const -> std::size_t {
+		return std::hash<BinONObj>{}(key);
+	}
+	auto KeyHash::operator() (std::string_view key) const noexcept
+		-> std::size_t
+	{
+		return SaltHash(StrObj{HyStr{key}}.hash());
+	}
+	auto KeyHash::operator() (std::int64_t key) const noexcept
+		-> std::size_t
+	{
+		return SaltHash(IntObj{key}.hash());
+	}
+	auto KeyHash::operator() (std::uint64_t key) const noexcept
+		-> std::size_t
+	{
+		return SaltHash(UIntObj{key}.hash());
+	}
+
+	//---- KeyEq ---------------------------------------------------------------
+
+	auto KeyEq::operator() (const BinONObj& key, const BinONObj& other) const
+		-> bool
+	{
+		return key == other;
+	}
+	auto KeyEq::operator() (const BinONObj& key, std::string_view other) const
+		noexcept -> bool
+	{
+		auto p = std::get_if<StrObj>(&key);
+		return p && p->value().asView() == other;
+	}
+	auto KeyEq::operator() (const BinONObj& key, std::int64_t other) const
+		noexcept -> bool
+	{
+		//	As with IntObj's operator==, a value in vector form never equals
+		//	a scalar.
+		auto p = std::get_if<IntObj>(&key);
+		if(!p) {
+			return false;
+		}
+		auto pScalar = std::get_if<IntVal::TScalar>(&p->mValue);
+		return pScalar && *pScalar == other;
+	}
+	auto KeyEq::operator() (const BinONObj& key, std::uint64_t other) const
+		noexcept -> bool
+	{
+		auto p = std::get_if<UIntObj>(&key);
+		if(!p) {
+			return false;
+		}
+		auto pScalar = std::get_if<UIntVal::TScalar>(&p->mValue);
+		return pScalar && *pScalar == other;
+	}
 }
 
 auto std::hash<binon::BinONObj>::operator() (const binon::BinONObj& obj) const
 	-> std::size_t
 {
 	using std::size_t;
-	auto msb = (sizeof(size_t) << 3) - 1;
-	size_t salt = binon::gHashSalt;
-	salt = salt << 1 | salt >> msb & 0x1;
-	return std::visit(
+	return binon::SaltHash(std::visit(
 		[](const auto& obj) -> size_t { return obj.hash(); },
 		obj.value()
-	) ^ salt;
+	));
 }
@@ -0,0 +1,152 @@
+#include "binon/bitvec.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace binon {
+
+	//---- Local functions -----------------------------------------------------
+
+	static auto WordsFor(std::size_t n) noexcept {
+		return (n + BitVec::kWordBits - 1u) / BitVec::kWordBits;
+	}
+
+	//---- BitVec --------------------------------------------------------------
+
+	BitVec::BitVec(std::size_t n, bool v) {
+		resize(n, v);
+	}
+	BitVec::BitVec(std::initializer_list<bool> init) {
+		reserve(init.size());
+		for(auto v: init) {
+			push_back(v);
+		}
+	}
+	void BitVec::resize(std::size_t n, bool v) {
+		auto n0 = mSize;
+		mWords.resize(WordsFor(n), 0u);
+		mSize = n;
+		if(v && n > n0) {
+
+			//	Set bits up to the next byte boundary one at a time and then
+			//	fill whole bytes.
+			auto i = n0;
+			for(; i < n && (i & 0x7u) != 0u; ++i) {
+				set(i);
+			}
+			if(i < n) {
+				std::memset(bytes() + (i >> 3), 0xff, byteSize() - (i >> 3));
+			}
+		}
+		clearTail();
+	}
+	void BitVec::reserve(std::size_t n) {
+		mWords.reserve(WordsFor(n));
+	}
+	void BitVec::clear() noexcept {
+		mWords.clear();
+		mSize = 0u;
+	}
+	auto BitVec::count() const noexcept -> std::size_t {
+		std::size_t n = 0;
+		for(auto w: mWords) {
+			n += PopCount(w);
+		}
+		return n;
+	}
+	auto BitVec::any() const noexcept -> bool {
+		return std::any_of(
+			mWords.begin(), mWords.end(), [](TWord w) { return w != 0u; }
+			);
+	}
+	auto BitVec::flip() noexcept -> BitVec& {
+		for(auto& w: mWords) {
+			w = ~w;
+		}
+		clearTail();
+		return *this;
+	}
+	auto BitVec::operator&= (const BitVec& rhs) -> BitVec& {
+		checkSize(rhs);
+		for(std::size_t i = 0; i < mWords.size(); ++i) {
+			mWords[i] &= rhs.mWords[i];
+		}
+		return *this;
+	}
+	auto BitVec::operator|= (const BitVec& rhs) -> BitVec& {
+		checkSize(rhs);
+		for(std::size_t i = 0; i < mWords.size(); ++i) {
+			mWords[i] |= rhs.mWords[i];
+		}
+		return *this;
+	}
+	auto BitVec::operator^= (const BitVec& rhs) -> BitVec& {
+		checkSize(rhs);
+		for(std::size_t i = 0; i < mWords.size(); ++i) {
+			mWords[i] ^= rhs.mWords[i];
+		}
+		return *this;
+	}
+	auto BitVec::operator== (const BitVec& rhs) const noexcept -> bool {
+		return mSize == rhs.mSize && mWords == rhs.mWords;
+	}
+	void BitVec::assign(const std::byte* p, std::size_t n) {
+		mWords.assign(WordsFor(n), 0u);
+		mSize = n;
+		std::memcpy(bytes(), p, byteSize());
+		clearTail();
+	}
+	void BitVec::read(ByteReader& reader, std::size_t n) {
+		auto nBytes = (n + 7u) >> 3;
+		reader.checkAvail(nBytes);
+		mWords.clear();
+		auto got = reader.readGrowing(nBytes, [this](std::size_t size) {
+			mWords.resize(WordsFor(size * 8u), 0u);
+			return reinterpret_cast<std::byte*>(bytes());
+		});
+		mSize = std::min(n, got * 8u);
+		clearTail();
+	}
+	void BitVec::write(ByteWriter& writer) const {
+		writer.write(data(), byteSize());
+	}
+	void BitVec::clearTail() noexcept {
+		if(mWords.empty()) {
+			return;
+		}
+		auto nBytes = byteSize();
+		if(auto bits = mSize & 0x7u; bits != 0u) {
+			bytes()[nBytes - 1u] &= static_cast<unsigned char>(
+				0xff00u >> bits
+				);
+		}
+		std::memset(
+			bytes() + nBytes, 0, mWords.size() * sizeof(TWord) - nBytes
+			);
+	}
+	void BitVec::checkSize(const BitVec& rhs) const {
+		if(mSize != rhs.mSize) {
+			throw std::invalid_argument{"BitVec operands differ in size"};
+		}
+	}
+
+	//---- Operators -----------------------------------------------------------
+
+	auto operator& (BitVec lhs, const BitVec& rhs) -> BitVec {
+		lhs &= rhs;
+		return lhs;
+	}
+	auto operator| (BitVec lhs, const BitVec& rhs) -> BitVec {
+		lhs |= rhs;
+		return lhs;
+	}
+	auto operator^ (BitVec lhs, const BitVec& rhs) -> BitVec {
+		lhs ^= rhs;
+		return lhs;
+	}
+	auto operator~ (BitVec v) -> BitVec {
+		v.flip();
+		return v;
+	}
+}
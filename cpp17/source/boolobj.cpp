@@ -4,9 +4,7 @@ namespace binon {
 
 	//---- BoolObj ------------------------------------------------------------
 
-	auto BoolObj::encode(TOStream& stream, bool requireIO) const
-		-> const BoolObj&
-	{
+	auto BoolObj::encode(ByteWriter& writer) const -> const BoolObj& {
 		CodeByte cb;
 		if(mValue) {
 			cb = kTrueObjCode;
@@ -15,15 +13,13 @@ namespace binon {
 			cb = kTypeCode;
 			Subtype{cb} = Subtype::kDefault;
 		}
-		cb.write(stream, requireIO);
+		cb.write(writer);
 		return *this;
 	}
-	auto BoolObj::decode(CodeByte cb, TIStream& stream, bool requireIO)
-		-> BoolObj&
-	{
+	auto BoolObj::decode(CodeByte cb, ByteReader& reader) -> BoolObj& {
 		switch(cb.asUInt()) {
 			case kBoolObjCode.asUInt():
-				mValue = ByteUnpack<std::byte>(stream, requireIO) != 0x00_byte;
+				mValue = reader.get() != 0x00_byte;
 				break;
 			case kTrueObjCode.asUInt():
 				mValue = true;
@@ -33,17 +29,12 @@ namespace binon {
 		}
 		return *this;
 	}
-	auto BoolObj::encodeData(TOStream& stream, bool requireIO) const
-		-> const BoolObj&
-	{
-		std::byte byt = mValue ? 0x01_byte : 0x00_byte;
-		BytePack(byt, stream, requireIO);
+	auto BoolObj::encodeData(ByteWriter& writer) const -> const BoolObj& {
+		writer.put(mValue ? 0x01_byte : 0x00_byte);
 		return *this;
 	}
-	auto BoolObj::decodeData(TIStream& stream, bool requireIO)
-		-> BoolObj&
-	{
-		mValue = ByteUnpack<std::byte>(stream, requireIO) != 0x00_byte;
+	auto BoolObj::decodeData(ByteReader& reader) -> BoolObj& {
+		mValue = reader.get() != 0x00_byte;
 		return *this;
 	}
 	void BoolObj::printArgs(std::ostream& stream) const {
@@ -33,25 +33,29 @@ namespace binon {
 	auto BufferObj::hasDefVal() const noexcept -> bool {
 		return mValue.size() == 0;
 	}
-	auto BufferObj::encodeData(TOStream& stream, bool requireIO) const
-		-> const BufferObj&
+	auto BufferObj::encodeData(ByteWriter& writer) const -> const BufferObj&
 	{
-		RequireIO rio{stream, requireIO};
-		UIntObj{mValue.size()}.encodeData(stream, kSkipRequireIO);
-		auto data = reinterpret_cast<const TStreamByte*>(mValue.data());
-		stream.write(data, mValue.size());
+		UIntObj{mValue.size()}.encodeData(writer);
+		writer.write(mValue.data(), mValue.size());
 		return *this;
 	}
-	auto BufferObj::decodeData(TIStream& stream, bool requireIO)
-		-> BufferObj&
-	{
-		RequireIO rio{stream, requireIO};
-		UIntObj sizeObj;
-		sizeObj.decodeData(stream, kSkipRequireIO);
-		auto n = sizeObj.value().scalar();
-		mValue.resize(n);
-		auto data = reinterpret_cast<TStreamByte*>(mValue.data());
-		stream.read(data, n);
+	auto BufferObj::encodedDataSize() const noexcept -> std::size_t {
+		auto n = mValue.size();
+		return UIntObj::EncodedDataSize(n) + n;
+	}
+	auto BufferObj::decodeData(ByteReader& reader) -> BufferObj& {
+		resetHash();
+		auto n = UIntObj::DecodeSize(reader);
+		reader.checkLength(n);
+		if(auto p = reader.borrow(n); p) {
+			mValue = TValue{TValue::TView{p, n}, reader.owner()};
+		}
+		else {
+			reader.readGrowing(n, [this](std::size_t size) {
+				mValue.resize(size);
+				return mValue.data();
+			});
+		}
 		return *this;
 	}
 	void BufferObj::printArgs(std::ostream& stream) const {
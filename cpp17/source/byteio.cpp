@@ -0,0 +1,245 @@
+#include "binon/byteio.hpp"
+
+#include <algorithm>
+
+namespace binon {
+
+	//---- ByteWriter ----------------------------------------------------------
+
+	void ByteWriter::writeSlow(const std::byte* p, std::size_t n) {
+		makeRoom(n);
+		mPos = std::copy(p, p + n, mPos);
+	}
+
+	//---- VectorWriter --------------------------------------------------------
+
+	VectorWriter::VectorWriter(TBytes& bytes) noexcept:
+		mBytes{bytes}
+	{
+		//	The window starts out empty, so the vector is left alone until the
+		//	first call to makeRoom(). Any existing content counts as written.
+		mBase = bytes.size();
+	}
+	VectorWriter::~VectorWriter() {
+		flush();
+	}
+	void VectorWriter::flush() {
+		if(mBeg) {
+			mBase = count();
+			mBytes.resize(mBase);
+			mBeg = mPos = mEnd = nullptr;
+		}
+	}
+	void VectorWriter::makeRoom(std::size_t n) {
+		auto used = count();
+		auto size = used + n;
+		auto cap = mBytes.capacity();
+		size = size <= cap ? cap : std::max({size, cap * 2, std::size_t{64}});
+		mBytes.resize(size);
+		mBeg = mBytes.data();
+		mPos = mBeg + used;
+		mEnd = mBeg + size;
+		mBase = 0;
+	}
+
+	//---- SpanWriter ----------------------------------------------------------
+
+	SpanWriter::SpanWriter(std::byte* data, std::size_t size) noexcept {
+		mBeg = mPos = data;
+		mEnd = data + size;
+	}
+ #if BINON_CPP20
+	SpanWriter::SpanWriter(std::span<std::byte> span) noexcept:
+		SpanWriter{span.data(), span.size()}
+	{
+	}
+ #endif
+	void SpanWriter::makeRoom(std::size_t) {
+		throw BufOverrun{"BinON encoding does not fit the output buffer"};
+	}
+
+	//---- StreamWriter --------------------------------------------------------
+
+	StreamWriter::StreamWriter(TOStream& stream, bool requireIO) noexcept:
+		mStream{stream}
+	{
+		mContext.requireIO = requireIO;
+		mBeg = mPos = mBuffer.data();
+		mEnd = mBeg + mBuffer.size();
+	}
+	StreamWriter::~StreamWriter() {
+		try {
+			flush();
+		}
+		catch(...) {
+		}
+	}
+	void StreamWriter::flush() {
+		auto n = static_cast<std::size_t>(mPos - mBeg);
+		if(n) {
+			mBase += n;
+			mPos = mBeg;
+			mStream.write(
+				reinterpret_cast<const TStreamByte*>(mBeg),
+				static_cast<std::streamsize>(n)
+				);
+			checkStream();
+		}
+	}
+	void StreamWriter::checkStream() const {
+		if(mContext.requireIO && !mStream) {
+			throw TIOS::failure{"BinON encoder could not write to its stream"};
+		}
+	}
+	void StreamWriter::makeRoom(std::size_t n) {
+		if(n > mBuffer.size()) {
+			throw std::length_error{
+				"StreamWriter cannot prepare more than kStreamBufSize bytes"
+			};
+		}
+		flush();
+	}
+	void StreamWriter::writeSlow(const std::byte* p, std::size_t n) {
+		flush();
+		if(n < mBuffer.size()) {
+			mPos = std::copy(p, p + n, mPos);
+		}
+		else {
+			mBase += n;
+			mStream.write(
+				reinterpret_cast<const TStreamByte*>(p),
+				static_cast<std::streamsize>(n)
+				);
+			checkStream();
+		}
+	}
+
+	//---- ByteReader ----------------------------------------------------------
+
+	void ByteReader::setBorrowMode(BorrowMode mode) {
+		if(mode == BorrowMode::kShared && !mOwner) {
+			throw std::invalid_argument{
+				"BorrowMode::kShared requires a ByteReader with an owner"
+			};
+		}
+		mBorrowMode = mode;
+	}
+	auto ByteReader::remaining() const noexcept -> std::size_t {
+		return kNoLimit;
+	}
+	void ByteReader::checkAvail(std::size_t n) const {
+		if(n > remaining()) {
+			throw BufOverrun{
+				"BinON decoder read past the end of its input buffer"
+			};
+		}
+		auto used = count();
+		if(used > mContext.maxBytes || n > mContext.maxBytes - used) {
+			throw LimitErr{"BinON input exceeds CodecContext::maxBytes"};
+		}
+	}
+	void ByteReader::checkLength(std::size_t n) const {
+		if(n > mContext.maxStrLen) {
+			throw LimitErr{
+				"BinON data length exceeds CodecContext::maxStrLen"
+			};
+		}
+		checkAvail(n);
+	}
+	void ByteReader::checkNulls(std::size_t n) {
+		if(mNullCount > mContext.maxNullCount ||
+			n > mContext.maxNullCount - mNullCount)
+		{
+			throw LimitErr{
+				"BinON null element count exceeds CodecContext::maxNullCount"
+			};
+		}
+		mNullCount += n;
+	}
+	auto ByteReader::borrowSlow(std::size_t) -> const std::byte* {
+		return nullptr;
+	}
+	void ByteReader::skipSlow(std::size_t n) {
+		std::array<std::byte, 0x100> buffer;
+		while(n > 0) {
+			auto chunk = std::min(n, buffer.size());
+			read(buffer.data(), chunk);
+			n -= chunk;
+		}
+	}
+
+	//---- SpanReader ----------------------------------------------------------
+
+	SpanReader::SpanReader(const std::byte* data, std::size_t size) noexcept {
+		mBeg = mPos = data;
+		mEnd = data + size;
+	}
+	SpanReader::SpanReader(const TBytes& bytes) noexcept:
+		SpanReader{bytes.data(), bytes.size()}
+	{
+	}
+	SpanReader::SpanReader(TStringView sv) noexcept:
+		SpanReader{reinterpret_cast<const std::byte*>(sv.data()), sv.size()}
+	{
+	}
+	SpanReader::SpanReader(
+		const std::byte* data, std::size_t size,
+		std::shared_ptr<const void> owner, BorrowMode mode
+		) noexcept:
+		SpanReader{data, size}
+	{
+		mOwner = std::move(owner);
+		mBorrowMode = mode == BorrowMode::kShared && !mOwner
+			? BorrowMode::kCopy : mode;
+	}
+	SpanReader::SpanReader(std::shared_ptr<const TBytes> bytes) noexcept:
+		SpanReader{
+			bytes ? bytes->data() : nullptr, bytes ? bytes->size() : 0,
+			bytes
+			}
+	{
+	}
+ #if BINON_CPP20
+	SpanReader::SpanReader(std::span<const std::byte> span) noexcept:
+		SpanReader{span.data(), span.size()}
+	{
+	}
+ #endif
+	auto SpanReader::remaining() const noexcept -> std::size_t {
+		return static_cast<std::size_t>(mEnd - mPos);
+	}
+	void SpanReader::readSlow(std::byte*, std::size_t) {
+		throw BufOverrun{"BinON decoder read past the end of its input buffer"};
+	}
+	auto SpanReader::borrowSlow(std::size_t) -> const std::byte* {
+		throw BufOverrun{"BinON decoder read past the end of its input buffer"};
+	}
+	void SpanReader::skipSlow(std::size_t) {
+		throw BufOverrun{"BinON decoder read past the end of its input buffer"};
+	}
+
+	//---- StreamReader --------------------------------------------------------
+
+	StreamReader::StreamReader(TIStream& stream, bool requireIO) noexcept:
+		mStream{stream}
+	{
+		mContext.requireIO = requireIO;
+	}
+	void StreamReader::readSlow(std::byte* p, std::size_t n) {
+		std::streamsize got = 0;
+		if(mStream.good()) {
+			got = mStream.rdbuf()->sgetn(
+				reinterpret_cast<TStreamByte*>(p),
+				static_cast<std::streamsize>(n)
+				);
+		}
+		mBase += static_cast<std::size_t>(got);
+		if(static_cast<std::size_t>(got) < n) {
+			std::fill(p + got, p + n, std::byte{});
+			mStream.setstate(TIOS::eofbit | TIOS::failbit);
+			if(mContext.requireIO) {
+				throw TIOS::failure{"BinON decoder ran out of stream data"};
+			}
+		}
+	}
+}
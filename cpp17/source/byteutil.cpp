@@ -21,7 +21,7 @@ namespace binon {
 		stream << "0x" << AsHexC(value, capitalize).data() << "_byte";
 	}
 
-#if !BINON_CPP20
+#if !BINON_CPP20 && !defined(__BYTE_ORDER__)
 	auto LittleEndian() noexcept -> bool {
 		static const bool kLittleEndian = []{
 			int i = 0xff;
@@ -7,9 +7,15 @@ namespace binon {
 	auto CodeByte::Read(TIStream& stream, bool requireIO) -> CodeByte {
 		return ByteUnpack<std::byte>(stream, requireIO);
 	}
+	auto CodeByte::Read(ByteReader& reader) -> CodeByte {
+		return reader.get();
+	}
 	void CodeByte::write(TOStream& stream, bool requireIO) const {
 		BytePack(mValue, stream, requireIO);
 	}
+	void CodeByte::write(ByteWriter& writer) const {
+		writer.put(mValue);
+	}
 	void CodeByte::printRepr(std::ostream& stream) const {
 		switch(asUInt()) {
 		 case kNullObjCode.asUInt():
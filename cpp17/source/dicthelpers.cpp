@@ -3,7 +3,7 @@
 namespace binon {
 	auto MakeDictObj(std::initializer_list<TCTypePair> pairs) -> DictObj {
 		DictObj obj;
-		auto& map = obj.value();
+		auto& map = obj.updateValue();
 		for(auto& pair: pairs) {
 			map[pair.first] = std::move(pair.second);
 		}
@@ -13,7 +13,7 @@ namespace binon {
 		CodeByte keyCode, std::initializer_list<TCTypePair> pairs
 	) -> SKDict {
 		SKDict obj{keyCode};
-		auto& map = obj.value();
+		auto& map = obj.updateValue();
 		for(auto& pair: pairs) {
 			map[std::move(pair.first).asTypeCodeObj(keyCode)]
 				= std::move(pair.second);
@@ -25,7 +25,7 @@ namespace binon {
 		std::initializer_list<TCTypePair> pairs
 	) -> SDict {
 		SDict obj{keyCode, valCode};
-		auto& map = obj.value();
+		auto& map = obj.updateValue();
 		for(auto& pair: pairs) {
 			map[std::move(pair.first).asTypeCodeObj(keyCode)] =
 				std::move(pair.second).asTypeCodeObj(valCode);
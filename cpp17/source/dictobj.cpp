@@ -1,4 +1,5 @@
 #include "binon/packelems.hpp"
+#include "binon/treecodec.hpp"
 
 #include <iostream>
 
@@ -40,14 +41,35 @@ namespace binon {
 		return value().size() == 0;
 	}
 	auto DictBase::value() & -> TValue& {
+		lendValue();
+	 #if BINON_DICT_STORAGE == BINON_DICT_STD
 		return std::any_cast<TValue&>(mValue);
-
+	 #else
+		return mValue;
+	 #endif
 	}
 	auto DictBase::value() && -> TValue {
+		resetHash();
+	 #if BINON_DICT_STORAGE == BINON_DICT_STD
 		return std::any_cast<TValue&&>(std::move(mValue));
+	 #else
+		return std::move(mValue);
+	 #endif
 	}
 	auto DictBase::value() const& -> const TValue& {
-		return const_cast<DictBase*>(this)->value();
+	 #if BINON_DICT_STORAGE == BINON_DICT_STD
+		return std::any_cast<const TValue&>(mValue);
+	 #else
+		return mValue;
+	 #endif
+	}
+	auto DictBase::updateValue() & -> TValue& {
+		resetHash();
+	 #if BINON_DICT_STORAGE == BINON_DICT_STD
+		return std::any_cast<TValue&>(mValue);
+	 #else
+		return mValue;
+	 #endif
 	}
 	auto DictBase::size() const -> std::size_t {
 		return value().size();
@@ -64,47 +86,31 @@ namespace binon {
 	//---- DictObj -------------------------------------------------------------
 
 	DictObj::DictObj(const SKDict& obj) {
-		value() = obj.value();
+		updateValue() = obj.value();
 	}
 	DictObj::DictObj(const SDict& obj) {
-		value() = obj.value();
+		updateValue() = obj.value();
 	}
-	auto DictObj::encodeData(TOStream& stream, bool requireIO) const
-		-> const DictObj&
-	{
-		RequireIO rio{stream, requireIO};
-		auto& u = value();
-		UIntObj{u.size()}.encodeData(stream, kSkipRequireIO);
-		for(auto& [k, v]: u) {
-			k.encode(stream, kSkipRequireIO);
-		}
-		for(auto& [k, v]: u) {
-			v.encode(stream, kSkipRequireIO);
-		}
+	auto DictObj::encodeData(ByteWriter& writer) const -> const DictObj& {
+		EncodeTreeData(*this, writer);
 		return *this;
 	}
-	auto DictObj::decodeData(TIStream& stream, bool requireIO)
-		-> DictObj&
-	{
-		RequireIO rio{stream, requireIO};
+	auto DictObj::encodedDataSize() const -> std::size_t {
 		auto& u = value();
-		UIntObj sizeObj;
-		sizeObj.decodeData(stream, kSkipRequireIO);
-		auto n = sizeObj.value().scalar();
-		std::vector<BinONObj> ks;
-		ks.reserve(n);
-		u.clear();
-		u.reserve(n);
-		while(n-->0) {
-			ks.push_back(BinONObj::Decode(stream, kSkipRequireIO));
-		}
-		for(auto& k: ks) {
-			u[std::move(k)] = BinONObj::Decode(stream, kSkipRequireIO);
+		auto n = UIntObj::EncodedDataSize(u.size());
+		for(auto& [k, v]: u) {
+			n += k.encodedSize() + v.encodedSize();
 		}
+		return n;
+	}
+	auto DictObj::decodeData(ByteReader& reader) -> DictObj& {
+		DecodeTreeData(*this, reader);
 		return *this;
 	}
 	auto DictObj::hash() const -> std::size_t {
-		return calcHash(std::hash<CodeByte>{}(kTypeCode));
+		return cachedHash(
+			[this] { return calcHash(std::hash<CodeByte>{}(kTypeCode)); }
+			);
 	}
 	void DictObj::printArgs(std::ostream& stream) const {
 		stream << "DictObj::TValue{";
@@ -137,55 +143,28 @@ namespace binon {
 	{
 		this->mValue = obj.value();
 	}
-	auto SKDict::encodeData(TOStream& stream, bool requireIO) const
-		-> const SKDict&
-	{
-		if(mKeyCode == kNoObjCode) {
-			std::ostringstream oss;
-			oss << "SKDict is missing a key code (";
-			BinONObj{*this}.print(oss);
-			oss << ')';
-			throw NoTypeCode{oss.str()};
-		}
-		RequireIO rio{stream, requireIO};
-		auto& u = value();
-		UIntObj{u.size()}.encodeData(stream, kSkipRequireIO);
-		mKeyCode.write(stream, kSkipRequireIO);
-		{
-			PackElems packKey{mKeyCode, stream};
-			for(auto& [k, v]: u) {
-				packKey(k, kSkipRequireIO);
-			}
-		}
-		for(auto& [k, v]: u) {
-			v.encode(stream, kSkipRequireIO);
-		}
+	auto SKDict::encodeData(ByteWriter& writer) const -> const SKDict& {
+		EncodeTreeData(*this, writer);
 		return *this;
 	}
-	auto SKDict::decodeData(TIStream& stream, bool requireIO)
-		-> SKDict&
-	{
-		RequireIO rio{stream, requireIO};
+	auto SKDict::encodedDataSize() const -> std::size_t {
 		auto& u = value();
-		UIntObj sizeObj;
-		sizeObj.decodeData(stream, kSkipRequireIO);
-		auto n = sizeObj.value().scalar();
-		mKeyCode = CodeByte::Read(stream, kSkipRequireIO);
-		std::vector<BinONObj> ks;
-		ks.reserve(n);
-		u.clear();
-		u.reserve(n);
-		UnpackElems unpackKey{mKeyCode, stream};
-		while(n-->0) {
-			ks.push_back(unpackKey(kSkipRequireIO));
-		}
-		for(auto& k: ks) {
-			u[std::move(k)] = BinONObj::Decode(stream, kSkipRequireIO);
+		auto n = UIntObj::EncodedDataSize(u.size()) + 1u;
+		PackedSize packedKeys{mKeyCode};
+		for(auto& [k, v]: u) {
+			packedKeys(k);
+			n += v.encodedSize();
 		}
+		return n + packedKeys.size();
+	}
+	auto SKDict::decodeData(ByteReader& reader) -> SKDict& {
+		DecodeTreeData(*this, reader);
 		return *this;
 	}
 	auto SKDict::hash() const -> std::size_t {
-		return calcHash(std::hash<CodeByte>{}(kTypeCode));
+		return cachedHash(
+			[this] { return calcHash(std::hash<CodeByte>{}(kTypeCode)); }
+			);
 	}
 	void SKDict::printArgs(std::ostream& stream) const {
 		stream << "SKDict::TValue{";
@@ -215,71 +194,28 @@ namespace binon {
 		mValCode{valCode}
 	{
 	}
-	auto SDict::encodeData(TOStream& stream, bool requireIO) const
-		-> const SDict&
-	{
-		if(mKeyCode == kNoObjCode || mValCode == kNoObjCode) {
-			std::ostringstream oss;
-			oss << "SDict is missing a";
-			if(mKeyCode == kNoObjCode) {
-				oss << " key";
-				if(mValCode == kNoObjCode) {
-					oss << " and value";
-				}
-			}
-			else {
-				oss << " value";
-			}
-			oss << " code (";
-			BinONObj{*this}.print(oss);
-			oss << ')';
-			throw NoTypeCode{oss.str()};
-		}
-		RequireIO rio{stream, requireIO};
-		auto& u = value();
-		UIntObj{u.size()}.encodeData(stream, kSkipRequireIO);
-		mKeyCode.write(stream, kSkipRequireIO);
-		{
-			PackElems packKey{mKeyCode, stream};
-			for(auto& [k, v]: u) {
-				packKey(k, kSkipRequireIO);
-			}
-		}
-		mValCode.write(stream, kSkipRequireIO);
-		{
-			PackElems packVal{mValCode, stream};
-			for(auto& [k, v]: u) {
-				packVal(v, kSkipRequireIO);
-			}
-		}
+	auto SDict::encodeData(ByteWriter& writer) const -> const SDict& {
+		EncodeTreeData(*this, writer);
 		return *this;
 	}
-	auto SDict::decodeData(TIStream& stream, bool requireIO)
-		-> SDict&
-	{
-		RequireIO rio{stream, requireIO};
+	auto SDict::encodedDataSize() const -> std::size_t {
 		auto& u = value();
-		UIntObj sizeObj;
-		sizeObj.decodeData(stream, kSkipRequireIO);
-		auto n = sizeObj.value().scalar();
-		mKeyCode = CodeByte::Read(stream, kSkipRequireIO);
-		std::vector<BinONObj> ks;
-		ks.reserve(n);
-		u.clear();
-		u.reserve(n);
-		UnpackElems unpackKey{mKeyCode, stream};
-		while(n-->0) {
-			ks.push_back(unpackKey(kSkipRequireIO));
-		}
-		mValCode = CodeByte::Read(stream, kSkipRequireIO);
-		UnpackElems unpackVal{mValCode, stream};
-		for(auto& k: ks) {
-			u[std::move(k)] = unpackVal(kSkipRequireIO);
+		PackedSize packedKeys{mKeyCode}, packedVals{mValCode};
+		for(auto& [k, v]: u) {
+			packedKeys(k);
+			packedVals(v);
 		}
+		return UIntObj::EncodedDataSize(u.size()) + 2u +
+			packedKeys.size() + packedVals.size();
+	}
+	auto SDict::decodeData(ByteReader& reader) -> SDict& {
+		DecodeTreeData(*this, reader);
 		return *this;
 	}
 	auto SDict::hash() const -> std::size_t {
-		return calcHash(std::hash<CodeByte>{}(kTypeCode));
+		return cachedHash(
+			[this] { return calcHash(std::hash<CodeByte>{}(kTypeCode)); }
+			);
 	}
 	void SDict::printArgs(std::ostream& stream) const {
 		stream << "SDict::TValue{";
@@ -0,0 +1,226 @@
+#include "binon/encodeplan.hpp"
+#include "binon/optimalobj.hpp"
+#include "binon/packelems.hpp"
+#include "binon/treecodec.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+namespace binon {
+
+	namespace {
+
+		//	A dict's signature combines the hashes of its keys and value
+		//	type codes in iteration order.
+		auto Signature(const TDict& dict) -> std::size_t {
+			std::size_t sig = dict.size();
+			for(auto& [key, val]: dict) {
+				sig = HashCombine(
+					sig,
+					std::hash<BinONObj>{}(key),
+					std::hash<CodeByte>{}(val.typeCode())
+					);
+			}
+			return sig;
+		}
+
+		//	As in OptimalObj(), keys mixing IntObj with UIntObj or FloatObj
+		//	with Float32Obj are not optimized, since optimizing could make 2
+		//	of them equal.
+		auto MixedKeys(const TList& keys) -> bool {
+			bool hasInt = false, hasUInt = false;
+			bool hasFloat = false, hasFloat32 = false;
+			for(auto& key: keys) {
+				switch(key.typeCode().asUInt()) {
+					case kIntObjCode.asUInt(): hasInt = true; break;
+					case kUIntCode.asUInt(): hasUInt = true; break;
+					case kFloatObjCode.asUInt(): hasFloat = true; break;
+					case kFloat32Code.asUInt(): hasFloat32 = true; break;
+				}
+			}
+			return (hasInt && hasUInt) || (hasFloat && hasFloat32);
+		}
+
+		//	Container keys are not covered by MixedKeys(), since the scalars
+		//	nested within them get optimized independently. DistinctKeys()
+		//	checks that optimizing has not made any 2 keys equal.
+		auto HasCtnrKeys(const TList& keys) -> bool {
+			return std::any_of(keys.begin(), keys.end(),
+				[](const BinONObj& key) {
+					auto baseType = key.typeCode().baseType();
+					return baseType == kListObjCode.baseType() ||
+						baseType == kDictObjCode.baseType();
+				});
+		}
+		auto DistinctKeys(const TList& keys) -> bool {
+			std::unordered_set<BinONObj> seen;
+			seen.reserve(keys.size());
+			for(auto& key: keys) {
+				if(!seen.insert(key).second) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	//---- EncodePlanCache::Plan -----------------------------------------------
+
+	auto EncodePlanCache::Plan::matches(const TDict& dict) const -> bool {
+		if(dict.size() != mKeys.size()) {
+			return false;
+		}
+		std::size_t i = 0;
+		for(auto& [key, val]: dict) {
+			if(val.typeCode() != mValCodes[i] || key != mKeys[i]) {
+				return false;
+			}
+			++i;
+		}
+		return true;
+	}
+
+	//---- EncodePlanCache -----------------------------------------------------
+
+	EncodePlanCache::EncodePlanCache(std::size_t maxPlans):
+		mMaxPlans{maxPlans},
+		mLastPlan{nullptr}
+	{
+	}
+	void EncodePlanCache::encode(const BinONObj& obj, ByteWriter& writer) {
+		encodeObj(obj, writer, 0);
+	}
+	void EncodePlanCache::encode(
+		const BinONObj& obj, TOStream& stream, bool requireIO
+		)
+	{
+		StreamWriter writer{stream, requireIO};
+		encode(obj, writer);
+		writer.flush();
+	}
+	auto EncodePlanCache::size() const noexcept -> std::size_t {
+		return mPlans.size();
+	}
+	void EncodePlanCache::clear() noexcept {
+		mPlans.clear();
+		mLastPlan = nullptr;
+	}
+	void EncodePlanCache::encodeObj(
+		const BinONObj& obj, ByteWriter& writer, std::size_t depth
+		)
+	{
+		if(auto pDict = std::get_if<DictObj>(&obj);
+			pDict && !pDict->hasDefVal())
+		{
+			CheckEncodeDepth(depth, writer);
+			encodeDict(pDict->value(), writer, depth);
+		}
+		else if(auto pList = std::get_if<ListObj>(&obj);
+			pList && !pList->hasDefVal())
+		{
+			CheckEncodeDepth(depth, writer);
+			auto& list = pList->value();
+			kListObjCode.write(writer);
+			UIntObj::EncodeScalar(list.size(), writer);
+			for(auto& elem: list) {
+				encodeObj(elem, writer, depth + 1);
+			}
+		}
+		else {
+			obj.encode(writer);
+		}
+	}
+	void EncodePlanCache::encodeDict(
+		const TDict& dict, ByteWriter& writer, std::size_t depth
+		)
+	{
+		//	Copy what we need out of the plan, since encoding nested dicts
+		//	may clear the cache.
+		auto& plan = findPlan(dict);
+		auto typeCode = plan.mTypeCode;
+		auto valCode = plan.mValCode;
+		typeCode.write(writer);
+		writer.write(plan.mKeyBlock.data(), plan.mKeyBlock.size());
+		if(typeCode == kSDictCode) {
+			PackValues(valCode, dict, writer);
+		}
+		else {
+			for(auto& pair: dict) {
+				encodeObj(pair.second, writer, depth + 1);
+			}
+		}
+	}
+	auto EncodePlanCache::findPlan(const TDict& dict) -> const Plan& {
+		if(mLastPlan && mLastPlan->matches(dict)) {
+			return *mLastPlan;
+		}
+		auto sig = Signature(dict);
+		auto [it, end] = mPlans.equal_range(sig);
+		for(; it != end; ++it) {
+			if(it->second.matches(dict)) {
+				return *(mLastPlan = &it->second);
+			}
+		}
+		if(mPlans.size() >= mMaxPlans) {
+			clear();
+		}
+		auto pos = mPlans.emplace(sig, MakePlan(dict));
+		return *(mLastPlan = &pos->second);
+	}
+	auto EncodePlanCache::MakePlan(const TDict& dict) -> Plan {
+		Plan plan;
+		plan.mKeys.reserve(dict.size());
+		plan.mValCodes.reserve(dict.size());
+		bool sameVals = true;
+		for(auto& [key, val]: dict) {
+			plan.mKeys.push_back(key);
+			plan.mValCodes.push_back(val.typeCode());
+			sameVals = sameVals && val.typeCode() == plan.mValCodes[0];
+		}
+
+		//	Let OptimalObj() decide whether the keys can share a key code.
+		//	Since the plan gets reused, it may as well take a full look.
+		BinONObj keys = ListObj{plan.mKeys};
+		if(!MixedKeys(plan.mKeys)) {
+			OptimizeOpts opts;
+			opts.cheapCount = kNoLimit;
+			if(!HasCtnrKeys(plan.mKeys)) {
+				keys = OptimalObj(std::move(keys), opts);
+			}
+			else {
+				//	Fall back on the unoptimized DictObj keys if any 2 of
+				//	them have become equal.
+				auto optKeys = OptimalObj(keys, opts);
+				auto pSList = std::get_if<SList>(&optKeys);
+				if(DistinctKeys(pSList ? pSList->value() :
+					std::get<ListObj>(optKeys).value()))
+				{
+					keys = std::move(optKeys);
+				}
+			}
+		}
+		VectorWriter writer{plan.mKeyBlock};
+		UIntObj::EncodeScalar(dict.size(), writer);
+		if(auto pKeys = std::get_if<SList>(&keys); pKeys) {
+			pKeys->mElemCode.write(writer);
+			PackRun(pKeys->mElemCode, pKeys->value(), writer);
+			if(sameVals) {
+				plan.mTypeCode = kSDictCode;
+				plan.mValCode = plan.mValCodes[0];
+				plan.mValCode.write(writer);
+			}
+			else {
+				plan.mTypeCode = kSKDictCode;
+			}
+		}
+		else {
+			plan.mTypeCode = kDictObjCode;
+			for(auto& key: std::get<ListObj>(keys).value()) {
+				key.encode(writer);
+			}
+		}
+		writer.flush();
+		return plan;
+	}
+}
@@ -12,16 +12,12 @@ namespace binon {
 		mValue{v}
 	{
 	}
-	auto FloatObj::encodeData(TOStream& stream, bool requireIO) const
-		-> const FloatObj&
-	{
-		BytePack(mValue, stream, requireIO);
+	auto FloatObj::encodeData(ByteWriter& writer) const -> const FloatObj& {
+		BytePack(mValue, writer);
 		return *this;
 	}
-	auto FloatObj::decodeData(TIStream& stream, bool requireIO)
-		-> FloatObj&
-	{
-		mValue = ByteUnpack<TValue>(stream, requireIO);
+	auto FloatObj::decodeData(ByteReader& reader) -> FloatObj& {
+		mValue = ByteUnpack<TValue>(reader);
 		return *this;
 	}
 
@@ -31,16 +27,12 @@ namespace binon {
 		mValue{v}
 	{
 	}
-	auto Float32Obj::encodeData(TOStream& stream, bool requireIO) const
-		-> const Float32Obj&
-	{
-		BytePack(mValue, stream, requireIO);
+	auto Float32Obj::encodeData(ByteWriter& writer) const -> const Float32Obj& {
+		BytePack(mValue, writer);
 		return *this;
 	}
-	auto Float32Obj::decodeData(TIStream& stream, bool requireIO)
-		-> Float32Obj&
-	{
-		mValue = ByteUnpack<TValue>(stream, requireIO);
+	auto Float32Obj::decodeData(ByteReader& reader) -> Float32Obj& {
+		mValue = ByteUnpack<TValue>(reader);
 		return *this;
 	}
 }
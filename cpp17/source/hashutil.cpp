@@ -11,6 +11,13 @@ namespace binon {
 		return dis(lcg);
 	}();
 
+	auto SaltHash(std::size_t hash) noexcept -> std::size_t {
+		constexpr auto kMSB = (sizeof(size_t) << 3) - 1;
+		size_t salt = gHashSalt;
+		salt = salt << 1 | (salt >> kMSB & 0x1);
+		return hash ^ salt;
+	}
+
 	void CommutativeHash::extend(std::size_t hashVal) {
 		mHash ^= (hashVal ^ (hashVal << 16) ^ 89869747UL) * 3644798167UL;
 	}
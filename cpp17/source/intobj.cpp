@@ -1,330 +1,429 @@
 #include "binon/intobj.hpp"
+#include "binon/varint.hpp"
 
 #include <algorithm>
-#include <cctype>
-#include <iomanip>
+#include <array>
+#include <cstring>
 #include <limits>
-#include <sstream>
-
-#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace binon {
 
 	//---- Local functions -----------------------------------------------------
 
-	static auto FilterHex(const HyStr& hex) {
-		auto iter = hex.begin();
-		for(; iter != hex.end(); ++iter) {
-			if(std::tolower(*iter) == 'x') {
-				break;
-			}
-		}
-		if(iter == hex.end()) {
-			iter = hex.begin();
-		}
-		return [&hex, iter]() mutable -> char {
-			for(; iter != hex.end(); ++iter) {
-				if(std::isxdigit(*iter)) {
-					return *iter++;
-				}
-			}
-			return '\xff';
-		};
-	}
-	static auto CountHexDigits(const HyStr& hex) {
-		std::size_t n = 0;
-		auto filter = FilterHex(hex);
-		while(filter() != '\xff') {
-			++n;
-		}
-		return n;
-	}
-	static auto HexCodeGen(const HyStr& hex, std::stringstream& ss) {
-		ss << std::hex;
-		auto filter = FilterHex(hex);
-		return [&ss, filter]() mutable -> std::byte {
-			auto c = filter();
-			if(c == '\xff') {
-				return 0xff_byte;
-			}
-			ss.seekp(0);
-			ss.seekg(0);
-			ss << c;
-			int digit;
-			ss >> digit;
-			return ToByte(digit & 0xf);
-		};
+	//	kHexVals maps a character to its hexadecimal digit value, or to -1 if
+	//	it is not a hex digit.
+	static constexpr auto kHexVals = [] {
+		std::array<signed char,0x100> vals{};
+		for(auto& v: vals) {
+			v = -1;
+		}
+		for(int i = 0; i < 10; ++i) {
+			vals['0' + i] = static_cast<signed char>(i);
+		}
+		for(int i = 0; i < 6; ++i) {
+			vals['a' + i] = vals['A' + i] = static_cast<signed char>(10 + i);
+		}
+		return vals;
+	}();
+	static constexpr char kHexDigits[] = "0123456789abcdef";
+
+	static auto HexVal(char c) noexcept {
+		return kHexVals[static_cast<unsigned char>(c)];
 	}
-	static void BytesFromHex(
-		IntVal::TVect& v, const HyStr& hex, std::size_t nDigits
-		)
-	{
-		std::stringstream ss;
-		auto gen = HexCodeGen(hex, ss);
-		v.clear();
-		v.reserve((nDigits + 1) >> 1);
-		bool flush = (nDigits & 0x1) != 0x0;
-		std::byte byt = 0x00_byte;
-		auto digit = gen();
-		while(digit != 0xff_byte) {
-			byt <<= 4;
-			byt |= digit;
-			if(flush) {
-				v.push_back(byt);
-				byt = 0x00_byte;
-			}
-			flush = !flush;
-			digit = gen();
-		}
+
+	//	HexRange() skips ahead to the 'x' of any "0x" prefix.
+	static auto HexRange(const HyStr& hex) {
+		std::string_view sv{hex.data(), hex.size()};
+		auto i = sv.find_first_of("xX");
+		return i == sv.npos ? sv : sv.substr(i + 1u);
 	}
 	static auto PaddedBytes(const HyStr& hex, std::size_t wordSize) {
-		auto sigHex = CountHexDigits(hex);
+		auto sv = HexRange(hex);
+		std::size_t sigHex = 0;
+		for(auto c: sv) {
+			sigHex += HexVal(c) >= 0;
+		}
+		wordSize = std::max<std::size_t>(wordSize, 1u);
 		auto sigByt = (sigHex + 1u) >> 1;
 		auto reqByt = sigByt + wordSize - 1u;
 		reqByt -= reqByt % wordSize;
-		auto padByt = reqByt - sigByt;
-		IntVal::TVect u;
-		u.reserve(reqByt);
-		while(padByt-->0u) {
-			u.push_back(0x00_byte);
+		IntVal::TVect u(reqByt, 0x00_byte);
+
+		//	Digits are filled in from the least-significant end.
+		auto p = u.data() + reqByt;
+		bool low = true;
+		for(auto it = sv.rbegin(); it != sv.rend(); ++it) {
+			auto v = HexVal(*it);
+			if(v < 0) {
+				continue;
+			}
+			if(low) {
+				*--p = ToByte(v);
+			}
+			else {
+				*p |= ToByte(v << 4);
+			}
+			low = !low;
 		}
-		BytesFromHex(u, hex, sigHex);
 		return u;
 	}
 
-	template<typename Scalar>
-		static auto ByteGen(const std::variant<Scalar,IntVal::TVect>& var)
-			-> std::function<std::optional<std::byte>()>
+	//	SigBytes() returns the significant big-endian bytes of an integer
+	//	value. These are the bytes that are left once any pad bytes are
+	//	trimmed off the front (though at least 1 always remains). buf provides
+	//	storage for a scalar value's bytes.
+	template<typename Val>
+		static auto SigBytes(const Val& val, std::array<std::byte,8>& buf)
+			-> std::pair<const std::byte*,std::size_t>
 		{
-			using std::byte;
-			using std::get;
-			using std::nullopt;
-			using std::optional;
-			if(std::holds_alternative<Scalar>(var)) {
-				auto scalar = get<Scalar>(var);
-				auto n = sizeof(Scalar) * 8u;
-				return [scalar, n]() mutable -> optional<byte> {
-					if(n == 0u) {
-						return nullopt;
-					}
-					n -= 8u;
-					return ToByte(scalar >> n & 0xff);
-				};
+			using TScalar = typename Val::TScalar;
+			const std::byte* p;
+			std::size_t n;
+			if(auto pScalar = std::get_if<TScalar>(&val); pScalar) {
+				auto u = static_cast<std::uint64_t>(*pScalar);
+				if(LittleEndian()) {
+					u = SwapBytes(u);
+				}
+				std::memcpy(buf.data(), &u, sizeof u);
+				p = buf.data();
+				n = buf.size();
 			}
 			else {
-				auto& vect = get<IntVal::TVect>(var);
-				auto iter = vect.begin();
-				return [&vect, iter]() mutable -> optional<byte> {
-					if(iter == vect.end()) {
-						return nullopt;
-					}
-					return *iter++;
-				};
-			}
-		}
-	static auto SigByteGen(
-		const std::variant<IntVal::TScalar,IntVal::TVect>& var
-		)
-		-> std::function<std::optional<std::byte>()>
-	{
-		enum {kInit, kPosPad, kNegPad, kData};
-		auto stage = kInit;
-		auto byteGen = ByteGen(var);
-		return [stage, byteGen]() mutable -> std::optional<std::byte> {
-			std::optional<std::byte> optByte;
-			for(;;) {
-				auto optByte = byteGen();
-				if(!optByte.has_value()) {
-					if(stage != kData) {
-						optByte = stage == kNegPad ? 0xff_byte : 0x00_byte;
-						stage = kData;
-					}
-					return optByte;
+				auto& v = std::get<typename Val::TVect>(val);
+				if(v.empty()) {
+					buf[0] = 0x00_byte;
+					return {buf.data(), 1u};
 				}
-				switch(stage) {
-				case kInit:
-					switch(std::to_integer<int>(*optByte)) {
-					case 0x00:
-						stage = kPosPad;
-						break;
-					case 0xff:
-						stage = kNegPad;
-						break;
-					default:
-						stage = kData;
-						return optByte;
-					}
-					break;
-				case kPosPad:
-					if(*optByte != 0x00_byte) {
-						stage = kData;
-						return optByte;
-					}
-					break;
-				case kNegPad:
-					if(*optByte != 0xff_byte) {
-						stage = kData;
-						return optByte;
-					}
-					break;
-				default: // kData
-					return optByte;
+				p = v.data();
+				n = v.size();
+			}
+			if constexpr(std::is_signed_v<TScalar>) {
+				auto pad = (p[0] & 0x80_byte) != 0x00_byte ?
+					0xff_byte : 0x00_byte;
+				while(n > 1u && p[0] == pad &&
+					((p[1] ^ pad) & 0x80_byte) == 0x00_byte)
+				{
+					++p, --n;
 				}
 			}
-		};
-	}
-	static auto SigByteGen(
-		const std::variant<UIntVal::TScalar,UIntVal::TVect>& var
-		)
-		-> std::function<std::optional<std::byte>()>
-	{
-		bool gotData = false;
-		auto byteGen = ByteGen(var);
-		return [gotData, byteGen]() mutable -> std::optional<std::byte> {
-			std::optional<std::byte> optByte;
-			for(;;) {
-				auto optByte = byteGen();
-				if(!optByte.has_value()) {
-					if(!gotData) {
-						optByte = 0x00_byte;
-						gotData = true;
-					}
-					return optByte;
-				}
-				if(gotData) {
-					return optByte;
-				}
-				if(*optByte != 0x00_byte) {
-					gotData = true;
-					return optByte;
+			else {
+				while(n > 1u && p[0] == 0x00_byte) {
+					++p, --n;
 				}
 			}
-		};
+			return {p, n};
+		}
+	template<typename Val>
+		static auto HexString(
+			const Val& val, bool zerox, std::size_t wordSize
+			) -> std::string
+		{
+			std::array<std::byte,8> buf;
+			auto [p, n] = SigBytes(val, buf);
+			auto pad = std::is_signed_v<typename Val::TScalar> &&
+				(p[0] & 0x80_byte) != 0x00_byte ? 'f' : '0';
+			wordSize = std::max<std::size_t>(wordSize, 1u);
+			auto nPad = (wordSize - n % wordSize) % wordSize;
+			std::string hex(zerox ? 2u : 0u, 'x');
+			if(zerox) {
+				hex[0] = '0';
+			}
+			hex.reserve(hex.size() + 2u * (nPad + n));
+			hex.append(2u * nPad, pad);
+			for(auto e = p + n; p != e; ++p) {
+				auto b = std::to_integer<unsigned>(*p);
+				hex.push_back(kHexDigits[b >> 4]);
+				hex.push_back(kHexDigits[b & 0xfu]);
+			}
+			return hex;
+		}
+
+	//	Big integers are converted to and from decimal by way of 32-bit limbs
+	//	stored least-significant first, which can be divided or multiplied by
+	//	kDecChunk (10^9) in a single pass.
+	using TLimbs = std::vector<std::uint32_t>;
+	constexpr std::uint32_t kDecChunk = 1'000'000'000u;
+	constexpr std::size_t kDecChunkDigits = 9;
+
+	static void Negate(std::byte* p, std::size_t n) noexcept {
+		unsigned carry = 1u;
+		while(n-->0u) {
+			auto v = (~std::to_integer<unsigned>(p[n]) & 0xffu) + carry;
+			p[n] = ToByte(v & 0xffu);
+			carry = v >> 8;
+		}
+	}
+	static auto BytesToLimbs(const std::byte* p, std::size_t n) -> TLimbs {
+		TLimbs limbs((n + 3u) >> 2, 0u);
+		for(std::size_t i = 0; i < n; ++i) {
+			auto j = n - 1u - i;
+			limbs[i >> 2] |=
+				std::to_integer<std::uint32_t>(p[j]) << ((i & 0x3u) << 3);
+		}
+		return limbs;
 	}
-	static auto PaddedByteGen(
-		const std::variant<IntVal::TScalar,IntVal::TVect>& var,
-		std::size_t wordSize
-		)
-		-> std::function<std::optional<std::byte>()>
+	static auto LimbsToBytes(const TLimbs& limbs, std::size_t lead)
+		-> IntVal::TVect
 	{
-		auto sbg = SigByteGen(var);
-		auto padByte =
-			(sbg().value() & 0x80_byte) != 0x00_byte ?
-			0xff_byte : 0x00_byte;
-		std::size_t n;
-		for(n = 1; sbg().has_value(); ++n) {}
-		auto nPad = n + wordSize - 1u;
-		nPad -= nPad % wordSize + n;
-		sbg = SigByteGen(var);
-		return [padByte, nPad, sbg]() mutable -> std::optional<std::byte> {
-			if(nPad > 0u) {
-				--nPad;
-				return padByte;
+		//	lead extra 0x00 bytes are prepended (to leave room for a sign
+		//	bit).
+		auto n = limbs.size() << 2;
+		IntVal::TVect u(lead + n, 0x00_byte);
+		for(std::size_t i = 0; i < n; ++i) {
+			auto limb = limbs[i >> 2] >> ((i & 0x3u) << 3);
+			u[lead + n - 1u - i] = ToByte(limb & 0xffu);
+		}
+		return u;
+	}
+	static auto DecString(std::uint64_t u, bool neg) -> std::string {
+		std::array<char,24> buf;
+		auto p = buf.data() + buf.size();
+		do {
+			*--p = static_cast<char>('0' + u % 10u);
+			u /= 10u;
+		} while(u);
+		if(neg) {
+			*--p = '-';
+		}
+		return std::string(p, buf.data() + buf.size());
+	}
+	static auto DecString(TLimbs limbs, bool neg) -> std::string {
+		std::string dec;
+		dec.reserve(limbs.size() * 10u + 1u);
+		while(!limbs.empty() && limbs.back() == 0u) {
+			limbs.pop_back();
+		}
+		while(!limbs.empty()) {
+			std::uint64_t rem = 0;
+			for(auto i = limbs.size(); i-->0u;) {
+				auto v = rem << 32 | limbs[i];
+				limbs[i] = static_cast<std::uint32_t>(v / kDecChunk);
+				rem = v % kDecChunk;
 			}
-			return sbg();
-		};
+			if(limbs.back() == 0u) {
+				limbs.pop_back();
+			}
+			for(std::size_t i = 0; i < kDecChunkDigits; ++i) {
+				dec.push_back(static_cast<char>('0' + rem % 10u));
+				rem /= 10u;
+			}
+		}
+		while(dec.size() > 1u && dec.back() == '0') {
+			dec.pop_back();
+		}
+		if(dec.empty()) {
+			dec.push_back('0');
+		}
+		if(neg) {
+			dec.push_back('-');
+		}
+		std::reverse(dec.begin(), dec.end());
+		return dec;
 	}
-	static auto PaddedByteGen(
-		const std::variant<UIntVal::TScalar,UIntVal::TVect>& var,
-		std::size_t wordSize
-		)
-		-> std::function<std::optional<std::byte>()>
+	template<typename Val>
+		static auto DecString(const Val& val) -> std::string {
+			using TScalar = typename Val::TScalar;
+			if(auto pScalar = std::get_if<TScalar>(&val); pScalar) {
+				auto i = *pScalar;
+				auto u = static_cast<std::uint64_t>(i);
+				if(i < 0) {
+					return DecString(std::uint64_t{0} - u, true);
+				}
+				return DecString(u, false);
+			}
+			auto& v = std::get<typename Val::TVect>(val);
+			if constexpr(std::is_signed_v<TScalar>) {
+				if(!v.empty() && (v[0] & 0x80_byte) != 0x00_byte) {
+					IntVal::TVect mag{v};
+					Negate(mag.data(), mag.size());
+					return DecString(
+						BytesToLimbs(mag.data(), mag.size()), true
+						);
+				}
+			}
+			return DecString(BytesToLimbs(v.data(), v.size()), false);
+		}
+
+	//	ParseDec() parses the digits of dec into magnitude limbs, or into u
+	//	if there are few enough of them (in which case limbs stays empty). It
+	//	returns whether the value is negative. dec must be an optional '+' or
+	//	'-' followed by 1 or more digits, or std::invalid_argument is thrown.
+	static auto ParseDec(const HyStr& dec, std::uint64_t& u, TLimbs& limbs)
+		-> bool
 	{
-		auto sbg = SigByteGen(var);
-		std::size_t n;
-		for(n = 0; sbg().has_value(); ++n) {}
-		auto nPad = n + wordSize - 1u;
-		nPad -= nPad % wordSize + n;
-		sbg = SigByteGen(var);
-		return [nPad, sbg]() mutable -> std::optional<std::byte> {
-			if(nPad > 0u) {
-				--nPad;
-				return 0x00_byte;
+		constexpr std::size_t kMaxScalarDigits = 19;
+		std::string_view sv{dec.data(), dec.size()};
+		bool neg = false;
+		if(!sv.empty() && (sv.front() == '-' || sv.front() == '+')) {
+			neg = sv.front() == '-';
+			sv.remove_prefix(1u);
+		}
+		if(sv.empty() || sv.find_first_not_of("0123456789") != sv.npos) {
+			throw std::invalid_argument{
+				"malformed decimal integer: \"" +
+				std::string{dec.data(), dec.size()} + '"'
+				};
+		}
+		auto nDigits = sv.size();
+		u = 0u;
+		if(nDigits <= kMaxScalarDigits) {
+			for(auto c: sv) {
+				u = u * 10u + static_cast<unsigned>(c - '0');
+			}
+			return neg;
+		}
+
+		//	Digits are consumed in chunks of 9, the first chunk taking up
+		//	whatever is left over.
+		limbs.reserve(nDigits / kDecChunkDigits / 2u + 2u);
+		auto chunkLen = (nDigits - 1u) % kDecChunkDigits + 1u;
+		std::uint32_t chunk = 0u, scale = 1u;
+		std::size_t got = 0;
+		auto mulAdd = [&limbs](std::uint32_t mul, std::uint32_t add) {
+			std::uint64_t carry = add;
+			for(auto& limb: limbs) {
+				auto v = std::uint64_t{limb} * mul + carry;
+				limb = static_cast<std::uint32_t>(v);
+				carry = v >> 32;
+			}
+			if(carry) {
+				limbs.push_back(static_cast<std::uint32_t>(carry));
 			}
-			return sbg();
 		};
+		for(auto c: sv) {
+			chunk = chunk * 10u + static_cast<unsigned>(c - '0');
+			scale *= 10u;
+			if(++got == chunkLen) {
+				mulAdd(scale, chunk);
+				chunk = 0u;
+				scale = 1u;
+				got = 0;
+				chunkLen = kDecChunkDigits;
+			}
+		}
+		return neg;
 	}
 
+	//	DecodeVect() decodes the byte length and bytes of vector form integer
+	//	data following the 0xf1 byte. The bytes are read straight into val's
+	//	existing vector if it has one.
+	template<typename Val>
+		static void DecodeVect(ByteReader& reader, Val& val) {
+			using TVect = typename Val::TVect;
+			auto n = UIntObj::DecodeSize(reader);
+			reader.checkLength(n);
+			auto pVect = std::get_if<TVect>(&val);
+			if(!pVect) {
+				pVect = &val.template emplace<TVect>();
+			}
+			reader.readGrowing(n, [pVect](std::size_t size) {
+				pVect->resize(size);
+				return pVect->data();
+			});
+		}
+	template<typename Val>
+		static void EncodeVect(const Val& val, ByteWriter& writer) {
+			auto& u = std::get<typename Val::TVect>(val);
+			writer.put(0xf1_byte);
+			WriteUIntVarint(u.size(), writer);
+			writer.write(u.data(), u.size());
+		}
+
 	//---- IntVal --------------------------------------------------------------
 
 	auto IntVal::FromHex(const HyStr& hex, std::size_t wordSize) -> IntVal {
-		auto u = PaddedBytes(hex, wordSize);
-		if(u.size() <= sizeof(TScalar)) {
-			return IntVal{u}.asScalar();
-		}
-		return u;
+		IntVal v{PaddedBytes(hex, wordSize)};
+		v.normalize();
+		return v;
 	}
 	auto IntVal::asHex(
 		bool zerox, std::size_t wordSize
 		) const -> std::string
 	{
-		std::ostringstream oss;
-		oss << std::hex << std::setfill('0');
-		if(zerox) {
-			oss << "0x";
+		return HexString(*this, zerox, wordSize);
+	}
+	auto IntVal::FromDec(const HyStr& dec) -> IntVal {
+		std::uint64_t u;
+		TLimbs limbs;
+		auto neg = ParseDec(dec, u, limbs);
+		if(limbs.empty()) {
+			constexpr auto kMax = static_cast<std::uint64_t>(
+				std::numeric_limits<TScalar>::max()
+				);
+			if(u <= kMax) {
+				auto i = static_cast<TScalar>(u);
+				return neg ? -i : i;
+			}
+			if(neg && u == kMax + 1u) {
+				return std::numeric_limits<TScalar>::min();
+			}
+			limbs = {
+				static_cast<std::uint32_t>(u),
+				static_cast<std::uint32_t>(u >> 32)
+			};
 		}
-		auto pbg = PaddedByteGen(*this, wordSize);
-		auto optByte = pbg();
-		while(optByte.has_value()) {
-			oss << std::setw(2) << std::to_integer<int>(*optByte);
-			optByte = pbg();
+		IntVal v{LimbsToBytes(limbs, 1u)};
+		if(neg) {
+			auto& u = v.vect();
+			Negate(u.data(), u.size());
 		}
-		return oss.str();
+		v.normalize();
+		return v;
+	}
+	auto IntVal::asDec() const -> std::string {
+		return DecString(*this);
 	}
 	auto IntVal::asScalar() const noexcept -> TScalar {
-		if(isScalar()) {
-			return scalar(kSkipNormalize);
-		}
-		TScalar i = 0;
-		auto pbg = PaddedByteGen(*this, sizeof(TScalar));
-		auto optByte = pbg();
-		while(optByte.has_value()) {
-			i <<= 8;
-			i |= std::to_integer<TScalar>(*optByte) & 0xff;
-			optByte = pbg();
+		normalize();
+		if(auto pScalar = std::get_if<TScalar>(this); pScalar) {
+			return *pScalar;
 		}
-		return i;
+		auto& v = vect();
+		return details::VectScalar<TScalar>(v.data(), v.size());
 	}
 
 	//---- UIntVal -------------------------------------------------------------
 
 	auto UIntVal::FromHex(const HyStr& hex, std::size_t wordSize) -> UIntVal {
-		auto u = PaddedBytes(hex, wordSize);
-		if(u.size() <= sizeof(TScalar)) {
-			return UIntVal{u}.asScalar();
-		}
-		return u;
+		UIntVal v{PaddedBytes(hex, wordSize)};
+		v.normalize();
+		return v;
 	}
 	auto UIntVal::asHex(
 		bool zerox, std::size_t wordSize
 		) const -> std::string
 	{
-		std::ostringstream oss;
-		oss << std::hex << std::setfill('0');
-		if(zerox) {
-			oss << "0x";
-		}
-		auto pbg = PaddedByteGen(*this, wordSize);
-		auto optByte = pbg();
-		while(optByte.has_value()) {
-			oss << std::setw(2) << std::to_integer<int>(*optByte);
-			optByte = pbg();
-		}
-		return oss.str();
+		return HexString(*this, zerox, wordSize);
+	}
+	auto UIntVal::FromDec(const HyStr& dec) -> UIntVal {
+		std::uint64_t u;
+		TLimbs limbs;
+		auto neg = ParseDec(dec, u, limbs);
+		if(neg && (u != 0u || !limbs.empty())) {
+			throw NegUnsigned{"UIntVal::FromDec given a negative number"};
+		}
+		if(limbs.empty()) {
+			return u;
+		}
+		UIntVal v{LimbsToBytes(limbs, 0u)};
+		v.normalize();
+		return v;
+	}
+	auto UIntVal::asDec() const -> std::string {
+		return DecString(*this);
 	}
 	auto UIntVal::asScalar() const noexcept -> TScalar {
-		if(isScalar()) {
-			return scalar(kSkipNormalize);
-		}
-		TScalar i = 0;
-		auto pbg = PaddedByteGen(*this, sizeof(TScalar));
-		auto optByte = pbg();
-		while(optByte.has_value()) {
-			i <<= 8;
-			i |= std::to_integer<TScalar>(*optByte) & 0xff;
-			optByte = pbg();
+		normalize();
+		if(auto pScalar = std::get_if<TScalar>(this); pScalar) {
+			return *pScalar;
 		}
-		return i;
+		auto& v = vect();
+		return details::VectScalar<TScalar>(v.data(), v.size());
 	}
 
 	//---- IntObj -------------------------------------------------------------
@@ -353,50 +452,40 @@ namespace binon {
 		mValue{v}
 	{
 	}
-	auto IntObj::encodeData(TOStream& stream, bool requireIO) const
-		-> const IntObj&
-	{
-		RequireIO rio{stream, requireIO};
+	auto IntObj::encodeData(ByteWriter& writer) const -> const IntObj& {
 		if(mValue.isScalar()) {
-			auto v = mValue.scalar(kSkipNormalize);
-			if(-0x40 <= v && v < 0x40) {
-				BytePack(ToByte(v & 0x7f), stream, kSkipRequireIO);
-			}
-			else if(-0x2000 <= v && v < 0x2000) {
-				BytePack(
-					static_cast<std::int16_t>(0x8000 | (v & 0x3fff)),
-					stream, kSkipRequireIO
-					);
-			}
-			else if(-0x10000000 <= v && v < 0x10000000) {
-				BytePack(
-					static_cast<std::int32_t>(0xC0000000 | (v & 0x1fffffff)),
-					stream, kSkipRequireIO
-					);
-			}
-			else if(-0x08000000'00000000 <= v && v < 0x08000000'00000000)
-			{
-				BytePack(
-					0xE0000000'00000000 | (v & 0x0fffffff'ffffffff),
-					stream, kSkipRequireIO
-					);
-			}
-			else {
-				BytePack('\xf0', stream, kSkipRequireIO);
-				BytePack(v, stream, kSkipRequireIO);
-			}
+			EncodeScalar(mValue.scalar(kSkipNormalize), writer);
 		}
 		else {
-			BytePack('\xf1', stream, kSkipRequireIO);
-			auto& u = mValue.vect();
-			for(auto b: u) {
-				BytePack(b, stream, kSkipRequireIO);
-			}
+			EncodeVect(mValue, writer);
+		}
+		return *this;
+	}
+	auto IntObj::encodedDataSize() const -> std::size_t {
+		if(!mValue.isScalar()) {
+			auto n = mValue.vect().size();
+			return 1u + UIntVarintSize(n) + n;
+		}
+		return EncodedDataSize(mValue.scalar(kSkipNormalize));
+	}
+	void IntObj::EncodeScalar(IntVal::TScalar v, ByteWriter& writer) {
+		WriteIntVarint(v, writer);
+	}
+	auto IntObj::EncodedDataSize(IntVal::TScalar v) noexcept -> std::size_t {
+		return IntVarintSize(v);
+	}
+	auto IntObj::decodeData(ByteReader& reader) -> IntObj& {
+		auto byte0 = reader.get();
+		if(byte0 == 0xf1_byte) {
+			DecodeVect(reader, mValue);
+		}
+		else {
+			mValue = DecodeScalar(byte0, reader);
 		}
 		return *this;
 	}
-	auto IntObj::decodeData(TIStream& stream, bool requireIO)
-		-> IntObj&
+	auto IntObj::DecodeScalar(std::byte byte0, ByteReader& reader)
+		-> IntVal::TScalar
 	{
 		auto signExtend = [](std::int64_t v, std::int64_t msbMask) {
 			auto sigBits = msbMask | msbMask - 1;
@@ -408,53 +497,32 @@ namespace binon {
 			}
 			return v;
 		};
-		RequireIO rio{stream, requireIO};
-		TValue v;
-		auto byte0 = ByteUnpack<std::byte>(stream, kSkipRequireIO);
 		if((byte0 & 0x80_byte) == 0x00_byte) {
-			v = signExtend(ByteUnpack<std::int8_t>(&byte0), 0x40);
-		}
-		else if(byte0 == 0xf1_byte) {
-			UIntObj sizeObj;
-			sizeObj.decodeData(stream, kSkipRequireIO);
-			auto n = sizeObj.value().scalar();
-			UIntVal::TVect u;
-			u.reserve(n);
-			while(n-->0u) {
-				u.push_back(ByteUnpack<std::byte>(stream));
-			}
-			v = std::move(u);
-		}
-		else {
-			std::array<std::byte,8> buffer;
-			auto bufPlus1 = reinterpret_cast<TStreamByte*>(buffer.data()) + 1;
-			buffer[0] = byte0;
-			if((byte0 & 0x40_byte) == 0x00_byte) {
-				stream.read(bufPlus1, 1);
-				v = signExtend(
-					ByteUnpack<std::int16_t>(buffer.data()), 0x2000
-					);
-			}
-			else if((byte0 & 0x20_byte) == 0x00_byte) {
-				stream.read(bufPlus1, 3);
-				v = signExtend(
-					ByteUnpack<std::int32_t>(buffer.data()), 0x10000000
-					);
-			}
-			else if((byte0 & 0x10_byte) == 0x00_byte) {
-				stream.read(bufPlus1, 7);
-				v = signExtend(
-					ByteUnpack<std::int64_t>(buffer.data()),
-					0x08000000'00000000
-					);
-			}
-			else // ((byte0 & 0x01_byte) == 0x00_byte)
-			{
-				v = ByteUnpack<std::int64_t>(stream, kSkipRequireIO);
-			}
-		}
-		mValue = v;
-		return *this;
+			return signExtend(ByteUnpack<std::int8_t>(&byte0), 0x40);
+		}
+		std::array<std::byte,8> buffer;
+		auto bufPlus1 = buffer.data() + 1;
+		buffer[0] = byte0;
+		if((byte0 & 0x40_byte) == 0x00_byte) {
+			reader.read(bufPlus1, 1);
+			return signExtend(
+				ByteUnpack<std::int16_t>(buffer.data()), 0x2000
+				);
+		}
+		if((byte0 & 0x20_byte) == 0x00_byte) {
+			reader.read(bufPlus1, 3);
+			return signExtend(
+				ByteUnpack<std::int32_t>(buffer.data()), 0x10000000
+				);
+		}
+		if((byte0 & 0x10_byte) == 0x00_byte) {
+			reader.read(bufPlus1, 7);
+			return signExtend(
+				ByteUnpack<std::int64_t>(buffer.data()),
+				0x08000000'00000000
+				);
+		}
+		return ByteUnpack<std::int64_t>(reader);
 	}
 
 	//---- UIntObj ------------------------------------------------------------
@@ -490,94 +558,97 @@ namespace binon {
 		mValue{v}
 	{
 	}
-	auto UIntObj::encodeData(TOStream& stream, bool requireIO) const
-		-> const UIntObj&
-	{
-		RequireIO rio{stream, requireIO};
+	auto UIntObj::encodeData(ByteWriter& writer) const -> const UIntObj& {
 		if(mValue.isScalar()) {
-			auto v = mValue.scalar(kSkipNormalize);
-			if(v < 0x80) {
-				BytePack(ToByte(v), stream, kSkipRequireIO);
-			}
-			else if(v < 0x4000) {
-				BytePack(
-					static_cast<std::uint16_t>(0x8000 | v),
-					stream, kSkipRequireIO
-					);
-			}
-			else if(v < 0x20000000) {
-				BytePack(
-					static_cast<std::uint32_t>(0xC0000000 | v),
-					stream, kSkipRequireIO
-					);
-			}
-			else if(v < 0x10000000'00000000) {
-				BytePack(
-					0xE0000000'00000000 | v,
-					stream, kSkipRequireIO
-					);
-			}
-			else {
-				BytePack('\xf0', stream, kSkipRequireIO);
-				BytePack(v, stream, kSkipRequireIO);
-			}
+			EncodeScalar(mValue.scalar(kSkipNormalize), writer);
 		}
 		else {
-			BytePack('\xf1', stream, kSkipRequireIO);
-			auto& u = mValue.vect();
-			for(auto b: u) {
-				BytePack(b, stream, kSkipRequireIO);
-			}
+			EncodeVect(mValue, writer);
 		}
 		return *this;
 	}
-	auto UIntObj::decodeData(TIStream& stream, bool requireIO)
-		-> UIntObj&
+	void UIntObj::EncodeScalar(UIntVal::TScalar v, ByteWriter& writer) {
+		WriteUIntVarint(v, writer);
+	}
+	auto UIntObj::encodedDataSize() const -> std::size_t {
+		if(!mValue.isScalar()) {
+			auto n = mValue.vect().size();
+			return 1u + UIntVarintSize(n) + n;
+		}
+		return EncodedDataSize(mValue.scalar(kSkipNormalize));
+	}
+	auto UIntObj::EncodedDataSize(UIntVal::TScalar v) noexcept
+		-> std::size_t
 	{
-		RequireIO rio{stream, requireIO};
-		TValue v;
-		auto byte0 = ByteUnpack<std::byte>(stream, kSkipRequireIO);
-		if((byte0 & 0x80_byte) == 0x00_byte) {
-			v = ByteUnpack<std::uint8_t>(&byte0);
-		}
-		else if(byte0 == 0xf1_byte) {
-			UIntObj sizeObj;
-			sizeObj.decodeData(stream, kSkipRequireIO);
-			auto n = sizeObj.value().scalar();
-			UIntVal::TVect u;
-			u.reserve(n);
-			while(n-->0u) {
-				u.push_back(ByteUnpack<std::byte>(stream));
-			}
-			v = std::move(u);
+		return UIntVarintSize(v);
+	}
+	auto UIntObj::decodeData(ByteReader& reader) -> UIntObj& {
+		auto byte0 = reader.get();
+		if(byte0 == 0xf1_byte) {
+			DecodeVect(reader, mValue);
 		}
 		else {
-			std::array<std::byte,8> buffer;
-			auto bufPlus1 = reinterpret_cast<TStreamByte*>(buffer.data()) + 1;
-			buffer[0] = byte0;
-			if((byte0 & 0x40_byte) == 0x00_byte) {
-				stream.read(bufPlus1, 1);
-				v = ByteUnpack<std::uint16_t>(buffer.data())
-					& 0x3fffu;
-			}
-			else if((byte0 & 0x20_byte) == 0x00_byte) {
-				stream.read(bufPlus1, 3);
-				v = ByteUnpack<std::uint32_t>(buffer.data())
-					& 0x1fffffffu;
-			}
-			else if((byte0 & 0x10_byte) == 0x00_byte) {
-				stream.read(bufPlus1, 7);
-				v = ByteUnpack<std::uint64_t>(buffer.data())
-					& 0x0fffffff'ffffffffu;
-			}
-			else // ((byte0 & 0x01_byte) == 0x00_byte)
-			{
-				v = ByteUnpack<std::uint64_t>(stream, kSkipRequireIO);
-			}
+			mValue = DecodeScalar(byte0, reader);
 		}
-		mValue = std::move(v);
 		return *this;
 	}
+	auto UIntObj::DecodeScalar(std::byte byte0, ByteReader& reader)
+		-> UIntVal::TScalar
+	{
+		if((byte0 & 0x80_byte) == 0x00_byte) {
+			return ByteUnpack<std::uint8_t>(&byte0);
+		}
+		std::array<std::byte,8> buffer;
+		auto bufPlus1 = buffer.data() + 1;
+		buffer[0] = byte0;
+		if((byte0 & 0x40_byte) == 0x00_byte) {
+			reader.read(bufPlus1, 1);
+			return ByteUnpack<std::uint16_t>(buffer.data()) & 0x3fffu;
+		}
+		if((byte0 & 0x20_byte) == 0x00_byte) {
+			reader.read(bufPlus1, 3);
+			return ByteUnpack<std::uint32_t>(buffer.data()) & 0x1fffffffu;
+		}
+		if((byte0 & 0x10_byte) == 0x00_byte) {
+			reader.read(bufPlus1, 7);
+			return ByteUnpack<std::uint64_t>(buffer.data())
+				& 0x0fffffff'ffffffffu;
+		}
+		return ByteUnpack<std::uint64_t>(reader);
+	}
+	auto UIntObj::DecodeSize(ByteReader& reader) -> std::size_t {
+		auto toSize = [](UIntVal::TScalar n) -> std::size_t {
+			if constexpr(sizeof(std::size_t) < sizeof n) {
+				if(n > std::numeric_limits<std::size_t>::max()) {
+					throw IntTrunc{"BinON data size does not fit std::size_t"};
+				}
+			}
+			return static_cast<std::size_t>(n);
+		};
+		auto byte0 = reader.get();
+		if(byte0 != 0xf1_byte) {
+			return toSize(DecodeScalar(byte0, reader));
+		}
+
+		//	The byte count of the vector form must itself be a scalar. (A
+		//	count needing the vector form could not describe a size that fits
+		//	std::size_t anyway, and recursing on it would let a long run of
+		//	0xf1 bytes exhaust the call stack.)
+		auto byte1 = reader.get();
+		if(byte1 == 0xf1_byte) {
+			throw IntTrunc{"BinON data size does not fit std::size_t"};
+		}
+		auto n = toSize(DecodeScalar(byte1, reader));
+		reader.checkLength(n);
+		std::size_t size = 0;
+		while(n-->0) {
+			if(size >> (std::numeric_limits<std::size_t>::digits - 8)) {
+				throw IntTrunc{"BinON data size does not fit std::size_t"};
+			}
+			size = size << 8 | std::to_integer<std::size_t>(reader.get());
+		}
+		return size;
+	}
 }
 
 auto std::hash<binon::IntVal>::operator() (
@@ -0,0 +1,241 @@
+#include "binon/lazyobj.hpp"
+#include "binon/packelems.hpp"
+#include "binon/skipobj.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace binon {
+
+	//---- LazyObj::Index ------------------------------------------------------
+
+	//	For a list, mElems holds the elements and mKeys is empty. For a dict,
+	//	mKeys and mElems hold the keys and values, respectively. mSize is the
+	//	element count read from the encoding, and mKeyCode the key type of an
+	//	SKDict or SDict (or kNoObjCode otherwise). mKeyMap is built by the
+	//	first call to find().
+	struct LazyObj::Index {
+		std::vector<LazyObj> mKeys;
+		std::vector<LazyObj> mElems;
+		std::size_t mSize = 0;
+		CodeByte mKeyCode = kNoObjCode;
+		mutable std::unordered_map<BinONObj,std::size_t> mKeyMap;
+		mutable bool mMapped = false;
+	};
+
+	//---- LazyObj -------------------------------------------------------------
+
+	LazyObj::LazyObj(
+		const std::byte* data, std::size_t size,
+		std::shared_ptr<const void> owner,
+		const CodecContext& context
+		):
+		mBuf{data},
+		mBufSize{size},
+		mOwner{std::move(owner)},
+		mContext{context},
+		mNullCount{std::make_shared<std::atomic<std::size_t>>(0)}
+	{
+		SpanReader reader{data, size};
+		reader.context() = mContext;
+		mCode = CodeByte::Read(reader);
+		mDataPos = 1;
+	}
+	LazyObj::LazyObj(const TBytes& bytes, const CodecContext& context):
+		LazyObj{bytes.data(), bytes.size(), {}, context}
+	{
+	}
+	LazyObj::LazyObj(
+		std::shared_ptr<const TBytes> bytes, const CodecContext& context
+		):
+		LazyObj{
+			bytes ? bytes->data() : nullptr, bytes ? bytes->size() : 0,
+			bytes, context
+			}
+	{
+	}
+	auto LazyObj::typeCode() const noexcept -> CodeByte {
+		return mCode == kTrueObjCode ? kBoolObjCode : mCode.typeCode();
+	}
+	auto LazyObj::isList() const noexcept -> bool {
+		return mCode.baseType() == kListObjCode.baseType();
+	}
+	auto LazyObj::isDict() const noexcept -> bool {
+		return mCode.baseType() == kDictObjCode.baseType();
+	}
+	auto LazyObj::size() const -> std::size_t {
+		return index().mSize;
+	}
+	auto LazyObj::operator[] (std::size_t index) const -> const LazyObj& {
+		auto& elems = this->index().mElems;
+		if(index >= elems.size()) {
+			throw std::out_of_range{"LazyObj element index out of range"};
+		}
+		return elems[index];
+	}
+	auto LazyObj::key(std::size_t index) const -> const LazyObj& {
+		auto& keys = this->index().mKeys;
+		if(index >= keys.size()) {
+			throw std::out_of_range{"LazyObj key index out of range"};
+		}
+		return keys[index];
+	}
+	auto LazyObj::decode(BorrowMode mode) const -> BinONObj {
+		auto rdr = reader(mode);
+		rdr.context() = mContext;
+		auto varObj{BinONObj::FromTypeCode(mCode.typeCode())};
+		std::visit(
+			[&](auto& obj) { obj.decode(mCode, rdr); },
+			varObj.value()
+			);
+		return varObj;
+	}
+	auto LazyObj::data() const noexcept -> const std::byte* {
+		return mBuf + mStart;
+	}
+	auto LazyObj::extent() const -> std::size_t {
+		auto n = mDataPos - mStart;
+		if(mCode.subtype() != Subtype::kDefault && mCode != kTrueObjCode) {
+			auto rdr = reader(BorrowMode::kView);
+			rdr.context() = mContext;
+			n += SkipData(mCode, rdr);
+		}
+		return n;
+	}
+	LazyObj::LazyObj(
+		const LazyObj& parent, std::size_t start, std::size_t dataPos,
+		CodeByte code
+		):
+		mBuf{parent.mBuf},
+		mBufSize{parent.mBufSize},
+		mOwner{parent.mOwner},
+		mStart{start},
+		mDataPos{dataPos},
+		mCode{code},
+		mContext{parent.mContext},
+		mNullCount{parent.mNullCount}
+	{
+	}
+	auto LazyObj::reader(BorrowMode mode) const -> SpanReader {
+		return SpanReader{
+			mBuf + mDataPos, mBufSize - mDataPos, mOwner, mode
+			};
+	}
+	auto LazyObj::index() const -> const Index& {
+		if(mIndex) {
+			return *mIndex;
+		}
+		if(!isList() && !isDict()) {
+			throw NonCtnrType{"LazyObj indexing requires a container type"};
+		}
+		auto pIndex = std::make_shared<Index>();
+		if(mCode.subtype() == Subtype::kDefault) {
+			return *(mIndex = std::move(pIndex));
+		}
+
+		//	The reader spans the whole buffer so that count() gives us
+		//	absolute offsets.
+		//	Its null budget is whatever other indexes have left over.
+		SpanReader rdr{mBuf, mBufSize};
+		rdr.context() = mContext;
+		rdr.context().maxNullCount -= std::min(
+			mNullCount->load(), mContext.maxNullCount
+			);
+		rdr.skip(mDataPos);
+		//	Counts are checked the same way the decoder checks them and not
+		//	trusted for reservation purposes beyond what the rest of the
+		//	buffer could hold.
+		auto addObjs = [&](std::vector<LazyObj>& v, std::size_t n) {
+			CheckElemCount(n, kNoObjCode, rdr);
+			v.reserve(std::min(n, rdr.remaining()));
+			while(n-->0) {
+				auto start = rdr.count();
+				auto cb = CodeByte::Read(rdr);
+				v.push_back(LazyObj{*this, start, rdr.count(), cb});
+				if(cb.subtype() != Subtype::kDefault && cb != kTrueObjCode) {
+					SkipData(cb, rdr);
+				}
+			}
+		};
+		auto addElems = [&](std::vector<LazyObj>& v, std::size_t n) {
+			auto elemCode = CodeByte::Read(rdr);
+			CheckElemCount(n, elemCode, rdr);
+			v.reserve(std::min(n, rdr.remaining()));
+			if(elemCode == kBoolObjCode) {
+
+				//	Each packed bool becomes a data-less object: either a true
+				//	or a default (false) BoolObj.
+				UnpackElems unpack{elemCode, rdr};
+				while(n-->0) {
+					auto pos = rdr.count();
+					auto cb = unpack.unpackBool()
+						? kTrueObjCode : CodeByte::FromInt(0x10);
+					v.push_back(LazyObj{*this, pos, pos, cb});
+				}
+			}
+			else {
+				while(n-->0) {
+					auto pos = rdr.count();
+					v.push_back(LazyObj{*this, pos, pos, elemCode});
+					SkipData(elemCode, rdr);
+				}
+			}
+			return elemCode;
+		};
+		auto n = UIntObj::DecodeSize(rdr);
+		switch(mCode.typeCode().asUInt()) {
+			case kListObjCode.asUInt():
+				addObjs(pIndex->mElems, n);
+				break;
+			case kSListCode.asUInt():
+				addElems(pIndex->mElems, n);
+				break;
+			case kDictObjCode.asUInt():
+				addObjs(pIndex->mKeys, n);
+				addObjs(pIndex->mElems, n);
+				break;
+			case kSKDictCode.asUInt():
+				pIndex->mKeyCode = addElems(pIndex->mKeys, n);
+				addObjs(pIndex->mElems, n);
+				break;
+			case kSDictCode.asUInt():
+				pIndex->mKeyCode = addElems(pIndex->mKeys, n);
+				addElems(pIndex->mElems, n);
+				break;
+			default:
+				throw BadCodeByte{mCode};
+		}
+		pIndex->mSize = n;
+		*mNullCount += rdr.nullCount();
+		return *(mIndex = std::move(pIndex));
+	}
+	auto LazyObj::findObj(const BinONObj& key) const
+		-> OptRef<const LazyObj>
+	{
+		if(!isDict()) {
+			throw NonCtnrType{"LazyObj::find() requires a dict type"};
+		}
+		auto& index = this->index();
+		if(!index.mMapped) {
+
+			//	Keys are decoded as views into the buffer, since they are
+			//	only needed as long as the buffer itself.
+			index.mKeyMap.reserve(index.mKeys.size());
+			for(std::size_t i = 0; i < index.mKeys.size(); ++i) {
+				index.mKeyMap.try_emplace(
+					index.mKeys[i].decode(BorrowMode::kView), i
+					);
+			}
+			index.mMapped = true;
+		}
+		auto it = index.mKeyMap.find(key);
+		if(it == index.mKeyMap.end()) {
+			return std::nullopt;
+		}
+		return index.mElems[it->second];
+	}
+	auto LazyObj::keyCode() const -> CodeByte {
+		return isDict() ? index().mKeyCode : kNoObjCode;
+	}
+}
@@ -3,7 +3,7 @@
 namespace binon {
 	auto MakeListObj(std::initializer_list<ObjWrapper> vals) -> ListObj {
 		ListObj list;
-		auto& stdList = list.value();
+		auto& stdList = list.updateValue();
 		stdList.reserve(vals.size());
 		for(auto& v: vals) {
 			stdList.push_back(std::move(v));
@@ -14,7 +14,7 @@ namespace binon {
 		-> SList
 	{
 		SList list(elemCode);
-		auto& stdList = list.value();
+		auto& stdList = list.updateValue();
 		stdList.reserve(vals.size());
 		for(auto& v: vals) {
 			stdList.push_back(std::move(v).asTypeCodeObj(elemCode));
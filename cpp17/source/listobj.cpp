@@ -1,4 +1,5 @@
 #include "binon/packelems.hpp"
+#include "binon/treecodec.hpp"
 
 #include <algorithm>
 #include <sstream>
@@ -41,34 +42,26 @@ namespace binon {
 	ListObj::ListObj(TList&& list) noexcept {
 		this->mValue = std::move(list);
 	}
-	auto ListObj::encodeData(TOStream& stream, bool requireIO) const
-		-> const ListObj&
-	{
-		RequireIO rio{stream, requireIO};
-		auto& u = value();
-		UIntObj{u.size()}.encodeData(stream, kSkipRequireIO);
-		for(auto& v: u) {
-			v.encode(stream, kSkipRequireIO);
-		}
+	auto ListObj::encodeData(ByteWriter& writer) const -> const ListObj& {
+		EncodeTreeData(*this, writer);
 		return *this;
 	}
-	auto ListObj::decodeData(TIStream& stream, bool requireIO)
-		-> ListObj&
-	{
-		RequireIO rio{stream, requireIO};
+	auto ListObj::encodedDataSize() const -> std::size_t {
 		auto& u = value();
-		UIntObj sizeObj;
-		sizeObj.decodeData(stream, kSkipRequireIO);
-		auto n = sizeObj.value().scalar();
-		u.resize(0);
-		u.reserve(n);
-		while(n-->0) {
-			u.push_back(BinONObj::Decode(stream, kSkipRequireIO));
+		auto n = UIntObj::EncodedDataSize(u.size());
+		for(auto& v: u) {
+			n += v.encodedSize();
 		}
+		return n;
+	}
+	auto ListObj::decodeData(ByteReader& reader) -> ListObj& {
+		DecodeTreeData(*this, reader);
 		return *this;
 	}
 	auto ListObj::hash() const -> std::size_t {
-		return calcHash(std::hash<CodeByte>{}(kTypeCode));
+		return cachedHash(
+			[this] { return calcHash(std::hash<CodeByte>{}(kTypeCode)); }
+			);
 	}
 	void ListObj::printArgs(std::ostream& stream) const {
 		stream << "ListObj::TValue{";
@@ -102,44 +95,26 @@ namespace binon {
 		mElemCode{elemCode}
 	{
 	}
-	auto SList::encodeData(TOStream& stream, bool requireIO) const
-		-> const SList&
-	{
-		if(mElemCode == kNoObjCode) {
-			std::ostringstream oss;
-			oss << "SList is missing an element code (";
-			BinONObj{*this}.print(oss);
-			oss << ')';
-			throw NoTypeCode{oss.str()};
-		}
-		RequireIO rio{stream, requireIO};
-		auto& u = value();
-		UIntObj{u.size()}.encodeData(stream, kSkipRequireIO);
-		mElemCode.write(stream, kSkipRequireIO);
-		PackElems pack{mElemCode, stream};
-		for(auto& v: u) {
-			pack(v, kSkipRequireIO);
-		}
+	auto SList::encodeData(ByteWriter& writer) const -> const SList& {
+		EncodeTreeData(*this, writer);
 		return *this;
 	}
-	auto SList::decodeData(TIStream& stream, bool requireIO)
-		-> SList&
-	{
-		RequireIO rio{stream, requireIO};
+	auto SList::encodedDataSize() const -> std::size_t {
 		auto& u = value();
-		UIntObj sizeObj;
-		sizeObj.decodeData(stream, kSkipRequireIO);
-		auto n = sizeObj.mValue.scalar();
-		mElemCode = CodeByte::Read(stream, kSkipRequireIO);
-		u.resize(0);
-		UnpackElems unpack{mElemCode, stream};
-		while(n-->0) {
-			u.push_back(unpack(kSkipRequireIO));
+		PackedSize packed{mElemCode};
+		for(auto& v: u) {
+			packed(v);
 		}
+		return UIntObj::EncodedDataSize(u.size()) + 1u + packed.size();
+	}
+	auto SList::decodeData(ByteReader& reader) -> SList& {
+		DecodeTreeData(*this, reader);
 		return *this;
 	}
 	auto SList::hash() const -> std::size_t {
-		return calcHash(std::hash<CodeByte>{}(kTypeCode));
+		return cachedHash(
+			[this] { return calcHash(std::hash<CodeByte>{}(kTypeCode)); }
+			);
 	}
 	void SList::printArgs(std::ostream& stream) const {
 		stream << "SList::TValue{";
@@ -0,0 +1,145 @@
+#include "binon/mmapfile.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#if BINON_MMAP
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#else
+	#include <fstream>
+#endif
+
+namespace binon {
+
+	namespace {
+	 #if BINON_MMAP
+		[[noreturn]] void ThrowErrno(const char* what, const std::string& path)
+		{
+			throw std::system_error{
+				errno, std::generic_category(),
+				std::string{what} + " \"" + path + '"'
+			};
+		}
+
+		//	Closes a file descriptor on scope exit.
+		struct FileDesc {
+			int mFD;
+			~FileDesc() { if(mFD >= 0) { ::close(mFD); } }
+		};
+	 #endif
+	}
+
+	auto MMapFile::Open(const std::string& path, unsigned advice)
+		-> std::shared_ptr<const MMapFile>
+	{
+		return std::make_shared<const MMapFile>(PrivateTag{}, path, advice);
+	}
+
+ #if BINON_MMAP
+
+	MMapFile::MMapFile(PrivateTag, const std::string& path, unsigned advice) {
+		FileDesc fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+		if(fd.mFD < 0) {
+			ThrowErrno("could not open", path);
+		}
+		struct stat st;
+		if(::fstat(fd.mFD, &st) != 0) {
+			ThrowErrno("could not stat", path);
+		}
+		using ULL = unsigned long long;
+		if(static_cast<ULL>(st.st_size) > std::numeric_limits<std::size_t>::max())
+		{
+			throw std::length_error{
+				"file \"" + path + "\" is too large to map into memory"
+			};
+		}
+		mSize = static_cast<std::size_t>(st.st_size);
+
+		//	mmap() refuses zero-length mappings, so an empty file simply maps
+		//	onto nothing.
+		if(mSize > 0) {
+			auto p = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd.mFD, 0);
+			if(p == MAP_FAILED) {
+				ThrowErrno("could not map", path);
+			}
+			mData = static_cast<const std::byte*>(p);
+			advise(advice);
+		}
+	}
+	MMapFile::~MMapFile() {
+		if(mData) {
+			::munmap(const_cast<std::byte*>(mData), mSize);
+		}
+	}
+	void MMapFile::advise(
+		unsigned advice, std::size_t offset, std::size_t length
+		) const noexcept
+	{
+		if(!mData || offset >= mSize) {
+			return;
+		}
+		length = std::min(length, mSize - offset);
+		static const auto kPageSize
+			= static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+		auto pad = offset % kPageSize;
+		auto p = const_cast<std::byte*>(mData) + offset - pad;
+		length += pad;
+		if(advice & kAdviseSequential) {
+			::madvise(p, length, MADV_SEQUENTIAL);
+		}
+		if(advice & kAdviseRandom) {
+			::madvise(p, length, MADV_RANDOM);
+		}
+		if(advice & kAdviseWillNeed) {
+			::madvise(p, length, MADV_WILLNEED);
+		}
+	}
+
+ #else
+
+	MMapFile::MMapFile(PrivateTag, const std::string& path, unsigned) {
+		std::ifstream file{path, std::ios::binary | std::ios::ate};
+		if(!file) {
+			throw std::system_error{
+				std::make_error_code(std::errc::no_such_file_or_directory),
+				"could not open \"" + path + '"'
+			};
+		}
+		auto n = static_cast<std::size_t>(file.tellg());
+		mBytes.resize(n);
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(mBytes.data()), n);
+		if(!file) {
+			throw std::system_error{
+				std::make_error_code(std::errc::io_error),
+				"could not read \"" + path + '"'
+			};
+		}
+		mData = mBytes.data();
+		mSize = n;
+	}
+	MMapFile::~MMapFile() = default;
+	void MMapFile::advise(unsigned, std::size_t, std::size_t) const noexcept {
+	}
+
+ #endif
+
+	auto MMapFile::data() const noexcept -> const std::byte* {
+		return mData;
+	}
+	auto MMapFile::size() const noexcept -> std::size_t {
+		return mSize;
+	}
+	auto MMapFile::reader(BorrowMode mode, std::size_t offset) const
+		-> SpanReader
+	{
+		offset = std::min(offset, mSize);
+		return SpanReader{
+			mData + offset, mSize - offset, shared_from_this(), mode
+			};
+	}
+}
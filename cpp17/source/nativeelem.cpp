@@ -0,0 +1,87 @@
+#include "binon/nativeelem.hpp"
+
+#include <sstream>
+
+namespace binon {
+
+	void ThrowNativeElemTrunc() {
+		throw IntTrunc{"BinON integer too large for native element type"};
+	}
+	void CheckNativeElemCode(CodeByte elemCode, CodeByte expected) {
+		if(elemCode != expected) {
+			std::ostringstream oss;
+			oss << "expected BinON typed container elements to have type code ";
+			expected.printRepr(oss);
+			oss << " rather than ";
+			elemCode.printRepr(oss);
+			throw BadElemType{oss.str()};
+		}
+	}
+
+	//---- NativeElem<std::string> ---------------------------------------------
+
+	void NativeElem<std::string>::Encode(
+		const std::string& v, ByteWriter& writer
+		)
+	{
+		UIntObj::EncodeScalar(v.size(), writer);
+		auto p = reinterpret_cast<const std::byte*>(v.data());
+		writer.write(p, v.size());
+	}
+	auto NativeElem<std::string>::Decode(ByteReader& reader) -> std::string {
+		auto n = UIntObj::DecodeSize(reader);
+		reader.checkLength(n);
+		std::string v(n, '\0');
+		reader.read(reinterpret_cast<std::byte*>(v.data()), n);
+		return v;
+	}
+	auto NativeElem<std::string>::EncodedSize(const std::string& v) noexcept
+		-> std::size_t
+	{
+		return UIntObj::EncodedDataSize(v.size()) + v.size();
+	}
+
+	//---- PackNative<bool> ----------------------------------------------------
+
+	PackNative<bool>::PackNative(ByteWriter& writer) noexcept:
+		mWriter{writer},
+		mByte{0x00_byte},
+		mBits{0}
+	{
+	}
+	void PackNative<bool>::operator() (bool v) {
+		mByte <<= 1;
+		if(v) {
+			mByte |= 0x01_byte;
+		}
+		if(++mBits == 8u) {
+			mWriter.put(mByte);
+			mByte = 0x00_byte;
+			mBits = 0;
+		}
+	}
+	void PackNative<bool>::flush() {
+		if(mBits != 0) {
+			mWriter.put(mByte << (8u - mBits));
+			mByte = 0x00_byte;
+			mBits = 0;
+		}
+	}
+
+	//---- UnpackNative<bool> --------------------------------------------------
+
+	UnpackNative<bool>::UnpackNative(ByteReader& reader) noexcept:
+		mReader{reader},
+		mByte{0x00_byte},
+		mBits{0}
+	{
+	}
+	auto UnpackNative<bool>::operator() () -> bool {
+		if(mBits == 0) {
+			mByte = mReader.get();
+			mBits = 8u;
+		}
+		--mBits;
+		return ((mByte >> mBits) & 0x01_byte) != 0x00_byte;
+	}
+}
@@ -0,0 +1,443 @@
+#include "binon/optimalobj.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace binon {
+
+	namespace {
+
+		//	WideCode() maps a type code onto the one its objects widen to when
+		//	unified with objects of the same base type. Other codes map onto
+		//	themselves.
+		auto WideCode(CodeByte cb) noexcept -> CodeByte {
+			if(cb == kUIntCode) {
+				return kIntObjCode;
+			}
+			if(cb == kFloat32Code) {
+				return kFloatObjCode;
+			}
+			return cb;
+		}
+
+		//	FitsFloat32() tells you if v survives a round trip through
+		//	TFloat32 unchanged. (As in the Python version, NaN never does.)
+		auto FitsFloat32(types::TFloat64 v) noexcept -> bool {
+			using TLimits = std::numeric_limits<types::TFloat32>;
+			if(std::isinf(v)) {
+				return true;
+			}
+			if(!(std::fabs(v) <= TLimits::max())) {
+				return false;
+			}
+			auto v32 = static_cast<types::TFloat32>(v);
+			return static_cast<types::TFloat64>(v32) == v;
+		}
+
+		constexpr auto kMaxInt = static_cast<UIntVal::TScalar>(
+			std::numeric_limits<IntVal::TScalar>::max()
+			);
+
+		auto IsGenCtnr(const BinONObj& obj) noexcept -> bool {
+			return std::holds_alternative<ListObj>(obj)
+				|| std::holds_alternative<DictObj>(obj);
+		}
+
+		//	HasDupKeys() tells you if any 2 of the keys held by nodes at the
+		//	given indices are equal. It sorts the indices by key hash and
+		//	compares keys only within runs of equal hashes.
+		auto HasDupKeys(
+			const std::vector<TDict::node_type>& nodes,
+			const std::vector<std::size_t>& indices
+			) -> bool
+		{
+			std::vector<std::pair<std::size_t,std::size_t>> hashed;
+			hashed.reserve(indices.size());
+			for(auto i: indices) {
+				hashed.emplace_back(std::hash<BinONObj>{}(nodes[i].key()), i);
+			}
+			std::sort(hashed.begin(), hashed.end());
+			for(std::size_t i = 0; i < hashed.size(); ++i) {
+				for(auto j = i + 1;
+					j < hashed.size() && hashed[j].first == hashed[i].first;
+					++j)
+				{
+					auto& key = nodes[hashed[i].second].key();
+					if(key == nodes[hashed[j].second].key()) {
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		//	Convert() changes a scalar object into the type given by typeCode.
+		//	It handles the 4 conversions between IntObj and UIntObj or
+		//	FloatObj and Float32Obj that optimizing involves. Since these only
+		//	ever get applied to values that fit, none of them lose anything.
+		//
+		//	Scalar integers, which are by far the most common, get converted
+		//	directly rather than through the IntObj/UIntObj constructors.
+		void Convert(BinONObj& obj, CodeByte typeCode) {
+			switch(typeCode.asUInt()) {
+				case kIntObjCode.asUInt(): {
+					auto& v = std::get<UIntObj>(obj).mValue;
+					if(v.isScalar(kSkipNormalize)) {
+						auto i = v.scalar(kSkipNormalize);
+						if(i <= kMaxInt) {
+							obj.emplace<IntObj>(
+								static_cast<IntVal::TScalar>(i)
+								);
+							break;
+						}
+					}
+					obj = IntObj{std::get<UIntObj>(obj)};
+					break;
+				}
+				case kUIntCode.asUInt(): {
+					auto& v = std::get<IntObj>(obj).mValue;
+					if(v.isScalar(kSkipNormalize)) {
+						obj.emplace<UIntObj>(
+							static_cast<UIntVal::TScalar>(
+								v.scalar(kSkipNormalize)
+								)
+							);
+						break;
+					}
+					obj = UIntObj{std::get<IntObj>(obj)};
+					break;
+				}
+				case kFloatObjCode.asUInt():
+					obj = FloatObj{std::get<Float32Obj>(obj)};
+					break;
+				case kFloat32Code.asUInt():
+					obj = Float32Obj{static_cast<types::TFloat32>(
+						std::get<FloatObj>(obj).mValue
+						)};
+					break;
+			}
+		}
+
+		//	WideDataSize() returns the encodedDataSize() of obj once converted
+		//	to WideCode(obj.typeCode()).
+		auto WideDataSize(const BinONObj& obj) -> std::size_t {
+			if(auto pUInt = std::get_if<UIntObj>(&obj); pUInt) {
+				auto& v = pUInt->mValue;
+				if(v.isScalar()) {
+					auto i = v.scalar(kSkipNormalize);
+					if(i <= kMaxInt) {
+						return IntObj::EncodedDataSize(
+							static_cast<IntVal::TScalar>(i)
+							);
+					}
+				}
+				return IntObj{*pUInt}.encodedDataSize();
+			}
+			if(std::holds_alternative<Float32Obj>(obj)) {
+				return sizeof(types::TFloat64);
+			}
+			return obj.encodedDataSize();
+		}
+
+		//---- ElemUnifier -----------------------------------------------------
+
+		//	You feed an ElemUnifier the elements of a container (or the keys or
+		//	values of a dict) one at a time. elemCode() then tells you the
+		//	element code they could all share in a simple container, or
+		//	kNoObjCode if they cannot share one or would take more space doing
+		//	so than they would as full objects. Otherwise, if widens() is true,
+		//	elements whose type codes differ from elemCode() need to be
+		//	widened with Convert() first.
+		//
+		//	In cheap mode, it only looks at whether the type codes are all the
+		//	same.
+		class ElemUnifier {
+		 public:
+			explicit ElemUnifier(bool cheap) noexcept: mCheap{cheap} {}
+			void operator() (const BinONObj& obj);
+			auto elemCode() const noexcept -> CodeByte;
+			auto widens() const noexcept { return mWiden; }
+
+		 private:
+			bool mCheap;
+			bool mMixed = false;
+			bool mWiden = false;
+			CodeByte mCode = kNoObjCode;
+			std::size_t mCount = 0;
+			std::size_t mFullSize = 0;
+			std::size_t mDataSize = 0;
+			std::size_t mWideSize = 0;
+		};
+		void ElemUnifier::operator() (const BinONObj& obj) {
+			if(mMixed) {
+				return;
+			}
+			auto cb = obj.typeCode();
+			if(mCount++ == 0) {
+				mCode = cb;
+			}
+			else if(cb != mCode) {
+				if(mCheap || WideCode(cb) != WideCode(mCode)) {
+					mMixed = true;
+					return;
+				}
+				mWiden = true;
+			}
+			if(mCheap) {
+				return;
+			}
+
+			//	Containers never need widening, and a simple container of them
+			//	saves exactly the code byte of each one that is not empty. So
+			//	there is no need to size the nonempty ones (which could mean
+			//	walking their entire contents).
+			auto baseType = cb.baseType();
+			if(baseType == kListObjCode.baseType() ||
+				baseType == kDictObjCode.baseType())
+			{
+				auto isEmpty = std::visit(
+					[](auto& ctnr) { return ctnr.hasDefVal(); }, obj
+					);
+				if(!isEmpty) {
+					++mFullSize;
+					return;
+				}
+			}
+			mFullSize += obj.encodedSize();
+			mDataSize += obj.encodedDataSize();
+			mWideSize += WideDataSize(obj);
+		}
+		auto ElemUnifier::elemCode() const noexcept -> CodeByte {
+			if(mMixed || mCount == 0) {
+				return kNoObjCode;
+			}
+			auto code = mWiden ? WideCode(mCode) : mCode;
+			if(mCheap) {
+				return code;
+			}
+			std::size_t packedSize;
+			if(code == kBoolObjCode) {
+				packedSize = (mCount + 7u) >> 3;
+			}
+			else {
+				packedSize = mWiden ? mWideSize : mDataSize;
+			}
+
+			//	The simple container spends 1 byte on the element code.
+			return 1u + packedSize <= mFullSize ? code : kNoObjCode;
+		}
+
+		//---- Optimizer -------------------------------------------------------
+
+		class Optimizer {
+		 public:
+			explicit Optimizer(const OptimizeOpts& opts) noexcept:
+				mOpts{opts} {}
+			void optimize(BinONObj& obj, bool inCtnr);
+
+		 private:
+			const OptimizeOpts& mOpts;
+			std::size_t mDepth = 0;
+
+			void optimizeList(BinONObj& obj, ListObj& listObj);
+			void optimizeDict(BinONObj& obj, DictObj& dictObj);
+			void enter();
+		};
+		void Optimizer::optimize(BinONObj& obj, bool inCtnr) {
+			if(auto p = std::get_if<IntObj>(&obj); p) {
+				auto& v = p->mValue;
+				bool pos;
+				if(v.isScalar()) {
+					auto i = v.scalar(kSkipNormalize);
+					pos = i > 0 || (inCtnr && i == 0);
+				}
+				else {
+					auto& vect = v.vect();
+					pos = !vect.empty() && (vect[0] & 0x80_byte) == 0x00_byte;
+				}
+				if(pos) {
+					Convert(obj, kUIntCode);
+				}
+			}
+			else if(auto p = std::get_if<FloatObj>(&obj); p) {
+				auto v = p->mValue;
+				if((v != 0.0 || inCtnr) && FitsFloat32(v)) {
+					Convert(obj, kFloat32Code);
+				}
+			}
+			else if(auto p = std::get_if<ListObj>(&obj); p) {
+				optimizeList(obj, *p);
+			}
+			else if(auto p = std::get_if<DictObj>(&obj); p) {
+				optimizeDict(obj, *p);
+			}
+		}
+		void Optimizer::optimizeList(BinONObj& obj, ListObj& listObj) {
+			auto& list = listObj.updateValue();
+			if(list.empty()) {
+				return;
+			}
+			enter();
+			bool cheap = list.size() > mOpts.cheapCount;
+			ElemUnifier unify{cheap};
+			for(auto& elem: list) {
+				if(!cheap || IsGenCtnr(elem)) {
+					optimize(elem, true);
+				}
+				unify(elem);
+			}
+			--mDepth;
+			auto elemCode = unify.elemCode();
+			if(elemCode == kNoObjCode) {
+				return;
+			}
+			if(unify.widens()) {
+				for(auto& elem: list) {
+					if(elem.typeCode() != elemCode) {
+						Convert(elem, elemCode);
+					}
+				}
+			}
+			obj = SList{std::move(list), elemCode};
+		}
+		void Optimizer::optimizeDict(BinONObj& obj, DictObj& dictObj) {
+			auto& dict = dictObj.updateValue();
+			if(dict.empty()) {
+				return;
+			}
+			enter();
+			bool cheap = dict.size() > mOpts.cheapCount;
+			ElemUnifier unifyKeys{cheap}, unifyVals{cheap};
+			auto keyCode = kNoObjCode;
+			if(cheap) {
+				for(auto& [key, val]: dict) {
+					if(IsGenCtnr(val)) {
+						optimize(val, true);
+					}
+					unifyKeys(key);
+					unifyVals(val);
+				}
+				keyCode = unifyKeys.elemCode();
+			}
+			else {
+				//	If the keys mix IntObj with UIntObj or FloatObj with
+				//	Float32Obj, leave them alone. Otherwise, converting
+				//	scalar keys cannot make 2 of them equal, and they can be
+				//	optimized like list elements. That means taking the
+				//	nodes out of the map, since keys are const while inside
+				//	it.
+				//
+				//	Container keys are another matter, since the scalars
+				//	nested within them get converted independently. So
+				//	those keys get copied before optimizing, and if any 2 of
+				//	them wind up equal, the copies go back in and the dict
+				//	stays a DictObj.
+				bool hasInt = false, hasUInt = false;
+				bool hasFloat = false, hasFloat32 = false;
+				for(auto& pair: dict) {
+					switch(pair.first.typeCode().asUInt()) {
+						case kIntObjCode.asUInt(): hasInt = true; break;
+						case kUIntCode.asUInt(): hasUInt = true; break;
+						case kFloatObjCode.asUInt(): hasFloat = true; break;
+						case kFloat32Code.asUInt(): hasFloat32 = true; break;
+					}
+				}
+				bool keepKeys =
+					(hasInt && hasUInt) || (hasFloat && hasFloat32);
+				std::vector<TDict::node_type> nodes;
+				nodes.reserve(dict.size());
+				while(!dict.empty()) {
+					nodes.push_back(dict.extract(dict.begin()));
+				}
+				std::vector<std::size_t> ctnrKeys;
+				std::vector<BinONObj> origKeys;
+				for(std::size_t i = 0; i < nodes.size(); ++i) {
+					auto& node = nodes[i];
+					if(!keepKeys) {
+						if(IsGenCtnr(node.key())) {
+							ctnrKeys.push_back(i);
+							origKeys.push_back(node.key());
+						}
+						optimize(node.key(), true);
+						unifyKeys(node.key());
+					}
+					optimize(node.mapped(), true);
+					unifyVals(node.mapped());
+				}
+				if(ctnrKeys.size() > 1u && HasDupKeys(nodes, ctnrKeys)) {
+					for(std::size_t i = 0; i < ctnrKeys.size(); ++i) {
+						nodes[ctnrKeys[i]].key() = std::move(origKeys[i]);
+					}
+					keepKeys = true;
+				}
+				if(!keepKeys) {
+					keyCode = unifyKeys.elemCode();
+				}
+				for(auto& node: nodes) {
+					if(keyCode != kNoObjCode &&
+						node.key().typeCode() != keyCode)
+					{
+						Convert(node.key(), keyCode);
+					}
+					dict.insert(std::move(node));
+				}
+			}
+			--mDepth;
+			if(keyCode == kNoObjCode) {
+				return;
+			}
+			auto valCode = unifyVals.elemCode();
+			if(valCode == kNoObjCode) {
+				obj = SKDict{std::move(dict), keyCode};
+				return;
+			}
+			if(unifyVals.widens()) {
+				for(auto& pair: dict) {
+					if(pair.second.typeCode() != valCode) {
+						Convert(pair.second, valCode);
+					}
+				}
+			}
+			obj = SDict{std::move(dict), keyCode, valCode};
+		}
+		void Optimizer::enter() {
+			if(mDepth >= mOpts.maxDepth) {
+				throw DepthErr{
+					"BinON containers nested too deeply to optimize"
+				};
+			}
+			++mDepth;
+		}
+	}
+
+	//---- OptimalObj ----------------------------------------------------------
+
+	auto OptimalObj(const BinONObj& obj, const OptimizeOpts& opts)
+		-> BinONObj
+	{
+		BinONObj copy = obj;
+		return OptimalObj(std::move(copy), opts);
+	}
+	auto OptimalObj(BinONObj&& obj, const OptimizeOpts& opts) -> BinONObj {
+		Optimizer{opts}.optimize(obj, false);
+		return std::move(obj);
+	}
+	void EncodeOptimal(
+		const BinONObj& obj, ByteWriter& writer, const OptimizeOpts& opts
+		)
+	{
+		OptimalObj(obj, opts).encode(writer);
+	}
+	void EncodeOptimal(
+		const BinONObj& obj, TOStream& stream, bool requireIO,
+		const OptimizeOpts& opts
+		)
+	{
+		StreamWriter writer{stream, requireIO};
+		EncodeOptimal(obj, writer, opts);
+		writer.flush();
+	}
+}
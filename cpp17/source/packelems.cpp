@@ -1,24 +1,25 @@
 #include "binon/packelems.hpp"
+#include "binon/varint.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
+#include <type_traits>
 
 namespace binon {
 
-	//---- PackElems -----------------------------------------------------------
+	namespace {
 
-	PackElems::PackElems(CodeByte elemCode, TOStream& stream):
-		mElemCode{elemCode},
-		mStream{stream},
-		mByte{0x00_byte},
-		mIndex{0}
-	{
-	}
-	void PackElems::operator() (const BinONObj& varObj, bool requireIO) {
-		RequireIO rio{mStream, requireIO};
-		if(varObj.typeCode() != mElemCode) {
+		[[noreturn]] void ThrowBadElemType(
+			CodeByte elemCode, std::size_t index, const BinONObj& varObj
+			)
+		{
 			std::ostringstream oss;
-			oss << "expected BinON container element " << mIndex
+			oss << "expected BinON container element " << index
 				<< " to have type code ";
-			mElemCode.printRepr(oss);
+			elemCode.printRepr(oss);
 			oss << " rather than ";
 			varObj.typeCode().printRepr(oss);
 			oss << " (object: ";
@@ -26,6 +27,288 @@ namespace binon {
 			oss << ")";
 			throw BadElemType{oss.str()};
 		}
+
+		//	ElemAs() returns element i of a run as an Obj, after checking
+		//	that it is one.
+		template<typename Obj>
+			auto ElemAs(const BinONObj& varObj, std::size_t i) -> const Obj& {
+				auto pObj = std::get_if<Obj>(&varObj);
+				if(!pObj) {
+					ThrowBadElemType(Obj::kTypeCode, i, varObj);
+				}
+				return *pObj;
+			}
+
+		//---- Byte order helpers ----------------------------------------------
+
+		//	StoreBig() and LoadBig() store and load an unsigned integer in
+		//	big-endian order. The kernels look up LittleEndian() once per run
+		//	and pass it in as swap, since it may not be constexpr.
+		template<typename U>
+			void StoreBig(U u, std::byte* p, bool swap) noexcept {
+				if(swap) {
+					u = SwapBytes(u);
+				}
+				std::memcpy(p, &u, sizeof u);
+			}
+		template<typename U>
+			auto LoadBig(const std::byte* p, bool swap) noexcept -> U {
+				U u;
+				std::memcpy(&u, p, sizeof u);
+				return swap ? SwapBytes(u) : u;
+			}
+
+		//	TFloatBits is the unsigned integer type with the same size as a
+		//	floating-point type.
+		template<typename Flt>
+			using TFloatBits = std::conditional_t<
+				sizeof(Flt) == 4, std::uint32_t, std::uint64_t
+				>;
+
+		//---- Pack kernels ----------------------------------------------------
+		//
+		//	Each kernel packs n elements starting at it, where proj maps
+		//	whatever it points to (a BinONObj or a TDict entry) to the
+		//	element itself.
+
+		template<typename It, typename Proj>
+			void PackNulls(It it, std::size_t n, Proj proj) {
+				for(std::size_t i = 0; i < n; ++i, ++it) {
+					ElemAs<NullObj>(proj(*it), i);
+				}
+			}
+		template<typename It, typename Proj>
+			void PackBools(It it, std::size_t n, Proj proj, ByteWriter& writer)
+		{
+			bool swap = LittleEndian();
+			for(std::size_t i = 0; i < n;) {
+				auto m = std::min<std::size_t>(n - i, 64u);
+				std::uint64_t word = 0;
+				for(auto end = i + m; i < end; ++i, ++it) {
+					word <<= 1;
+					word |= ElemAs<BoolObj>(proj(*it), i).mValue ? 1u : 0u;
+				}
+				if(m == 64u) {
+					StoreBig(word, writer.prepare(8u), swap);
+					writer.advance(8u);
+				}
+				else {
+					std::array<std::byte,8> buf;
+					StoreBig(word << (64u - m), buf.data(), swap);
+					writer.write(buf.data(), (m + 7u) >> 3);
+				}
+			}
+		}
+		template<typename Obj, typename It, typename Proj>
+			void PackFloats(It it, std::size_t n, Proj proj, ByteWriter& writer)
+		{
+			using TBits = TFloatBits<typename Obj::TValue>;
+			constexpr std::size_t kChunk = kStreamBufSize / sizeof(TBits);
+			bool swap = LittleEndian();
+			for(std::size_t i = 0; i < n;) {
+				auto m = std::min(n - i, kChunk);
+				auto p = writer.prepare(m * sizeof(TBits));
+				for(auto end = i + m; i < end; ++i, ++it) {
+					auto v = ElemAs<Obj>(proj(*it), i).mValue;
+					TBits u;
+					std::memcpy(&u, &v, sizeof u);
+					StoreBig(u, p, swap);
+					p += sizeof u;
+				}
+				writer.advance(m * sizeof(TBits));
+			}
+		}
+		template<typename Obj, typename It, typename Proj>
+			void PackObjs(It it, std::size_t n, Proj proj, ByteWriter& writer)
+		{
+			for(std::size_t i = 0; i < n; ++i, ++it) {
+				ElemAs<Obj>(proj(*it), i).encodeData(writer);
+			}
+		}
+		template<typename Obj, typename It, typename Proj>
+			void PackInts(It it, std::size_t n, Proj proj, ByteWriter& writer)
+		{
+			//	Scalars are gathered into buf and written in bulk, except that
+			//	an integer in vector form is left to encodeData().
+			using TScalar = typename Obj::TValue::TScalar;
+			constexpr std::size_t kChunk = 0x100;
+			std::array<TScalar,kChunk> buf;
+			for(std::size_t i = 0; i < n;) {
+				std::size_t m = 0;
+				const Obj* pVect = nullptr;
+				for(; i < n && m < kChunk; ++i, ++it) {
+					auto& obj = ElemAs<Obj>(proj(*it), i);
+					auto pScalar = std::get_if<TScalar>(&obj.mValue);
+					if(!pScalar) {
+						pVect = &obj;
+						break;
+					}
+					buf[m++] = *pScalar;
+				}
+				if constexpr(std::is_same_v<Obj,IntObj>) {
+					WriteIntVarints(buf.data(), m, writer);
+				}
+				else {
+					WriteUIntVarints(buf.data(), m, writer);
+				}
+				if(pVect) {
+					pVect->encodeData(writer);
+					++i;
+					++it;
+				}
+			}
+		}
+		template<typename It, typename Proj>
+			void PackAny(
+				CodeByte elemCode, It it, std::size_t n, Proj proj,
+				ByteWriter& writer
+				)
+		{
+			PackElems pack{elemCode, writer};
+			for(; n > 0; --n, ++it) {
+				pack(proj(*it));
+			}
+			pack.flush();
+		}
+		template<typename It, typename Proj>
+			void Pack(
+				CodeByte elemCode, It it, std::size_t n, Proj proj,
+				ByteWriter& writer
+				)
+		{
+			switch(elemCode.asUInt()) {
+				case kNullObjCode.asUInt():
+					PackNulls(it, n, proj);
+					break;
+				case kBoolObjCode.asUInt():
+					PackBools(it, n, proj, writer);
+					break;
+				case kIntObjCode.asUInt():
+					PackInts<IntObj>(it, n, proj, writer);
+					break;
+				case kUIntCode.asUInt():
+					PackInts<UIntObj>(it, n, proj, writer);
+					break;
+				case kFloatObjCode.asUInt():
+					PackFloats<FloatObj>(it, n, proj, writer);
+					break;
+				case kFloat32Code.asUInt():
+					PackFloats<Float32Obj>(it, n, proj, writer);
+					break;
+				case kBufferObjCode.asUInt():
+					PackObjs<BufferObj>(it, n, proj, writer);
+					break;
+				case kStrObjCode.asUInt():
+					PackObjs<StrObj>(it, n, proj, writer);
+					break;
+				default:
+					PackAny(elemCode, it, n, proj, writer);
+			}
+		}
+
+		//---- Unpack kernels --------------------------------------------------
+
+		void UnpackBools(std::size_t n, TList& list, ByteReader& reader) {
+			std::array<std::byte,kStreamBufSize> buf;
+			bool swap = LittleEndian();
+			while(n > 0) {
+				auto nBits = std::min(n, kStreamBufSize * 8u);
+				auto nBytes = (nBits + 7u) >> 3;
+				reader.read(buf.data(), nBytes);
+				std::fill(buf.begin() + nBytes, buf.end(), 0x00_byte);
+				n -= nBits;
+				for(auto p = buf.data(); nBits > 0; p += 8) {
+					auto word = LoadBig<std::uint64_t>(p, swap);
+					auto m = std::min<std::size_t>(nBits, 64u);
+					nBits -= m;
+					for(; m > 0; --m, word <<= 1) {
+						list.emplace_back(
+							std::in_place_type<BoolObj>, (word >> 63) != 0u
+							);
+					}
+				}
+			}
+		}
+		template<typename Obj>
+			void UnpackFloats(std::size_t n, TList& list, ByteReader& reader)
+		{
+			using TValue = typename Obj::TValue;
+			using TBits = TFloatBits<TValue>;
+			constexpr std::size_t kChunk = kStreamBufSize / sizeof(TBits);
+			std::array<std::byte,kStreamBufSize> buf;
+			bool swap = LittleEndian();
+			while(n > 0) {
+				auto m = std::min(n, kChunk);
+				reader.read(buf.data(), m * sizeof(TBits));
+				for(auto p = buf.data(), end = p + m * sizeof(TBits);
+					p != end; p += sizeof(TBits))
+				{
+					auto u = LoadBig<TBits>(p, swap);
+					TValue v;
+					std::memcpy(&v, &u, sizeof v);
+					list.emplace_back(std::in_place_type<Obj>, v);
+				}
+				n -= m;
+			}
+		}
+		template<typename Obj>
+			void UnpackObjs(std::size_t n, TList& list, ByteReader& reader) {
+				for(; n > 0; --n) {
+					auto& varObj = list.emplace_back(std::in_place_type<Obj>);
+					std::get_if<Obj>(&varObj)->decodeData(reader);
+				}
+			}
+		template<typename Obj>
+			void UnpackInts(std::size_t n, TList& list, ByteReader& reader) {
+				ReadVarintRun<typename Obj::TValue::TScalar>(
+					reader, n,
+					[&list](auto v) {
+						list.emplace_back(std::in_place_type<Obj>, v);
+					},
+					[&list, &reader] { UnpackObjs<Obj>(1, list, reader); }
+					);
+			}
+		void UnpackAny(
+			CodeByte elemCode, std::size_t n, TList& list, ByteReader& reader
+			)
+		{
+			UnpackElems unpack{elemCode, reader};
+			for(; n > 0; --n) {
+				list.push_back(unpack());
+			}
+		}
+	}
+
+	//---- PackElems -----------------------------------------------------------
+
+	PackElems::PackElems(CodeByte elemCode, ByteWriter& writer):
+		mElemCode{elemCode},
+		mWriter{writer},
+		mByte{0x00_byte},
+		mIndex{0}
+	{
+	}
+	PackElems::PackElems(
+		CodeByte elemCode, TOStream& stream, bool requireIO
+		):
+		mStreamWriter{std::make_unique<StreamWriter>(stream, requireIO)},
+		mElemCode{elemCode},
+		mWriter{*mStreamWriter},
+		mByte{0x00_byte},
+		mIndex{0}
+	{
+	}
+	PackElems::~PackElems() {
+		if(mStreamWriter) {
+			try {
+				flush();
+			}
+			catch(...) {
+			}
+		}
+	}
+	void PackElems::operator() (const BinONObj& varObj) {
+		checkType(varObj);
 		if(mElemCode == kBoolObjCode) {
 			auto v = std::get<BoolObj>(varObj).mValue;
 			mByte <<= 1;
@@ -33,49 +316,175 @@ namespace binon {
 				mByte |= 0x01_byte;
 			}
 			if((++mIndex & 0x7u) == 0x0u) {
-				BytePack(mByte, mStream, kSkipRequireIO);
+				mWriter.put(mByte);
 				mByte = 0x00_byte;
 			}
 		}
 		else {
-			varObj.encodeData(mStream, kSkipRequireIO);
+			varObj.encodeData(mWriter);
 			++mIndex;
 		}
 	}
-	PackElems::~PackElems() {
+	void PackElems::flush() {
 		if(mElemCode == kBoolObjCode) {
 			auto n = mIndex & 0x7u;
 			if(n != 0x0u) {
-				BytePack(mByte << (0x8u - n), mStream);
+				mWriter.put(mByte << (0x8u - n));
+				mIndex += 0x8u - n;
+				mByte = 0x00_byte;
 			}
 		}
 	}
+	void PackElems::expect(const BinONObj& varObj) {
+		checkType(varObj);
+		++mIndex;
+	}
+	void PackElems::checkType(const BinONObj& varObj) const {
+		if(varObj.typeCode() != mElemCode) {
+			ThrowBadElemType(mElemCode, mIndex, varObj);
+		}
+	}
+
+	//---- PackedSize ----------------------------------------------------------
+
+	PackedSize::PackedSize(CodeByte elemCode) noexcept:
+		mElemCode{elemCode},
+		mSize{0},
+		mIndex{0}
+	{
+	}
+	void PackedSize::operator() (const BinONObj& varObj) {
+		if(mElemCode != kBoolObjCode) {
+			mSize += varObj.encodedDataSize();
+		}
+		++mIndex;
+	}
+	auto PackedSize::size() const noexcept -> std::size_t {
+		return mElemCode == kBoolObjCode ? (mIndex + 7u) >> 3 : mSize;
+	}
 
 	//---- UnpackElems ---------------------------------------------------------
 
-	UnpackElems::UnpackElems(CodeByte elemCode, TIStream& stream):
+	UnpackElems::UnpackElems(CodeByte elemCode, ByteReader& reader):
 		mElemCode{elemCode},
-		mStream{stream},
+		mReader{reader},
 		mByte{0x00_byte},
 		mIndex{0}
 	{
 	}
-	auto UnpackElems::operator() (bool requireIO) -> BinONObj {
-		RequireIO rio{mStream, requireIO};
+	auto UnpackElems::operator() () -> BinONObj {
 		if(mElemCode == kBoolObjCode) {
-			if((mIndex & 0x7u) == 0x0) {
-				mByte = ByteUnpack<std::byte>(mStream, kSkipRequireIO);
-			}
-			BoolObj boolObj{(mByte & 0x80_byte) != 0x00_byte};
-			mByte <<= 1;
-			++mIndex;
-			return boolObj;
+			return BoolObj{unpackBool()};
 		}
 		else {
 			auto varObj{BinONObj::FromTypeCode(mElemCode)};
-			varObj.decodeData(mStream, kSkipRequireIO);
+			varObj.decodeData(mReader);
 			++mIndex;
 			return varObj;
 		}
 	}
+	auto UnpackElems::unpackBool() -> bool {
+		if((mIndex & 0x7u) == 0x0) {
+			mByte = mReader.get();
+		}
+		bool v = (mByte & 0x80_byte) != 0x00_byte;
+		mByte <<= 1;
+		++mIndex;
+		return v;
+	}
+
+	//---- PackRun / UnpackRun -------------------------------------------------
+
+	void PackRun(CodeByte elemCode, const TList& list, ByteWriter& writer) {
+		Pack(
+			elemCode, list.begin(), list.size(),
+			[](const BinONObj& elem) -> auto& { return elem; }, writer
+			);
+	}
+	void PackKeys(CodeByte keyCode, const TDict& dict, ByteWriter& writer) {
+		Pack(
+			keyCode, dict.begin(), dict.size(),
+			[](const TDict::value_type& pair) -> auto& { return pair.first; },
+			writer
+			);
+	}
+	void PackValues(CodeByte valCode, const TDict& dict, ByteWriter& writer) {
+		Pack(
+			valCode, dict.begin(), dict.size(),
+			[](const TDict::value_type& pair) -> auto& { return pair.second; },
+			writer
+			);
+	}
+	void UnpackRun(
+		CodeByte elemCode, std::size_t n, TList& list, ByteReader& reader
+		)
+	{
+		list.reserve(list.size() + std::min(n, kMaxReserve));
+		switch(elemCode.asUInt()) {
+			case kNullObjCode.asUInt():
+				while(n-->0) {
+					list.emplace_back();
+				}
+				break;
+			case kBoolObjCode.asUInt():
+				UnpackBools(n, list, reader);
+				break;
+			case kIntObjCode.asUInt():
+				UnpackInts<IntObj>(n, list, reader);
+				break;
+			case kUIntCode.asUInt():
+				UnpackInts<UIntObj>(n, list, reader);
+				break;
+			case kFloatObjCode.asUInt():
+				UnpackFloats<FloatObj>(n, list, reader);
+				break;
+			case kFloat32Code.asUInt():
+				UnpackFloats<Float32Obj>(n, list, reader);
+				break;
+			case kBufferObjCode.asUInt():
+				UnpackObjs<BufferObj>(n, list, reader);
+				break;
+			case kStrObjCode.asUInt():
+				UnpackObjs<StrObj>(n, list, reader);
+				break;
+			default:
+				UnpackAny(elemCode, n, list, reader);
+		}
+	}
+
+	//---- CheckElemCount ------------------------------------------------------
+
+	void CheckElemCount(
+		std::size_t count, CodeByte elemCode, ByteReader& reader
+		)
+	{
+		if(count > reader.context().maxCount) {
+			throw LimitErr{
+				"BinON container size exceeds CodecContext::maxCount"
+			};
+		}
+
+		//	Work out the fewest bits each element could occupy: a code byte
+		//	for full objects or the data size for simple container elements.
+		//	(Null elements have no data at all, so the remaining input cannot
+		//	bound them, and the reader's running null count does instead.)
+		std::size_t bits = 8;
+		switch(elemCode.asUInt()) {
+			case kNullObjCode.asUInt():
+				reader.checkNulls(count);
+				return;
+			case kBoolObjCode.asUInt():
+				bits = 1;
+				break;
+			case kFloatObjCode.asUInt():
+				bits = 64;
+				break;
+			case kFloat32Code.asUInt():
+				bits = 32;
+				break;
+		}
+		reader.checkAvail(
+			count > (kNoLimit - 7) / bits ? kNoLimit : (count * bits + 7) / 8
+			);
+	}
 }
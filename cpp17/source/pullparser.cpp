@@ -0,0 +1,303 @@
+#include "binon/pullparser.hpp"
+#include "binon/skipobj.hpp"
+
+#include <algorithm>
+
+namespace binon {
+
+	//---- Token ---------------------------------------------------------------
+
+	auto Token::str() const noexcept -> HyStr::TView {
+		if(!mData) {
+			return {};
+		}
+		return {reinterpret_cast<const HyStr::TChr*>(mData), mCount};
+	}
+	auto Token::buffer() const noexcept -> BufferVal::TView {
+		if(!mData) {
+			return {};
+		}
+		return {mData, mCount};
+	}
+
+	//---- PullParser ----------------------------------------------------------
+
+	PullParser::PullParser(ByteReader& reader):
+		mReader{reader},
+		mOldMode{reader.borrowMode()}
+	{
+		if(mOldMode == BorrowMode::kCopy) {
+			mReader.setBorrowMode(BorrowMode::kView);
+		}
+		mFrames.reserve(std::min(reader.context().maxDepth, kDefMaxDepth));
+	}
+	PullParser::~PullParser() {
+		if(mOldMode == BorrowMode::kCopy) {
+			mReader.setBorrowMode(BorrowMode::kCopy);
+		}
+	}
+	auto PullParser::next() -> const Token& {
+		if(mPending) {
+			mReader.skip(mPending);
+			mPending = 0;
+		}
+		mToken = Token{};
+		if(mDepth == 0) {
+			if(mFinished) {
+				mFinished = false;
+			}
+			else {
+				parseObj(CodeByte::Read(mReader));
+				mFinished = mDepth == 0;
+			}
+			return mToken;
+		}
+		auto& frame = mFrames[mDepth - 1];
+		if(frame.mLeft == 0) {
+			endFrame();
+		}
+		else {
+			--frame.mLeft;
+			if(frame.mElemCode == kNoObjCode) {
+				parseObj(CodeByte::Read(mReader));
+			}
+			else if(frame.mElemCode == kBoolObjCode) {
+				mToken.mType = TokenType::kBool;
+				mToken.mTypeCode = kBoolObjCode;
+				mToken.mBool = frame.mUnpack->unpackBool();
+			}
+			else {
+				parseData(frame.mElemCode);
+			}
+		}
+		return mToken;
+	}
+	auto PullParser::token() const noexcept -> const Token& {
+		return mToken;
+	}
+	auto PullParser::depth() const noexcept -> std::size_t {
+		return mDepth;
+	}
+	auto PullParser::read(std::byte* p, std::size_t n) -> std::size_t {
+		n = std::min(n, mPending);
+		mReader.read(p, n);
+		mPending -= n;
+		return n;
+	}
+	auto PullParser::skipCtnr() -> const Token& {
+		if(mDepth == 0) {
+			return mToken;
+		}
+		auto& frame = mFrames[mDepth - 1];
+		if(frame.mLeft == frame.mCount) {
+
+			//	Nothing in the current run of elements (or keys or values) has
+			//	been parsed yet, so the rest of the container can be skipped
+			//	without tokenizing it.
+			skipLeft(frame);
+			if(frame.mInKeys) {
+				endFrame();
+				skipLeft(frame);
+			}
+			mToken = Token{};
+			endFrame();
+			return mToken;
+		}
+		auto outer = mDepth - 1;
+		for(;;) {
+			auto& token = next();
+			if(mDepth == outer && (
+				token.mType == TokenType::kListEnd ||
+				token.mType == TokenType::kDictEnd))
+			{
+				return token;
+			}
+		}
+	}
+	auto PullParser::readCount() -> std::size_t {
+		return UIntObj::DecodeSize(mReader);
+	}
+	void PullParser::skipLeft(Frame& frame) {
+		if(frame.mElemCode == kNoObjCode) {
+			for(auto n = frame.mLeft; n-->0;) {
+				SkipObj(mReader);
+			}
+		}
+		else {
+			SkipElems(frame.mElemCode, frame.mLeft, mReader);
+		}
+		frame.mLeft = 0;
+	}
+	void PullParser::readBytes(TokenType type, std::size_t n) {
+		mToken.mType = type;
+		mToken.mCount = n;
+		mToken.mData = mReader.borrow(n);
+		if(!mToken.mData) {
+			mPending = n;
+		}
+	}
+	void PullParser::parseObj(CodeByte cb) {
+		if(cb == kTrueObjCode) {
+			mToken.mType = TokenType::kBool;
+			mToken.mTypeCode = kBoolObjCode;
+			mToken.mBool = true;
+		}
+		else if(cb.subtype() != Subtype::kDefault) {
+			parseData(cb);
+		}
+		else {
+			auto typeCode = cb.typeCode();
+			mToken.mTypeCode = typeCode;
+			switch(typeCode.asUInt()) {
+				case kNullObjCode.asUInt():
+					mToken.mType = TokenType::kNull;
+					break;
+				case kBoolObjCode.asUInt():
+					mToken.mType = TokenType::kBool;
+					break;
+				case kIntObjCode.asUInt():
+					mToken.mType = TokenType::kInt;
+					break;
+				case kUIntCode.asUInt():
+					mToken.mType = TokenType::kUInt;
+					break;
+				case kFloatObjCode.asUInt():
+					mToken.mType = TokenType::kFloat;
+					break;
+				case kFloat32Code.asUInt():
+					mToken.mType = TokenType::kFloat32;
+					break;
+				case kBufferObjCode.asUInt():
+					mToken.mType = TokenType::kBuffer;
+					break;
+				case kStrObjCode.asUInt():
+					mToken.mType = TokenType::kStr;
+					break;
+				case kListObjCode.asUInt():
+				case kSListCode.asUInt():
+				case kDictObjCode.asUInt():
+				case kSKDictCode.asUInt():
+				case kSDictCode.asUInt():
+					pushFrame(typeCode, 0, kNoObjCode, false);
+					break;
+				default:
+					throw BadCodeByte{cb};
+			}
+		}
+	}
+	void PullParser::parseData(CodeByte typeCode) {
+		mToken.mTypeCode = typeCode;
+		switch(typeCode.asUInt()) {
+			case kNullObjCode.asUInt():
+				mToken.mType = TokenType::kNull;
+				break;
+			case kBoolObjCode.asUInt():
+				mToken.mType = TokenType::kBool;
+				mToken.mBool = mReader.get() != 0x00_byte;
+				break;
+			case kIntObjCode.asUInt(): {
+				auto byte0 = mReader.get();
+				if(byte0 == 0xf1_byte) {
+					readBytes(TokenType::kBigInt, readCount());
+				}
+				else {
+					mToken.mType = TokenType::kInt;
+					mToken.mInt = IntObj::DecodeScalar(byte0, mReader);
+				}
+				break;
+			}
+			case kUIntCode.asUInt(): {
+				auto byte0 = mReader.get();
+				if(byte0 == 0xf1_byte) {
+					readBytes(TokenType::kBigUInt, readCount());
+				}
+				else {
+					mToken.mType = TokenType::kUInt;
+					mToken.mUInt = UIntObj::DecodeScalar(byte0, mReader);
+				}
+				break;
+			}
+			case kFloatObjCode.asUInt():
+				mToken.mType = TokenType::kFloat;
+				mToken.mFloat = ByteUnpack<types::TFloat64>(mReader);
+				break;
+			case kFloat32Code.asUInt():
+				mToken.mType = TokenType::kFloat32;
+				mToken.mFloat = ByteUnpack<types::TFloat32>(mReader);
+				break;
+			case kBufferObjCode.asUInt():
+				readBytes(TokenType::kBuffer, readCount());
+				break;
+			case kStrObjCode.asUInt():
+				readBytes(TokenType::kStr, readCount());
+				break;
+			case kListObjCode.asUInt():
+			case kDictObjCode.asUInt():
+				pushFrame(typeCode, readCount(), kNoObjCode, true);
+				break;
+			case kSListCode.asUInt():
+			case kSKDictCode.asUInt():
+			case kSDictCode.asUInt(): {
+				auto n = readCount();
+				pushFrame(typeCode, n, CodeByte::Read(mReader), true);
+				break;
+			}
+			default:
+				throw BadCodeByte{typeCode};
+		}
+	}
+	void PullParser::pushFrame(
+		CodeByte typeCode, std::size_t count, CodeByte elemCode, bool hasData
+		)
+	{
+		if(mDepth >= mReader.context().maxDepth) {
+			throw DepthErr{"BinON containers nested too deeply for PullParser"};
+		}
+		if(mDepth == mFrames.size()) {
+			mFrames.emplace_back();
+		}
+		auto& frame = mFrames[mDepth++];
+		frame.mTypeCode = typeCode;
+		frame.mElemCode = elemCode;
+		frame.mCount = frame.mLeft = count;
+		frame.mInKeys = typeCode.baseType() == kDictObjCode.baseType();
+		frame.mHasData = hasData;
+		if(elemCode == kBoolObjCode) {
+			frame.mUnpack.emplace(elemCode, mReader);
+		}
+		else {
+			frame.mUnpack.reset();
+		}
+		mToken.mType = frame.mInKeys ?
+			TokenType::kDictKeysBegin : TokenType::kListBegin;
+		mToken.mTypeCode = typeCode;
+		mToken.mElemCode = elemCode;
+		mToken.mCount = count;
+	}
+	void PullParser::endFrame() {
+		auto& frame = mFrames[mDepth - 1];
+		mToken.mTypeCode = frame.mTypeCode;
+		if(frame.mInKeys) {
+			frame.mInKeys = false;
+			frame.mLeft = frame.mCount;
+			frame.mElemCode = frame.mTypeCode == kSDictCode && frame.mHasData
+				? CodeByte::Read(mReader) : kNoObjCode;
+			if(frame.mElemCode == kBoolObjCode) {
+				frame.mUnpack.emplace(frame.mElemCode, mReader);
+			}
+			else {
+				frame.mUnpack.reset();
+			}
+			mToken.mType = TokenType::kDictValuesBegin;
+			mToken.mElemCode = frame.mElemCode;
+			mToken.mCount = frame.mCount;
+		}
+		else {
+			mToken.mType =
+				frame.mTypeCode.baseType() == kDictObjCode.baseType() ?
+				TokenType::kDictEnd : TokenType::kListEnd;
+			frame.mUnpack.reset();
+			mFinished = --mDepth == 0;
+		}
+	}
+}
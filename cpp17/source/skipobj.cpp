@@ -0,0 +1,197 @@
+#include "binon/skipobj.hpp"
+
+#include <limits>
+
+namespace binon {
+
+	//---- Local functions -----------------------------------------------------
+
+	static void SkipObjAt(ByteReader& reader, std::size_t depth);
+	static void SkipDataAt(
+		CodeByte typeCode, ByteReader& reader, std::size_t depth
+		);
+	static void SkipElemsAt(
+		CodeByte elemCode, std::size_t n, ByteReader& reader, std::size_t depth
+		);
+
+	static void EnterCtnr(const ByteReader& reader, std::size_t depth) {
+		if(depth >= reader.context().maxDepth) {
+			throw DepthErr{"BinON containers nested too deeply to skip"};
+		}
+	}
+	static void SkipFixed(
+		std::size_t n, std::size_t elemSize, ByteReader& reader
+		)
+	{
+		if(n > std::numeric_limits<std::size_t>::max() / elemSize) {
+			throw BufOverrun{"BinON simple container size is out of range"};
+		}
+		reader.skip(n * elemSize);
+	}
+	static void SkipInt(ByteReader& reader) {
+
+		//	The leading bits of the first byte determine how many more bytes
+		//	follow (see IntObj::decodeData()).
+		auto byte0 = reader.get();
+		if((byte0 & 0x80_byte) == 0x00_byte) {
+			return;
+		}
+		if((byte0 & 0x40_byte) == 0x00_byte) {
+			reader.skip(1);
+		}
+		else if((byte0 & 0x20_byte) == 0x00_byte) {
+			reader.skip(3);
+		}
+		else if((byte0 & 0x10_byte) == 0x00_byte) {
+			reader.skip(7);
+		}
+		else if(byte0 == 0xf1_byte) {
+			reader.skip(UIntObj::DecodeSize(reader));
+		}
+		else {
+			reader.skip(8);
+		}
+	}
+	static void SkipObjAt(ByteReader& reader, std::size_t depth) {
+		auto cb = CodeByte::Read(reader);
+		if(cb.subtype() == Subtype::kDefault || cb == kTrueObjCode) {
+			return;
+		}
+		SkipDataAt(cb, reader, depth);
+	}
+	static void SkipDataAt(
+		CodeByte typeCode, ByteReader& reader, std::size_t depth
+		)
+	{
+		switch(typeCode.asUInt()) {
+			case kNullObjCode.asUInt():
+				break;
+			case kBoolObjCode.asUInt():
+				reader.skip(1);
+				break;
+			case kIntObjCode.asUInt():
+			case kUIntCode.asUInt():
+				SkipInt(reader);
+				break;
+			case kFloatObjCode.asUInt():
+				reader.skip(sizeof(types::TFloat64));
+				break;
+			case kFloat32Code.asUInt():
+				reader.skip(sizeof(types::TFloat32));
+				break;
+			case kBufferObjCode.asUInt():
+			case kStrObjCode.asUInt():
+				reader.skip(UIntObj::DecodeSize(reader));
+				break;
+			case kListObjCode.asUInt(): {
+				EnterCtnr(reader, depth);
+				auto n = UIntObj::DecodeSize(reader);
+				while(n-->0) {
+					SkipObjAt(reader, depth + 1);
+				}
+				break;
+			}
+			case kSListCode.asUInt(): {
+				EnterCtnr(reader, depth);
+				auto n = UIntObj::DecodeSize(reader);
+				auto elemCode = CodeByte::Read(reader);
+				SkipElemsAt(elemCode, n, reader, depth + 1);
+				break;
+			}
+			case kDictObjCode.asUInt(): {
+				EnterCtnr(reader, depth);
+				auto n = UIntObj::DecodeSize(reader);
+				for(auto i = 0; i < 2; ++i) {
+					for(auto j = n; j-->0;) {
+						SkipObjAt(reader, depth + 1);
+					}
+				}
+				break;
+			}
+			case kSKDictCode.asUInt(): {
+				EnterCtnr(reader, depth);
+				auto n = UIntObj::DecodeSize(reader);
+				auto keyCode = CodeByte::Read(reader);
+				SkipElemsAt(keyCode, n, reader, depth + 1);
+				while(n-->0) {
+					SkipObjAt(reader, depth + 1);
+				}
+				break;
+			}
+			case kSDictCode.asUInt(): {
+				EnterCtnr(reader, depth);
+				auto n = UIntObj::DecodeSize(reader);
+				auto keyCode = CodeByte::Read(reader);
+				SkipElemsAt(keyCode, n, reader, depth + 1);
+				auto valCode = CodeByte::Read(reader);
+				SkipElemsAt(valCode, n, reader, depth + 1);
+				break;
+			}
+			default:
+				throw BadCodeByte{typeCode};
+		}
+	}
+	static void SkipElemsAt(
+		CodeByte elemCode, std::size_t n, ByteReader& reader, std::size_t depth
+		)
+	{
+		switch(elemCode.asUInt()) {
+			case kNullObjCode.asUInt():
+				break;
+			case kBoolObjCode.asUInt():
+				reader.skip(n / 8u + (n % 8u != 0u));
+				break;
+			case kFloatObjCode.asUInt():
+				SkipFixed(n, sizeof(types::TFloat64), reader);
+				break;
+			case kFloat32Code.asUInt():
+				SkipFixed(n, sizeof(types::TFloat32), reader);
+				break;
+			default:
+				while(n-->0) {
+					SkipDataAt(elemCode, reader, depth);
+				}
+		}
+	}
+
+	//---- Public functions ----------------------------------------------------
+
+	auto SkipObj(ByteReader& reader) -> std::size_t {
+		auto start = reader.count();
+		SkipObjAt(reader, 0);
+		return reader.count() - start;
+	}
+	auto SkipData(CodeByte typeCode, ByteReader& reader) -> std::size_t {
+		auto start = reader.count();
+		SkipDataAt(typeCode, reader, 0);
+		return reader.count() - start;
+	}
+	auto SkipElems(CodeByte elemCode, std::size_t n, ByteReader& reader)
+		-> std::size_t
+	{
+		auto start = reader.count();
+		SkipElemsAt(elemCode, n, reader, 0);
+		return reader.count() - start;
+	}
+	auto EncodedExtent(
+		const std::byte* data, std::size_t size,
+		const CodecContext& context
+		) -> std::size_t
+	{
+		SpanReader reader{data, size};
+		reader.context() = context;
+		return SkipObj(reader);
+	}
+	auto EncodedExtent(
+		const TBytes& bytes, std::size_t offset,
+		const CodecContext& context
+		) -> std::size_t
+	{
+		if(offset > bytes.size()) {
+			throw BufOverrun{"EncodedExtent offset lies beyond the buffer"};
+		}
+		return EncodedExtent(
+			bytes.data() + offset, bytes.size() - offset, context
+			);
+	}
+}
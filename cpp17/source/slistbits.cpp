@@ -0,0 +1,86 @@
+#include "binon/slistbits.hpp"
+
+namespace binon {
+
+	//---- SListBits -----------------------------------------------------------
+
+	SListBits::SListBits(const TValue& v):
+		mValue{v}
+	{
+	}
+	SListBits::SListBits(TValue&& v) noexcept:
+		mValue{std::move(v)}
+	{
+	}
+	SListBits::SListBits(std::initializer_list<bool> init):
+		mValue{init}
+	{
+	}
+	SListBits::SListBits(const SList& obj) {
+		auto& list = obj.value();
+		mValue.reserve(list.size());
+		for(auto& elem: list) {
+			mValue.push_back(GetObjVal<bool>(elem));
+		}
+	}
+	auto SListBits::toSList() const -> SList {
+		TList list;
+		list.reserve(mValue.size());
+		for(std::size_t i = 0; i < mValue.size(); ++i) {
+			list.push_back(BoolObj{mValue[i]});
+		}
+		return SList{std::move(list), kElemCode};
+	}
+	auto SListBits::encodeData(ByteWriter& writer) const -> const SListBits& {
+		UIntObj::EncodeScalar(mValue.size(), writer);
+		kElemCode.write(writer);
+		mValue.write(writer);
+		return *this;
+	}
+	auto SListBits::encodedDataSize() const -> std::size_t {
+		return UIntObj::EncodedDataSize(mValue.size()) + 1u
+			+ mValue.byteSize();
+	}
+	auto SListBits::decodeData(ByteReader& reader) -> SListBits& {
+		auto n = UIntObj::DecodeSize(reader);
+		auto elemCode = CodeByte::Read(reader);
+		CheckNativeElemCode(elemCode, kElemCode);
+		CheckElemCount(n, elemCode, reader);
+		mValue.read(reader, n);
+		return *this;
+	}
+	auto SListBits::hash() const -> std::size_t {
+
+		//	There are only 2 possible element hashes to combine.
+		std::size_t elemHash[] = {
+			std::hash<BinONObj>{}(BoolObj{false}),
+			std::hash<BinONObj>{}(BoolObj{true})
+		};
+		auto seed = std::hash<CodeByte>{}(kTypeCode);
+		for(std::size_t i = 0; i < mValue.size(); ++i) {
+			seed = HashCombine(seed, elemHash[mValue[i]]);
+		}
+		return seed;
+	}
+	void SListBits::printArgs(std::ostream& stream) const {
+		stream << "SListBits::TValue{";
+		for(std::size_t i = 0; i < mValue.size(); ++i) {
+			if(i > 0u) {
+				stream << ", ";
+			}
+			BinONObj{BoolObj{mValue[i]}}.print(stream);
+		}
+		stream << "}, ";
+		kElemCode.printRepr(stream);
+	}
+
+	//---- Helper functions ----------------------------------------------------
+
+	auto operator<< (std::ostream& stream, const SListBits& obj)
+		-> std::ostream&
+	{
+		stream << obj.kClsName << '(';
+		obj.printArgs(stream);
+		return stream << ')';
+	}
+}
@@ -0,0 +1,184 @@
+#include "binon/sliststrs.hpp"
+
+#include <algorithm>
+
+namespace binon {
+
+	//---- StrColumn -----------------------------------------------------------
+
+	StrColumn::StrColumn(std::initializer_list<std::string_view> init) {
+		std::size_t nChars = 0;
+		for(auto sv: init) {
+			nChars += sv.size();
+		}
+		reserve(init.size(), nChars);
+		for(auto sv: init) {
+			push_back(sv);
+		}
+	}
+	void StrColumn::push_back(std::string_view sv) {
+		mChars.append(sv);
+		mEnds.push_back(mChars.size());
+	}
+	void StrColumn::reserve(std::size_t n, std::size_t nChars) {
+		mEnds.reserve(n);
+		mChars.reserve(nChars);
+	}
+	void StrColumn::clear() noexcept {
+		mChars.clear();
+		mEnds.clear();
+	}
+	auto StrColumn::operator== (const StrColumn& rhs) const noexcept -> bool {
+		return mEnds == rhs.mEnds && mChars == rhs.mChars;
+	}
+	void StrColumn::read(ByteReader& reader, std::size_t n) {
+		clear();
+
+		//	Measure the strings in place if they are all in the window.
+		auto p = reader.window();
+		auto avail = reader.windowSize();
+		std::size_t i = 0, pos = 0, nChars = 0;
+		for(; i < n; ++i) {
+			std::uint64_t len;
+			auto run = DecodeUIntRun(p + pos, avail - pos, &len, 1u);
+			if(run.count == 0u || len > avail - pos - run.size) {
+				break;
+			}
+			pos += run.size + static_cast<std::size_t>(len);
+			nChars += static_cast<std::size_t>(len);
+		}
+		if(i == n) {
+			reserve(n, nChars);
+		}
+		else {
+			mEnds.reserve(std::min(n, kMaxReserve));
+		}
+
+		for(i = 0; i < n; ++i) {
+			auto len = UIntObj::DecodeSize(reader);
+			reader.checkLength(len);
+			if(reader.windowSize() >= len) {
+				mChars.append(
+					reinterpret_cast<const char*>(reader.window()), len
+					);
+				reader.consume(len);
+			}
+			else {
+				auto n0 = mChars.size();
+				reader.readGrowing(len, [this, n0](std::size_t size) {
+					mChars.resize(n0 + size);
+					return reinterpret_cast<std::byte*>(mChars.data() + n0);
+				});
+			}
+			mEnds.push_back(mChars.size());
+		}
+	}
+	void StrColumn::write(ByteWriter& writer) const {
+		std::size_t beg = 0;
+		auto p = reinterpret_cast<const std::byte*>(mChars.data());
+		for(auto end: mEnds) {
+			WriteUIntVarint(end - beg, writer);
+			writer.write(p + beg, end - beg);
+			beg = end;
+		}
+	}
+	auto StrColumn::encodedSize() const noexcept -> std::size_t {
+		std::size_t size = mChars.size(), beg = 0;
+		for(auto end: mEnds) {
+			size += UIntVarintSize(end - beg);
+			beg = end;
+		}
+		return size;
+	}
+
+	//---- SListStrs -----------------------------------------------------------
+
+	SListStrs::SListStrs(const TValue& v):
+		mValue{v}
+	{
+	}
+	SListStrs::SListStrs(TValue&& v) noexcept:
+		mValue{std::move(v)}
+	{
+	}
+	SListStrs::SListStrs(std::initializer_list<std::string_view> init):
+		mValue{init}
+	{
+	}
+	SListStrs::SListStrs(const SList& obj) {
+		auto& list = obj.value();
+		std::size_t nChars = 0;
+		for(auto& elem: list) {
+			if(auto p = std::get_if<StrObj>(&elem); p) {
+				nChars += p->value().size();
+			}
+		}
+		mValue.reserve(list.size(), nChars);
+		for(auto& elem: list) {
+			mValue.push_back(GetObjVal<HyStr>(elem).asView());
+		}
+	}
+	auto SListStrs::toSList() const -> SList {
+		TList list;
+		list.reserve(mValue.size());
+		for(auto sv: mValue) {
+			list.push_back(StrObj{std::string{sv}});
+		}
+		return SList{std::move(list), kElemCode};
+	}
+	auto SListStrs::encodeData(ByteWriter& writer) const -> const SListStrs& {
+		UIntObj::EncodeScalar(mValue.size(), writer);
+		kElemCode.write(writer);
+		mValue.write(writer);
+		return *this;
+	}
+	auto SListStrs::encodedDataSize() const -> std::size_t {
+		return UIntObj::EncodedDataSize(mValue.size()) + 1u
+			+ mValue.encodedSize();
+	}
+	auto SListStrs::decodeData(ByteReader& reader) -> SListStrs& {
+		auto n = UIntObj::DecodeSize(reader);
+		auto elemCode = CodeByte::Read(reader);
+		CheckNativeElemCode(elemCode, kElemCode);
+		CheckElemCount(n, elemCode, reader);
+		mValue.read(reader, n);
+		return *this;
+	}
+	auto SListStrs::hash() const -> std::size_t {
+
+		//	The StrObjs wrap views into the arena, so hashing them does not
+		//	copy any strings.
+		auto seed = std::hash<CodeByte>{}(kTypeCode);
+		for(auto sv: mValue) {
+			seed = HashCombine(
+				seed, std::hash<BinONObj>{}(StrObj{HyStr{sv}})
+				);
+		}
+		return seed;
+	}
+	void SListStrs::printArgs(std::ostream& stream) const {
+		stream << "SListStrs::TValue{";
+		bool first = true;
+		for(auto sv: mValue) {
+			if(first) {
+				first = false;
+			}
+			else {
+				stream << ", ";
+			}
+			BinONObj{StrObj{HyStr{sv}}}.print(stream);
+		}
+		stream << "}, ";
+		kElemCode.printRepr(stream);
+	}
+
+	//---- Helper functions ----------------------------------------------------
+
+	auto operator<< (std::ostream& stream, const SListStrs& obj)
+		-> std::ostream&
+	{
+		stream << obj.kClsName << '(';
+		obj.printArgs(stream);
+		return stream << ')';
+	}
+}
@@ -12,23 +12,29 @@ namespace binon {
 	auto StrObj::hasDefVal() const noexcept -> bool {
 		return mValue.size() == 0;
 	}
-	auto StrObj::encodeData(TOStream& stream, bool requireIO) const
-		-> const StrObj&
-	{
-		RequireIO rio{stream, requireIO};
-		UIntObj{mValue.size()}.encodeData(stream, kSkipRequireIO);
-		stream.write(mValue.data(), mValue.size());
+	auto StrObj::encodeData(ByteWriter& writer) const -> const StrObj& {
+		UIntObj{mValue.size()}.encodeData(writer);
+		writer.write(mValue.data(), mValue.size());
 		return *this;
 	}
-	auto StrObj::decodeData(TIStream& stream, bool requireIO)
-		-> StrObj&
-	{
-		RequireIO rio{stream, requireIO};
-		UIntObj sizeObj;
-		sizeObj.decodeData(stream, kSkipRequireIO);
-		auto n = sizeObj.value().scalar();
-		mValue.resize(n);
-		stream.read(mValue.data(), n);
+	auto StrObj::encodedDataSize() const noexcept -> std::size_t {
+		auto n = mValue.size();
+		return UIntObj::EncodedDataSize(n) + n;
+	}
+	auto StrObj::decodeData(ByteReader& reader) -> StrObj& {
+		resetHash();
+		auto n = UIntObj::DecodeSize(reader);
+		reader.checkLength(n);
+		if(auto p = reader.borrow(n); p) {
+			auto data = reinterpret_cast<const TValue::TChr*>(p);
+			mValue = TValue{TValue::TView{data, n}, reader.owner()};
+		}
+		else {
+			reader.readGrowing(n, [this](std::size_t size) {
+				mValue.resize(size);
+				return reinterpret_cast<std::byte*>(mValue.data());
+			});
+		}
 		return *this;
 	}
 	void StrObj::printArgs(std::ostream& stream) const {
@@ -0,0 +1,635 @@
+#include "binon/treecodec.hpp"
+#include "binon/packelems.hpp"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace binon {
+
+	namespace {
+
+		constexpr auto IsCtnrCode(CodeByte cb) noexcept -> bool {
+			auto baseType = cb.baseType();
+			return baseType == kListObjCode.baseType()
+				|| baseType == kDictObjCode.baseType();
+		}
+
+		//	Elements of simple containers are data only, so their code must
+		//	identify the type and imply that there is data to follow.
+		void CheckElemCode(CodeByte elemCode) {
+			if(elemCode.subtype() == Subtype::kDefault ||
+				elemCode == kTrueObjCode)
+			{
+				throw BadCodeByte{elemCode};
+			}
+		}
+
+		//---- TreeDecoder -----------------------------------------------------
+
+		class TreeDecoder {
+		 public:
+			explicit TreeDecoder(ByteReader& reader);
+
+			//	decode() reads a complete object (code byte and data) into
+			//	obj. The begin...() methods start decoding the data of a
+			//	specific container, after which you call run() to finish.
+			void decode(BinONObj& obj);
+			void beginList(ListObj& obj);
+			void beginSList(SList& obj);
+			void beginDict(DictBase& obj, CodeByte typeCode);
+			void run();
+
+		 private:
+			struct Frame {
+				TList* mList = nullptr;
+				TDict* mDict = nullptr;
+				CodeByte* mValCode = nullptr;
+				CodeByte mElemCode = kNoObjCode;
+				std::size_t mCount = 0;
+				std::size_t mIndex = 0;
+				bool mInKeys = false;
+				TList mKeys;
+			};
+			using TDecodeFn = void(*)(TreeDecoder&, BinONObj&, CodeByte);
+
+			ByteReader& mReader;
+			std::size_t mMaxDepth;
+			std::size_t mMaxBytes;
+			std::vector<Frame> mFrames;
+
+			static const std::array<TDecodeFn,256> kDecoders;
+			static constexpr auto MakeDecoders() -> std::array<TDecodeFn,256>;
+			template<typename Obj>
+				static void DecodeScalar(
+					TreeDecoder& dec, BinONObj& obj, CodeByte cb
+					);
+			static void DecodeList(
+				TreeDecoder& dec, BinONObj& obj, CodeByte cb
+				);
+			static void DecodeSList(
+				TreeDecoder& dec, BinONObj& obj, CodeByte cb
+				);
+			template<typename Obj>
+				static void DecodeDict(
+					TreeDecoder& dec, BinONObj& obj, CodeByte cb
+					);
+			static void DecodeBad(TreeDecoder&, BinONObj&, CodeByte cb);
+
+			void dispatch(CodeByte cb, BinONObj& obj);
+			void checkBytes() const;
+			void checkDepth() const;
+			auto pushFrame(std::size_t count, CodeByte elemCode) -> Frame&;
+			void beginValues(Frame& frame);
+		};
+
+		TreeDecoder::TreeDecoder(ByteReader& reader):
+			mReader{reader},
+			mMaxDepth{reader.context().maxDepth},
+			mMaxBytes{reader.context().maxBytes}
+		{
+		}
+		void TreeDecoder::decode(BinONObj& obj) {
+			dispatch(CodeByte::Read(mReader), obj);
+			run();
+		}
+		void TreeDecoder::beginList(ListObj& obj) {
+			auto& list = obj.updateValue();
+			auto n = UIntObj::DecodeSize(mReader);
+			CheckElemCount(n, kNoObjCode, mReader);
+			list.resize(0);
+			list.reserve(std::min(n, kMaxReserve));
+			pushFrame(n, kNoObjCode).mList = &list;
+		}
+		void TreeDecoder::beginSList(SList& obj) {
+			auto& list = obj.updateValue();
+			auto n = UIntObj::DecodeSize(mReader);
+			obj.mElemCode = CodeByte::Read(mReader);
+			CheckElemCode(obj.mElemCode);
+			CheckElemCount(n, obj.mElemCode, mReader);
+			list.resize(0);
+
+			//	Unless the elements are containers themselves, they can all
+			//	be unpacked in one go without needing a frame.
+			if(IsCtnrCode(obj.mElemCode)) {
+				list.reserve(std::min(n, kMaxReserve));
+				pushFrame(n, obj.mElemCode).mList = &list;
+			}
+			else {
+				checkDepth();
+				UnpackRun(obj.mElemCode, n, list, mReader);
+			}
+		}
+		void TreeDecoder::beginDict(DictBase& obj, CodeByte typeCode) {
+			auto& dict = obj.updateValue();
+			auto n = UIntObj::DecodeSize(mReader);
+			auto keyCode = kNoObjCode;
+			CodeByte* pValCode = nullptr;
+			switch(typeCode.asUInt()) {
+				case kSKDictCode.asUInt():
+					keyCode = static_cast<SKDict&>(obj).mKeyCode
+						= CodeByte::Read(mReader);
+					CheckElemCode(keyCode);
+					break;
+				case kSDictCode.asUInt(): {
+					auto& sDict = static_cast<SDict&>(obj);
+					keyCode = sDict.mKeyCode = CodeByte::Read(mReader);
+					CheckElemCode(keyCode);
+					pValCode = &sDict.mValCode;
+					break;
+				}
+			}
+			CheckElemCount(n, keyCode, mReader);
+			dict.clear();
+			dict.reserve(std::min(n, kMaxReserve));
+			auto& frame = pushFrame(n, keyCode);
+			frame.mDict = &dict;
+			frame.mValCode = pValCode;
+			frame.mInKeys = true;
+			if(keyCode == kNoObjCode || IsCtnrCode(keyCode)) {
+				frame.mKeys.reserve(std::min(n, kMaxReserve));
+			}
+			else {
+				UnpackRun(keyCode, n, frame.mKeys, mReader);
+				frame.mIndex = n;
+			}
+		}
+		void TreeDecoder::run() {
+			while(!mFrames.empty()) {
+				checkBytes();
+				auto& frame = mFrames.back();
+				if(frame.mIndex == frame.mCount) {
+					if(frame.mInKeys) {
+						beginValues(frame);
+					}
+					else {
+						mFrames.pop_back();
+					}
+					continue;
+				}
+
+				//	Find the slot for the next element. Note that a nested
+				//	container pushes a new frame onto mFrames, which may move
+				//	the current one. The slot itself stays put, however, since
+				//	it lives in heap memory owned by a TList or TDict.
+				auto i = frame.mIndex++;
+				BinONObj* pObj;
+				if(!frame.mDict) {
+					pObj = &frame.mList->emplace_back();
+				}
+				else if(frame.mInKeys) {
+					pObj = &frame.mKeys.emplace_back();
+				}
+				else {
+					pObj = &(*frame.mDict)[std::move(frame.mKeys[i])];
+				}
+				if(frame.mElemCode == kNoObjCode) {
+					dispatch(CodeByte::Read(mReader), *pObj);
+				}
+				else {
+					dispatch(frame.mElemCode, *pObj);
+				}
+			}
+			checkBytes();
+		}
+		constexpr auto TreeDecoder::MakeDecoders()
+			-> std::array<TDecodeFn,256>
+		{
+			std::array<TDecodeFn,256> fns{};
+			for(auto& fn: fns) {
+				fn = &DecodeBad;
+			}
+
+			//	Objects with the default subtype (e.g. 0x20) decode to a
+			//	default-valued object of the base type (e.g. 0x21).
+			fns[0x00] = fns[0x01] = &DecodeScalar<NullObj>;
+			fns[0x10] = fns[0x11] = fns[0x12] = &DecodeScalar<BoolObj>;
+			fns[0x20] = fns[0x21] = &DecodeScalar<IntObj>;
+			fns[0x22] = &DecodeScalar<UIntObj>;
+			fns[0x30] = fns[0x31] = &DecodeScalar<FloatObj>;
+			fns[0x32] = &DecodeScalar<Float32Obj>;
+			fns[0x40] = fns[0x41] = &DecodeScalar<BufferObj>;
+			fns[0x50] = fns[0x51] = &DecodeScalar<StrObj>;
+			fns[0x80] = fns[0x81] = &DecodeList;
+			fns[0x82] = &DecodeSList;
+			fns[0x90] = fns[0x91] = &DecodeDict<DictObj>;
+			fns[0x92] = &DecodeDict<SKDict>;
+			fns[0x93] = &DecodeDict<SDict>;
+			return fns;
+		}
+		const std::array<TreeDecoder::TDecodeFn,256>
+			TreeDecoder::kDecoders = TreeDecoder::MakeDecoders();
+
+		template<typename Obj>
+			void TreeDecoder::DecodeScalar(
+				TreeDecoder& dec, BinONObj& obj, CodeByte cb
+				)
+		{
+			obj.emplace<Obj>().decode(cb, dec.mReader);
+		}
+		void TreeDecoder::DecodeList(
+			TreeDecoder& dec, BinONObj& obj, CodeByte cb
+			)
+		{
+			auto& list = obj.emplace<ListObj>();
+			if(cb.subtype() != Subtype::kDefault) {
+				dec.beginList(list);
+			}
+		}
+		void TreeDecoder::DecodeSList(
+			TreeDecoder& dec, BinONObj& obj, CodeByte
+			)
+		{
+			dec.beginSList(obj.emplace<SList>());
+		}
+		template<typename Obj>
+			void TreeDecoder::DecodeDict(
+				TreeDecoder& dec, BinONObj& obj, CodeByte cb
+				)
+		{
+			auto& dict = obj.emplace<Obj>();
+			if(cb.subtype() != Subtype::kDefault) {
+				dec.beginDict(dict, Obj::kTypeCode);
+			}
+		}
+		void TreeDecoder::DecodeBad(TreeDecoder&, BinONObj&, CodeByte cb) {
+			throw BadCodeByte{cb};
+		}
+		void TreeDecoder::dispatch(CodeByte cb, BinONObj& obj) {
+			kDecoders[cb.asUInt()](*this, obj, cb);
+		}
+		void TreeDecoder::checkBytes() const {
+			if(mReader.count() > mMaxBytes) {
+				throw LimitErr{"BinON input exceeds CodecContext::maxBytes"};
+			}
+		}
+		void TreeDecoder::checkDepth() const {
+			if(mFrames.size() >= mMaxDepth) {
+				throw DepthErr{"BinON containers nested too deeply to decode"};
+			}
+		}
+		auto TreeDecoder::pushFrame(std::size_t count, CodeByte elemCode)
+			-> Frame&
+		{
+			checkDepth();
+			auto& frame = mFrames.emplace_back();
+			frame.mElemCode = elemCode;
+			frame.mCount = count;
+			return frame;
+		}
+		void TreeDecoder::beginValues(Frame& frame) {
+			frame.mInKeys = false;
+			frame.mIndex = 0;
+			if(frame.mValCode) {
+				auto valCode = *frame.mValCode = CodeByte::Read(mReader);
+				CheckElemCode(valCode);
+				CheckElemCount(frame.mCount, valCode, mReader);
+				frame.mElemCode = valCode;
+				if(!IsCtnrCode(valCode)) {
+					TList vals;
+					UnpackRun(valCode, frame.mCount, vals, mReader);
+					auto& dict = *frame.mDict;
+					for(std::size_t i = 0; i < frame.mCount; ++i) {
+						dict.insert_or_assign(
+							std::move(frame.mKeys[i]), std::move(vals[i])
+							);
+					}
+					frame.mIndex = frame.mCount;
+				}
+			}
+			else {
+				CheckElemCount(frame.mCount, kNoObjCode, mReader);
+				frame.mElemCode = kNoObjCode;
+			}
+		}
+
+		//---- TreeEncoder -----------------------------------------------------
+
+		class TreeEncoder {
+		 public:
+			explicit TreeEncoder(ByteWriter& writer);
+
+			//	encode() writes a complete object, with or without its code
+			//	byte. The begin...() methods start encoding the data of a
+			//	specific container, after which you call run() to finish.
+			void encode(const BinONObj& obj, bool withCode);
+			void begin(const ListObj& obj);
+			void begin(const SList& obj);
+			void begin(const DictObj& obj);
+			void begin(const SKDict& obj);
+			void begin(const SDict& obj);
+			void run();
+
+		 private:
+			struct Frame {
+				const TList* mList = nullptr;
+				const TDict* mDict = nullptr;
+				std::size_t mIndex = 0;
+				TDict::const_iterator mIter;
+				CodeByte mElemCode = kNoObjCode;
+				CodeByte mValCode = kNoObjCode;
+				bool mInKeys = false;
+				std::optional<PackElems> mPack;
+			};
+			using TEncodeFn = void(*)(TreeEncoder&, const BinONObj&, bool);
+			static constexpr auto kNumAlts = std::variant_size_v<BinONVariant>;
+
+			ByteWriter& mWriter;
+			std::vector<Frame> mFrames;
+
+			static const std::array<TEncodeFn,kNumAlts> kEncoders;
+			template<std::size_t... I>
+				static constexpr auto MakeEncoders(std::index_sequence<I...>)
+					-> std::array<TEncodeFn,kNumAlts>;
+			template<std::size_t I>
+				static void EncodeAlt(
+					TreeEncoder& enc, const BinONObj& obj, bool withCode
+					);
+
+			template<typename Obj>
+				void encodeObj(const Obj& obj, bool withCode);
+			template<typename Obj>
+				auto writeCode(const Obj& obj) -> bool;
+			void dispatch(const BinONObj& obj, bool withCode);
+			void checkDepth() const;
+			auto pushFrame(CodeByte elemCode) -> Frame&;
+			void beginDict(
+				const TDict& dict, CodeByte keyCode, CodeByte valCode
+				);
+			void beginValues(Frame& frame);
+		};
+
+		TreeEncoder::TreeEncoder(ByteWriter& writer):
+			mWriter{writer}
+		{
+		}
+		void TreeEncoder::encode(const BinONObj& obj, bool withCode) {
+			dispatch(obj, withCode);
+			run();
+		}
+		void TreeEncoder::begin(const ListObj& obj) {
+			auto& list = obj.value();
+			UIntObj{list.size()}.encodeData(mWriter);
+			pushFrame(kNoObjCode).mList = &list;
+		}
+		void TreeEncoder::begin(const SList& obj) {
+			if(obj.mElemCode == kNoObjCode) {
+				std::ostringstream oss;
+				oss << "SList is missing an element code (";
+				BinONObj{obj}.print(oss);
+				oss << ')';
+				throw NoTypeCode{oss.str()};
+			}
+			auto& list = obj.value();
+			UIntObj{list.size()}.encodeData(mWriter);
+			obj.mElemCode.write(mWriter);
+			if(IsCtnrCode(obj.mElemCode)) {
+				pushFrame(obj.mElemCode).mList = &list;
+			}
+			else {
+				checkDepth();
+				PackRun(obj.mElemCode, list, mWriter);
+			}
+		}
+		void TreeEncoder::begin(const DictObj& obj) {
+			beginDict(obj.value(), kNoObjCode, kNoObjCode);
+		}
+		void TreeEncoder::begin(const SKDict& obj) {
+			if(obj.mKeyCode == kNoObjCode) {
+				std::ostringstream oss;
+				oss << "SKDict is missing a key code (";
+				BinONObj{obj}.print(oss);
+				oss << ')';
+				throw NoTypeCode{oss.str()};
+			}
+			beginDict(obj.value(), obj.mKeyCode, kNoObjCode);
+		}
+		void TreeEncoder::begin(const SDict& obj) {
+			if(obj.mKeyCode == kNoObjCode || obj.mValCode == kNoObjCode) {
+				std::ostringstream oss;
+				oss << "SDict is missing a";
+				if(obj.mKeyCode == kNoObjCode) {
+					oss << " key";
+					if(obj.mValCode == kNoObjCode) {
+						oss << " and value";
+					}
+				}
+				else {
+					oss << " value";
+				}
+				oss << " code (";
+				BinONObj{obj}.print(oss);
+				oss << ')';
+				throw NoTypeCode{oss.str()};
+			}
+			beginDict(obj.value(), obj.mKeyCode, obj.mValCode);
+		}
+		void TreeEncoder::run() {
+			while(!mFrames.empty()) {
+				auto& frame = mFrames.back();
+				const BinONObj* pObj;
+				if(frame.mDict) {
+					if(frame.mIter == frame.mDict->end()) {
+						if(frame.mInKeys) {
+							beginValues(frame);
+						}
+						else {
+							mFrames.pop_back();
+						}
+						continue;
+					}
+					pObj = frame.mInKeys ?
+						&frame.mIter->first : &frame.mIter->second;
+					++frame.mIter;
+				}
+				else {
+					if(frame.mIndex == frame.mList->size()) {
+						mFrames.pop_back();
+						continue;
+					}
+					pObj = &(*frame.mList)[frame.mIndex++];
+				}
+
+				//	As in TreeDecoder::run(), frame may be invalidated by
+				//	dispatch() pushing a nested container. (Frames only pack
+				//	container elements. The rest go through PackRun() and
+				//	friends before a frame would get to them.)
+				if(!frame.mPack) {
+					dispatch(*pObj, true);
+				}
+				else {
+					frame.mPack->expect(*pObj);
+					dispatch(*pObj, false);
+				}
+			}
+		}
+		template<std::size_t... I>
+			constexpr auto TreeEncoder::MakeEncoders(std::index_sequence<I...>)
+				-> std::array<TEncodeFn,kNumAlts>
+		{
+			return {&EncodeAlt<I>...};
+		}
+		const std::array<TreeEncoder::TEncodeFn,TreeEncoder::kNumAlts>
+			TreeEncoder::kEncoders = TreeEncoder::MakeEncoders(
+				std::make_index_sequence<kNumAlts>{}
+				);
+
+		template<std::size_t I>
+			void TreeEncoder::EncodeAlt(
+				TreeEncoder& enc, const BinONObj& obj, bool withCode
+				)
+		{
+			enc.encodeObj(*std::get_if<I>(&obj.value()), withCode);
+		}
+		template<typename Obj>
+			void TreeEncoder::encodeObj(const Obj& obj, bool withCode)
+		{
+			if constexpr(
+				std::is_base_of_v<ListBase,Obj> ||
+				std::is_base_of_v<DictBase,Obj>)
+			{
+				if(!withCode || writeCode(obj)) {
+					begin(obj);
+				}
+			}
+			else if(withCode) {
+				obj.encode(mWriter);
+			}
+			else {
+				obj.encodeData(mWriter);
+			}
+		}
+		template<typename Obj>
+			auto TreeEncoder::writeCode(const Obj& obj) -> bool
+		{
+			CodeByte cb = Obj::kTypeCode;
+			bool hasDefVal = obj.hasDefVal();
+			if(hasDefVal) {
+				Subtype{cb} = Subtype::kDefault;
+			}
+			cb.write(mWriter);
+			return !hasDefVal;
+		}
+		void TreeEncoder::dispatch(const BinONObj& obj, bool withCode) {
+			kEncoders[obj.index()](*this, obj, withCode);
+		}
+		void TreeEncoder::checkDepth() const {
+			CheckEncodeDepth(mFrames.size(), mWriter);
+		}
+		auto TreeEncoder::pushFrame(CodeByte elemCode) -> Frame& {
+			checkDepth();
+			auto& frame = mFrames.emplace_back();
+			frame.mElemCode = elemCode;
+			if(IsCtnrCode(elemCode)) {
+				frame.mPack.emplace(elemCode, mWriter);
+			}
+			return frame;
+		}
+		void TreeEncoder::beginDict(
+			const TDict& dict, CodeByte keyCode, CodeByte valCode
+			)
+		{
+			UIntObj{dict.size()}.encodeData(mWriter);
+			if(keyCode != kNoObjCode) {
+				keyCode.write(mWriter);
+			}
+			auto& frame = pushFrame(keyCode);
+			frame.mDict = &dict;
+			frame.mIter = dict.begin();
+			frame.mInKeys = true;
+			frame.mValCode = valCode;
+			if(keyCode != kNoObjCode && !IsCtnrCode(keyCode)) {
+				PackKeys(keyCode, dict, mWriter);
+				beginValues(frame);
+			}
+		}
+		void TreeEncoder::beginValues(Frame& frame) {
+			frame.mInKeys = false;
+			frame.mIter = frame.mDict->begin();
+			frame.mElemCode = frame.mValCode;
+			frame.mPack.reset();
+			if(frame.mValCode != kNoObjCode) {
+				frame.mValCode.write(mWriter);
+				if(IsCtnrCode(frame.mValCode)) {
+					frame.mPack.emplace(frame.mValCode, mWriter);
+				}
+				else {
+					PackValues(frame.mValCode, *frame.mDict, mWriter);
+					frame.mIter = frame.mDict->end();
+				}
+			}
+		}
+	}
+
+	//---- Public functions ----------------------------------------------------
+
+	auto DecodeTree(ByteReader& reader) -> BinONObj {
+		BinONObj obj;
+		TreeDecoder{reader}.decode(obj);
+		return obj;
+	}
+	void EncodeTree(const BinONObj& obj, ByteWriter& writer) {
+		TreeEncoder{writer}.encode(obj, true);
+	}
+	void EncodeTreeData(const BinONObj& obj, ByteWriter& writer) {
+		TreeEncoder{writer}.encode(obj, false);
+	}
+	void DecodeTreeData(ListObj& obj, ByteReader& reader) {
+		TreeDecoder decoder{reader};
+		decoder.beginList(obj);
+		decoder.run();
+	}
+	void DecodeTreeData(SList& obj, ByteReader& reader) {
+		TreeDecoder decoder{reader};
+		decoder.beginSList(obj);
+		decoder.run();
+	}
+	void DecodeTreeData(DictObj& obj, ByteReader& reader) {
+		TreeDecoder decoder{reader};
+		decoder.beginDict(obj, DictObj::kTypeCode);
+		decoder.run();
+	}
+	void DecodeTreeData(SKDict& obj, ByteReader& reader) {
+		TreeDecoder decoder{reader};
+		decoder.beginDict(obj, SKDict::kTypeCode);
+		decoder.run();
+	}
+	void DecodeTreeData(SDict& obj, ByteReader& reader) {
+		TreeDecoder decoder{reader};
+		decoder.beginDict(obj, SDict::kTypeCode);
+		decoder.run();
+	}
+	void EncodeTreeData(const ListObj& obj, ByteWriter& writer) {
+		TreeEncoder encoder{writer};
+		encoder.begin(obj);
+		encoder.run();
+	}
+	void EncodeTreeData(const SList& obj, ByteWriter& writer) {
+		TreeEncoder encoder{writer};
+		encoder.begin(obj);
+		encoder.run();
+	}
+	void EncodeTreeData(const DictObj& obj, ByteWriter& writer) {
+		TreeEncoder encoder{writer};
+		encoder.begin(obj);
+		encoder.run();
+	}
+	void EncodeTreeData(const SKDict& obj, ByteWriter& writer) {
+		TreeEncoder encoder{writer};
+		encoder.begin(obj);
+		encoder.run();
+	}
+	void EncodeTreeData(const SDict& obj, ByteWriter& writer) {
+		TreeEncoder encoder{writer};
+		encoder.begin(obj);
+		encoder.run();
+	}
+	void CheckEncodeDepth(std::size_t depth, const ByteWriter& writer) {
+		if(depth >= writer.context().maxDepth) {
+			throw DepthErr{"BinON containers nested too deeply to encode"};
+		}
+	}
+}
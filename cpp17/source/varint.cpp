@@ -0,0 +1,402 @@
+#include "binon/varint.hpp"
+#include "binon/byteutil.hpp"
+
+#include <cstring>
+#if BINON_X86_SIMD
+	#include <immintrin.h>
+#endif
+
+namespace binon {
+
+	namespace {
+
+		//	kLengths maps the high nibble of an integer's first byte to its
+		//	encoded length, and kDataBits maps that length to the number of
+		//	value bits after the length prefix. A 0xf? nibble gets a length
+		//	of 9 here: the first byte followed by a raw 64-bit value. (Only
+		//	0xf0 is valid, but IntObj::DecodeScalar() reads the others the
+		//	same way, and 0xf1 gets checked for separately.)
+		constexpr std::array<unsigned char,16> kLengths{
+			1,1,1,1, 1,1,1,1, 2,2,2,2, 4,4,8,9
+		};
+		constexpr std::array<unsigned char,9> kDataBits{
+			0,7,14,0, 29,0,0,0, 60
+		};
+
+		//	Every integer is at most 9 bytes long, so decoding can skip
+		//	bounds checks for as long as this many bytes remain.
+		constexpr std::size_t kSlack = 9;
+
+		auto LoadBig64(const std::byte* p, bool swap) noexcept
+			-> std::uint64_t
+		{
+			std::uint64_t u;
+			std::memcpy(&u, p, sizeof u);
+			return swap ? SwapBytes(u) : u;
+		}
+
+		//	DecodeOne() decodes the integer starting at p, provided it is not
+		//	in vector form and at least kSlack bytes are readable from p. It
+		//	sets len to the number of bytes it took up. Signed values are
+		//	returned in two's complement.
+		template<bool Signed>
+			auto DecodeOne(const std::byte* p, bool swap, std::size_t& len)
+				noexcept -> std::uint64_t
+		{
+			len = kLengths[std::to_integer<unsigned>(*p) >> 4];
+			if(len == 9u) {
+				return LoadBig64(p + 1, swap);
+			}
+			auto u = LoadBig64(p, swap) >> (64u - 8u * len);
+			auto bits = kDataBits[len];
+			u &= ~std::uint64_t{0} >> (64u - bits);
+			if constexpr(Signed) {
+				auto msb = std::uint64_t{1} << (bits - 1u);
+				u = (u ^ msb) - msb;
+			}
+			return u;
+		}
+
+		//	DecodeTail() finishes off a run once fewer than kSlack bytes
+		//	remain, copying each integer into a scratch buffer first.
+		template<bool Signed>
+			void DecodeTail(
+				const std::byte* p, std::size_t size, std::uint64_t* out,
+				std::size_t n, VarintRun& run, bool swap
+				) noexcept
+		{
+			while(run.count < n && run.size < size) {
+				auto byte0 = p[run.size];
+				std::size_t len =
+					kLengths[std::to_integer<unsigned>(byte0) >> 4];
+				if(byte0 == 0xf1_byte || len > size - run.size) {
+					break;
+				}
+				std::array<std::byte,kSlack> buf{};
+				std::memcpy(buf.data(), p + run.size, len);
+				out[run.count++] = DecodeOne<Signed>(buf.data(), swap, len);
+				run.size += len;
+			}
+		}
+
+		//	DecodeNext() decodes the integer at the current position of a
+		//	run, returning false if it is in vector form.
+		template<bool Signed>
+			auto DecodeNext(
+				const std::byte* p, std::uint64_t* out, VarintRun& run,
+				bool swap
+				) noexcept -> bool
+		{
+			if(p[run.size] == 0xf1_byte) {
+				return false;
+			}
+			std::size_t len;
+			out[run.count++] = DecodeOne<Signed>(p + run.size, swap, len);
+			run.size += len;
+			return true;
+		}
+
+		template<bool Signed>
+			auto DecodeScalarRun(
+				const std::byte* p, std::size_t size, std::uint64_t* out,
+				std::size_t n
+				) noexcept -> VarintRun
+		{
+			bool swap = LittleEndian();
+			VarintRun run{0, 0};
+			while(run.count < n && size - run.size >= kSlack) {
+				if(!DecodeNext<Signed>(p, out, run, swap)) {
+					return run;
+				}
+			}
+			DecodeTail<Signed>(p, size, out, n, run, swap);
+			return run;
+		}
+
+	 #if BINON_X86_SIMD
+
+		//	The SIMD versions look at a block of 16 (SSE4.1) or 32 (AVX2)
+		//	bytes. Bytes with the top bit clear are 1-byte integers, so the
+		//	count of trailing zeros in the movemask tells how many of those
+		//	come first. All the bytes in the block get widened into out
+		//	(which is fine since only that many are counted as decoded), and
+		//	then the integer that ends the streak, if any, is decoded by
+		//	DecodeNext(). x86 is little-endian, so swap is always true here.
+
+		template<bool Signed>
+			__attribute__((target("sse4.1")))
+			void Widen16(__m128i v, std::uint64_t* out) noexcept
+		{
+			if constexpr(Signed) {
+				//	Sign-extend the 7-bit values to 8 bits first.
+				auto k40 = _mm_set1_epi8(0x40);
+				v = _mm_sub_epi8(_mm_xor_si128(v, k40), k40);
+			}
+			auto pOut = reinterpret_cast<__m128i*>(out);
+			for(int i = 0; i < 8; ++i) {
+				auto w = Signed ? _mm_cvtepi8_epi64(v) : _mm_cvtepu8_epi64(v);
+				_mm_storeu_si128(pOut + i, w);
+				v = _mm_srli_si128(v, 2);
+			}
+		}
+		template<bool Signed>
+			__attribute__((target("sse4.1")))
+			auto DecodeSSE41Run(
+				const std::byte* p, std::size_t size, std::uint64_t* out,
+				std::size_t n
+				) noexcept -> VarintRun
+		{
+			VarintRun run{0, 0};
+			while(run.count < n && size - run.size >= kSlack) {
+				if(n - run.count >= 16u && size - run.size >= 16u) {
+					auto v = _mm_loadu_si128(
+						reinterpret_cast<const __m128i*>(p + run.size)
+						);
+					auto mask = static_cast<unsigned>(_mm_movemask_epi8(v));
+					Widen16<Signed>(v, out + run.count);
+					auto k = mask ?
+						static_cast<unsigned>(__builtin_ctz(mask)) : 16u;
+					run.count += k;
+					run.size += k;
+					if(k == 16u || size - run.size < kSlack) {
+						continue;
+					}
+				}
+				if(!DecodeNext<Signed>(p, out, run, true)) {
+					return run;
+				}
+			}
+			DecodeTail<Signed>(p, size, out, n, run, true);
+			return run;
+		}
+
+		template<bool Signed>
+			__attribute__((target("avx2")))
+			void Widen32(__m256i v, std::uint64_t* out) noexcept
+		{
+			if constexpr(Signed) {
+				auto k40 = _mm256_set1_epi8(0x40);
+				v = _mm256_sub_epi8(_mm256_xor_si256(v, k40), k40);
+			}
+			auto pOut = reinterpret_cast<__m256i*>(out);
+			for(auto half: {
+				_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)
+				})
+			{
+				for(int i = 0; i < 4; ++i) {
+					auto w = Signed ?
+						_mm256_cvtepi8_epi64(half) :
+						_mm256_cvtepu8_epi64(half);
+					_mm256_storeu_si256(pOut++, w);
+					half = _mm_srli_si128(half, 4);
+				}
+			}
+		}
+		template<bool Signed>
+			__attribute__((target("avx2")))
+			auto DecodeAVX2Run(
+				const std::byte* p, std::size_t size, std::uint64_t* out,
+				std::size_t n
+				) noexcept -> VarintRun
+		{
+			VarintRun run{0, 0};
+			while(run.count < n && size - run.size >= kSlack) {
+				if(n - run.count >= 32u && size - run.size >= 32u) {
+					auto v = _mm256_loadu_si256(
+						reinterpret_cast<const __m256i*>(p + run.size)
+						);
+					auto mask = static_cast<unsigned>(
+						_mm256_movemask_epi8(v)
+						);
+					Widen32<Signed>(v, out + run.count);
+					auto k = mask ?
+						static_cast<unsigned>(__builtin_ctz(mask)) : 32u;
+					run.count += k;
+					run.size += k;
+					if(k == 32u || size - run.size < kSlack) {
+						continue;
+					}
+				}
+				if(!DecodeNext<Signed>(p, out, run, true)) {
+					return run;
+				}
+			}
+			DecodeTail<Signed>(p, size, out, n, run, true);
+			return run;
+		}
+
+	 #endif
+
+		//---- Encoding --------------------------------------------------------
+
+		//	StoreTiny() stores a block of kTinyBlock integers as 1 byte each
+		//	if they all fit, returning false if they do not. Runs of small
+		//	integers are common enough that checking for them a block at a
+		//	time pays for itself.
+		constexpr std::size_t kTinyBlock = 8;
+		template<bool Signed>
+			auto StoreTiny(const std::uint64_t* in, std::byte* p) noexcept
+				-> bool
+		{
+			//	Offsetting signed values by 0x40 maps the 1-byte range
+			//	[-0x40,0x40) onto [0,0x80).
+			constexpr std::uint64_t kBias = Signed ? 0x40u : 0x00u;
+			std::uint64_t bits = 0, word = 0;
+			for(std::size_t i = 0; i < kTinyBlock; ++i) {
+				bits |= in[i] + kBias;
+				auto shift = LittleEndian() ? 8u * i : 56u - 8u * i;
+				word |= (in[i] & 0x7fu) << shift;
+			}
+			if(bits >= 0x80u) {
+				return false;
+			}
+			std::memcpy(p, &word, sizeof word);
+			return true;
+		}
+
+		//	WriteRun() stores as many integers as fit straight into the
+		//	writer's window, and then the next one through WriteUIntVarint()
+		//	or WriteIntVarint() (which grows or flushes the window), until
+		//	all n are written.
+		template<bool Signed>
+			void WriteRun(
+				const std::uint64_t* in, std::size_t n, ByteWriter& writer
+				)
+		{
+			constexpr std::size_t kBlockRoom = kTinyBlock * kMaxVarintSize;
+			auto tiny = true;
+			while(n > 0) {
+				auto p = writer.window();
+				auto room = writer.windowSize();
+				std::size_t size = 0;
+				for(; n >= kTinyBlock && room - size >= kBlockRoom;
+					n -= kTinyBlock)
+				{
+					if(tiny && StoreTiny<Signed>(in, p + size)) {
+						size += kTinyBlock;
+						in += kTinyBlock;
+					}
+					else {
+						auto start = size;
+						for(std::size_t i = 0; i < kTinyBlock; ++i) {
+							size += details::StoreVarint<Signed>(
+								*in++, p + size
+								);
+						}
+
+						//	A failed check costs more than it saves when
+						//	longer integers are common, so don't check again
+						//	until a block turns out to be all 1-byte.
+						tiny = size - start == kTinyBlock;
+					}
+				}
+				for(; n > 0 && room - size >= kMaxVarintSize; --n) {
+					size += details::StoreVarint<Signed>(*in++, p + size);
+				}
+				writer.advance(size);
+				if(n > 0) {
+					auto u = *in++;
+					if constexpr(Signed) {
+						WriteIntVarint(static_cast<std::int64_t>(u), writer);
+					}
+					else {
+						WriteUIntVarint(u, writer);
+					}
+					--n;
+				}
+			}
+		}
+
+		//---- Runtime dispatch ------------------------------------------------
+
+		using TRunFn = auto(*)(
+			const std::byte*, std::size_t, std::uint64_t*, std::size_t
+			) noexcept -> VarintRun;
+		struct Decoders {
+			TRunFn mUInt = &DecodeScalarRun<false>;
+			TRunFn mInt = &DecodeScalarRun<true>;
+			std::string_view mISA = "scalar";
+		};
+		//	PickDecoders() fills in the fastest decoders the CPU supports or,
+		//	if isa is not empty, the ones for that ISA. It returns false and
+		//	leaves decoders alone if the latter are unavailable.
+		auto PickDecoders(Decoders& decoders, std::string_view isa = {})
+			noexcept -> bool
+		{
+			auto any = isa.empty();
+		 #if BINON_X86_SIMD
+			__builtin_cpu_init();
+			if((any || isa == "avx2") && __builtin_cpu_supports("avx2")) {
+				decoders.mUInt = &DecodeAVX2Run<false>;
+				decoders.mInt = &DecodeAVX2Run<true>;
+				decoders.mISA = "avx2";
+				return true;
+			}
+			if((any || isa == "sse4.1") && __builtin_cpu_supports("sse4.1")) {
+				decoders.mUInt = &DecodeSSE41Run<false>;
+				decoders.mInt = &DecodeSSE41Run<true>;
+				decoders.mISA = "sse4.1";
+				return true;
+			}
+		 #endif
+			if(any || isa == "scalar") {
+				decoders = Decoders{};
+				return true;
+			}
+			return false;
+		}
+		auto GetDecoders() noexcept -> Decoders& {
+			static Decoders decoders = [] {
+				Decoders picked;
+				PickDecoders(picked);
+				return picked;
+			}();
+			return decoders;
+		}
+	}
+
+	void details::WriteUIntVarintSlow(std::uint64_t v, ByteWriter& writer) {
+		std::array<std::byte,kMaxVarintSize> buf;
+		writer.write(buf.data(), StoreUIntVarint(v, buf.data()));
+	}
+	void details::WriteIntVarintSlow(std::int64_t v, ByteWriter& writer) {
+		std::array<std::byte,kMaxVarintSize> buf;
+		writer.write(buf.data(), StoreIntVarint(v, buf.data()));
+	}
+	void WriteUIntVarints(
+		const std::uint64_t* p, std::size_t n, ByteWriter& writer
+		)
+	{
+		WriteRun<false>(p, n, writer);
+	}
+	void WriteIntVarints(
+		const std::int64_t* p, std::size_t n, ByteWriter& writer
+		)
+	{
+		WriteRun<true>(reinterpret_cast<const std::uint64_t*>(p), n, writer);
+	}
+	auto DecodeUIntRun(
+		const std::byte* p, std::size_t size, std::uint64_t* out,
+		std::size_t n
+		) noexcept -> VarintRun
+	{
+		return GetDecoders().mUInt(p, size, out, n);
+	}
+	auto DecodeIntRun(
+		const std::byte* p, std::size_t size, std::int64_t* out,
+		std::size_t n
+		) noexcept -> VarintRun
+	{
+		//	The signed decoders work in two's complement, and int64_t and
+		//	uint64_t may alias one another.
+		return GetDecoders().mInt(
+			p, size, reinterpret_cast<std::uint64_t*>(out), n
+			);
+	}
+	auto VarintDecoderISA() noexcept -> std::string_view {
+		return GetDecoders().mISA;
+	}
+	auto ForceVarintDecoderISA(std::string_view isa) noexcept -> bool {
+		return PickDecoders(GetDecoders(), isa);
+	}
+}
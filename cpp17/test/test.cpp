@@ -0,0 +1,1899 @@
+#include "binon/binon.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <system_error>
+#include <vector>
+
+//	This program checks the library end to end. Each Test...() function covers
+//	one feature: the codecs round-tripping every object type, the limits that
+//	reject bad input, the native container types encoding exactly the way
+//	their BinONVariant counterparts do, and so on. It prints each failed check
+//	and returns 1 if there were any.
+
+//	The global operator new is replaced so that the tests can see the largest
+//	block of memory the decoders ask for (see DecodeFailsCheaply()).
+namespace {
+	std::size_t gLargestAlloc = 0;
+}
+auto operator new(std::size_t n) -> void* {
+	gLargestAlloc = std::max(gLargestAlloc, n);
+	if(auto p = std::malloc(n ? n : 1u); p) {
+		return p;
+	}
+	throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+namespace {
+	using namespace binon;
+
+	int gChecks = 0;
+	int gFailures = 0;
+
+	void Check(bool cond, const std::string& what) {
+		++gChecks;
+		if(!cond) {
+			++gFailures;
+			std::cerr << "FAILED: " << what << '\n';
+		}
+	}
+
+	//	CheckThrows() runs fn and checks that it throws an Err (and not just
+	//	any exception).
+	template<typename Err>
+		void CheckThrows(
+			const std::function<void()>& fn, const std::string& what
+			)
+	{
+		bool threw = false;
+		try {
+			fn();
+		}
+		catch(const Err&) {
+			threw = true;
+		}
+		catch(const std::exception& err) {
+			std::cerr << what << ": unexpected exception: " << err.what()
+				<< '\n';
+		}
+		Check(threw, what);
+	}
+
+	template<typename Obj>
+		auto EncodeObj(const Obj& obj) -> TBytes
+	{
+		TBytes bytes;
+		VectorWriter writer{bytes};
+		obj.encode(writer);
+		writer.flush();
+		return bytes;
+	}
+	auto Encode(const BinONObj& obj) -> TBytes {
+		return EncodeObj(obj);
+	}
+	auto Decode(const TBytes& bytes, const CodecContext& context = {})
+		-> BinONObj
+	{
+		SpanReader reader{bytes};
+		reader.context() = context;
+		return BinONObj::Decode(reader);
+	}
+
+	//	Hand-assembles encodings that no BinONObj would produce.
+	struct RawBytes {
+		TBytes mBytes;
+		auto code(CodeByte cb) -> RawBytes& {
+			mBytes.push_back(std::byte{cb});
+			return *this;
+		}
+		auto size(std::uint64_t n) -> RawBytes& {
+			VectorWriter writer{mBytes};
+			UIntObj{n}.encodeData(writer);
+			return *this;
+		}
+	};
+
+	//	Names an object in a failed check by the start of its printout.
+	auto Name(const BinONObj& obj) -> std::string {
+		std::ostringstream oss;
+		oss << obj;
+		return oss.str().substr(0, 60);
+	}
+
+	//	Nests a ListObj n levels deep.
+	auto DeepList(std::size_t n) -> BinONObj {
+		BinONObj obj = ListObj{};
+		while(n-->1) {
+			ListObj list;
+			list.value().push_back(std::move(obj));
+			obj = std::move(list);
+		}
+		return obj;
+	}
+
+	//	SampleObjs() returns at least one of every object type, and a list
+	//	of all of them at the end.
+	auto SampleObjs() -> std::vector<BinONObj> {
+		std::vector<BinONObj> objs;
+		objs.push_back(NullObj{});
+		objs.push_back(BoolObj{false});
+		objs.push_back(BoolObj{true});
+		for(std::int64_t i: std::initializer_list<std::int64_t>{0, 1, -1,
+			63, -64, 300, -70000, 0x123456789, INT64_MIN, INT64_MAX})
+		{
+			objs.push_back(IntObj{i});
+		}
+
+		//	(A UIntObj of 0 is left out, since it encodes with the same
+		//	default code byte as an IntObj of 0 and decodes as one.)
+		for(std::uint64_t u: std::initializer_list<std::uint64_t>{
+			1, 127, 128, 0x10000, UINT64_MAX})
+		{
+			objs.push_back(UIntObj{u});
+		}
+		objs.push_back(IntObj{IntVal::FromDec(
+			"-123456789012345678901234567890")});
+		objs.push_back(UIntObj{UIntVal::FromDec(
+			"123456789012345678901234567890")});
+		objs.push_back(FloatObj{0.0});
+		objs.push_back(FloatObj{-2.5e300});
+		objs.push_back(Float32Obj{1.5f});
+		objs.push_back(StrObj{});
+		objs.push_back(StrObj{"hello"});
+		objs.push_back(StrObj{std::string(1000, 'x')});
+		objs.push_back(BufferObj{});
+		objs.push_back(BufferObj{HyStr{"\x01\x02\x03"}});
+		objs.push_back(ListObj{});
+
+		ListObj list;
+		AppendVal(list, 1);
+		AppendVal(list, "two");
+		AppendVal(list, 3.0);
+		list.value().push_back(NullObj{});
+		list.value().push_back(DeepList(5));
+		objs.push_back(list);
+
+		SList ints{kIntObjCode};
+		for(int i = -500; i < 500; i += 7) {
+			AppendVal(ints, i);
+		}
+		objs.push_back(ints);
+		SList bools{kBoolObjCode};
+		for(int i = 0; i < 21; ++i) {
+			AppendVal(bools, i % 3 == 0);
+		}
+		objs.push_back(bools);
+		SList strs{kStrObjCode};
+		AppendVal(strs, "red");
+		AppendVal(strs, "");
+		AppendVal(strs, "blue");
+		objs.push_back(strs);
+		SList floats{kFloatObjCode};
+		AppendVal(floats, 0.25);
+		AppendVal(floats, -1e10);
+		objs.push_back(floats);
+		SList nulls{kNullObjCode};
+		nulls.value().resize(10);
+		objs.push_back(nulls);
+		SList lists{kListObjCode};
+		lists.value().push_back(list);
+		lists.value().push_back(ListObj{});
+		objs.push_back(lists);
+
+		objs.push_back(DictObj{});
+		DictObj dict;
+		SetCtnrVal(dict, "name", "widget");
+		SetCtnrVal(dict, 42, 1.5);
+		SetCtnrVal(dict, "tags", strs);
+		objs.push_back(dict);
+		SKDict skdict{kStrObjCode};
+		SetCtnrVal(skdict, "a", 1);
+		SetCtnrVal(skdict, "b", "bee");
+		SetCtnrVal(skdict, "c", list);
+		objs.push_back(skdict);
+		SDict sdict{kStrObjCode, kUIntCode};
+		for(unsigned i = 0; i < 20; ++i) {
+			SetCtnrVal(sdict, "k" + std::to_string(i), i * 1000u);
+		}
+		objs.push_back(sdict);
+
+		ListObj all;
+		for(auto& obj: objs) {
+			all.value().push_back(obj);
+		}
+		objs.push_back(std::move(all));
+		return objs;
+	}
+
+	//---- ByteWriter/ByteReader -----------------------------------------------
+
+	void TestByteIO() {
+		for(auto& obj: SampleObjs()) {
+			auto name = Name(obj);
+			auto bytes = Encode(obj);
+			Check(Decode(bytes) == obj, "span round trip: " + name);
+
+			//	The stream overloads must produce and accept the same bytes.
+			std::ostringstream out;
+			obj.encode(out);
+			auto str = out.str();
+			Check(TBytes(reinterpret_cast<const std::byte*>(str.data()),
+				reinterpret_cast<const std::byte*>(str.data() + str.size()))
+				== bytes, "stream encoding: " + name);
+			std::istringstream in{str};
+			Check(BinONObj::Decode(in) == obj, "stream round trip: " + name);
+		}
+
+		//	A SpanWriter writes into a fixed buffer and stops at its end.
+		auto bytes = Encode(StrObj{"hello"});
+		TBytes buf(bytes.size());
+		{
+			SpanWriter writer{buf.data(), buf.size()};
+			StrObj{"hello"}.encode(writer);
+		}
+		Check(buf == bytes, "SpanWriter");
+		CheckThrows<BufOverrun>([&] {
+				SpanWriter writer{buf.data(), buf.size()};
+				StrObj{"hello!"}.encode(writer);
+			}, "SpanWriter overrun");
+		CheckThrows<BufOverrun>([&] {
+				bytes.pop_back();
+				Decode(bytes);
+			}, "SpanReader overrun");
+
+		//	A StreamWriter can only prepare() what fits in its buffer, but
+		//	write() takes any size.
+		std::ostringstream out;
+		StreamWriter writer{out};
+		CheckThrows<std::length_error>(
+			[&] { writer.prepare(kStreamBufSize + 1u); },
+			"StreamWriter prepare() too big");
+		auto p = writer.prepare(kStreamBufSize);
+		std::fill(p, p + kStreamBufSize, 0x5a_byte);
+		writer.advance(kStreamBufSize);
+		TBytes big(3u * kStreamBufSize, 0xa5_byte);
+		writer.write(big.data(), big.size());
+		writer.flush();
+		auto str = out.str();
+		Check(str.size() == 4u * kStreamBufSize
+			&& str.front() == '\x5a' && str.back() == '\xa5',
+			"StreamWriter prepare() and write()");
+	}
+
+	//---- Borrowed views ------------------------------------------------------
+
+	void TestBorrowed() {
+		for(auto& obj: SampleObjs()) {
+			auto shared = std::make_shared<const TBytes>(Encode(obj));
+			SpanReader reader{shared};
+			Check(BinONObj::Decode(reader) == obj,
+				"borrowed round trip: " + Name(obj));
+		}
+
+		//	A borrowed StrObj points into the input rather than copying it,
+		//	and in kShared mode keeps the input alive.
+		auto bytes = Encode(StrObj{"borrowed"});
+		{
+			SpanReader reader{bytes};
+			reader.setBorrowMode(BorrowMode::kView);
+			auto obj = BinONObj::Decode(reader);
+			auto& hyStr = std::get<StrObj>(obj).value();
+			Check(!hyStr.isStr(), "kView decodes a view");
+			Check(reinterpret_cast<const std::byte*>(hyStr.asView().data())
+				== bytes.data() + bytes.size() - 8, "kView points into input");
+		}
+		StrObj str;
+		{
+			auto shared = std::make_shared<const TBytes>(bytes);
+			SpanReader reader{shared};
+			str.decode(CodeByte::Read(reader), reader);
+		}
+		Check(!str.value().isStr() && str.value().owner(),
+			"kShared view owns input");
+		Check(str.value().asView() == "borrowed",
+			"kShared view outlives reader");
+	}
+
+	//---- MMapFile ------------------------------------------------------------
+
+	void TestMMapFile() {
+		auto path = (std::filesystem::temp_directory_path()
+			/ "binon_test.binon").string();
+		auto objs = SampleObjs();
+		auto& all = objs.back();
+		auto bytes = Encode(all);
+		auto hello = Encode(StrObj{"hello"});
+		{
+			std::ofstream out{path, std::ios::binary};
+			out.write(reinterpret_cast<const char*>(bytes.data()),
+				static_cast<std::streamsize>(bytes.size()));
+			out.write(reinterpret_cast<const char*>(hello.data()),
+				static_cast<std::streamsize>(hello.size()));
+		}
+		StrObj str;
+		{
+			auto file = MMapFile::Open(path);
+			Check(file->size() == bytes.size() + hello.size(), "MMapFile size");
+			auto reader = file->reader();
+			Check(BinONObj::Decode(reader) == all, "MMapFile round trip");
+			auto tail = file->reader(BorrowMode::kShared, bytes.size());
+			str.decode(CodeByte::Read(tail), tail);
+			Check(tail.count() == hello.size(), "MMapFile reader offset");
+		}
+		Check(!str.value().isStr() && str.value().asView() == "hello",
+			"MMapFile view outlives file");
+		std::ofstream{path, std::ios::binary | std::ios::trunc};
+		Check(MMapFile::Open(path)->size() == 0, "empty MMapFile");
+		std::filesystem::remove(path);
+		CheckThrows<std::system_error>([&] { MMapFile::Open(path); },
+			"MMapFile missing file");
+	}
+
+	//---- CodecContext --------------------------------------------------------
+
+	void TestCodecContext() {
+		//	requireIO is applied once by the StreamReader/StreamWriter, which
+		//	leave the stream's own exception mask alone.
+		auto bytes = Encode(StrObj{"truncated"});
+		std::string str(reinterpret_cast<const char*>(bytes.data()),
+			bytes.size() - 1);
+		std::istringstream in{str};
+		CheckThrows<std::ios_base::failure>([&] { BinONObj::Decode(in); },
+			"stream requireIO");
+		Check(in.exceptions() == std::ios::goodbit, "stream exception mask");
+		std::istringstream quiet{str};
+		bool threw = false;
+		try {
+			BinONObj::Decode(quiet, false);
+		}
+		catch(const std::exception&) {
+			threw = true;
+		}
+		Check(!threw && quiet.fail(), "stream requireIO false");
+
+		std::ostringstream out;
+		out.setstate(std::ios::badbit);
+		CheckThrows<std::ios_base::failure>([&] {
+				StrObj{"x"}.encode(out);
+			}, "failed output stream");
+		{
+			StreamWriter writer{out, false};
+			Check(!writer.context().requireIO, "StreamWriter context");
+		}
+
+		//	A RequireIO set up by the caller still works with kSkipRequireIO.
+		std::ostringstream out2;
+		{
+			RequireIO rio{out2};
+			StrObj{"x"}.encode(out2, kSkipRequireIO);
+		}
+		std::istringstream in2{out2.str()};
+		Check(BinONObj::Decode(in2) == BinONObj{StrObj{"x"}},
+			"kSkipRequireIO");
+	}
+
+	//---- PullParser ----------------------------------------------------------
+
+	void TestPullParser() {
+		for(auto& obj: SampleObjs()) {
+			auto bytes = Encode(obj);
+			SpanReader reader{bytes};
+			PullParser parser{reader};
+			while(parser.next().mType != TokenType::kEnd) {}
+			Check(reader.count() == bytes.size(), "PullParser: " + Name(obj));
+		}
+
+		ListObj list;
+		auto& elems = list.value();
+		elems.push_back(NullObj{});
+		elems.push_back(BoolObj{true});
+		elems.push_back(IntObj{-5});
+		elems.push_back(UIntObj{7U});
+		elems.push_back(FloatObj{1.5});
+		elems.push_back(Float32Obj{2.5f});
+		elems.push_back(StrObj{"str"});
+		elems.push_back(BufferObj{HyStr{"buf"}});
+		SList ints{kIntObjCode};
+		AppendVal(ints, 1);
+		AppendVal(ints, 2);
+		elems.push_back(ints);
+		DictObj dict;
+		SetCtnrVal(dict, "k", 3);
+		elems.push_back(dict);
+		auto bytes = Encode(list);
+
+		SpanReader reader{bytes};
+		PullParser parser{reader};
+		auto expect = [&](TokenType type, const std::string& what) {
+				auto& tok = parser.next();
+				Check(tok.mType == type, "PullParser " + what);
+				return tok;
+			};
+		auto tok = expect(TokenType::kListBegin, "ListObj begin");
+		Check(tok.mTypeCode == kListObjCode && tok.mCount == 10
+			&& parser.depth() == 1, "PullParser ListObj count");
+		expect(TokenType::kNull, "NullObj");
+		Check(expect(TokenType::kBool, "BoolObj").mBool, "PullParser bool");
+		Check(expect(TokenType::kInt, "IntObj").mInt == -5,
+			"PullParser int");
+		Check(expect(TokenType::kUInt, "UIntObj").mUInt == 7U,
+			"PullParser uint");
+		Check(expect(TokenType::kFloat, "FloatObj").mFloat == 1.5,
+			"PullParser float");
+		Check(expect(TokenType::kFloat32, "Float32Obj").mFloat == 2.5,
+			"PullParser float32");
+		Check(expect(TokenType::kStr, "StrObj").str() == "str",
+			"PullParser str");
+		tok = expect(TokenType::kBuffer, "BufferObj");
+		Check(tok.mCount == 3 && tok.mData
+			&& std::to_integer<char>(tok.buffer()[0]) == 'b',
+			"PullParser buffer");
+		tok = expect(TokenType::kListBegin, "SList begin");
+		Check(tok.mTypeCode == kSListCode && tok.mElemCode == kIntObjCode
+			&& tok.mCount == 2 && parser.depth() == 2, "PullParser SList");
+		Check(expect(TokenType::kInt, "SList elem").mInt == 1,
+			"PullParser SList elem 1");
+		Check(expect(TokenType::kInt, "SList elem").mInt == 2,
+			"PullParser SList elem 2");
+		expect(TokenType::kListEnd, "SList end");
+		Check(expect(TokenType::kDictKeysBegin, "DictObj keys").mCount == 1,
+			"PullParser dict count");
+		Check(expect(TokenType::kStr, "dict key").str() == "k",
+			"PullParser dict key");
+		expect(TokenType::kDictValuesBegin, "DictObj values");
+		Check(expect(TokenType::kInt, "dict value").mInt == 3,
+			"PullParser dict value");
+		expect(TokenType::kDictEnd, "DictObj end");
+		expect(TokenType::kListEnd, "ListObj end");
+		Check(parser.depth() == 0, "PullParser depth 0");
+		expect(TokenType::kEnd, "end");
+
+		//	A stream cannot lend out its data, so read() fetches it.
+		std::string str(reinterpret_cast<const char*>(bytes.data()),
+			bytes.size());
+		std::istringstream in{str};
+		StreamReader streamReader{in};
+		PullParser streamParser{streamReader};
+		while(streamParser.next().mType != TokenType::kStr) {}
+		Check(!streamParser.token().mData, "PullParser stream mData");
+		std::array<std::byte, 8> buf{};
+		Check(streamParser.read(buf.data(), buf.size()) == 3
+			&& std::to_integer<char>(buf[2]) == 'r', "PullParser read()");
+
+		//	skipCtnr() jumps to the end of a container.
+		SpanReader skipReader{bytes};
+		PullParser skipParser{skipReader};
+		skipParser.next();
+		Check(skipParser.skipCtnr().mType == TokenType::kListEnd
+			&& skipReader.count() == bytes.size(), "PullParser skipCtnr()");
+
+		//	PullParser nests as deeply as the reader's maxDepth allows.
+		TBytes deep;
+		{
+			VectorWriter writer{deep};
+			writer.context().maxDepth = 100;
+			DeepList(100).encode(writer);
+		}
+		auto parseAll = [&deep](std::size_t maxDepth) {
+				SpanReader reader{deep};
+				reader.context().maxDepth = maxDepth;
+				PullParser parser{reader};
+				std::size_t maxSeen = 0;
+				while(parser.next().mType != TokenType::kEnd) {
+					maxSeen = std::max(maxSeen, parser.depth());
+				}
+				return maxSeen;
+			};
+		CheckThrows<DepthErr>([&] { parseAll(kDefMaxDepth); },
+			"PullParser maxDepth");
+		Check(parseAll(100) == 100u, "PullParser raised maxDepth");
+	}
+
+	//---- SkipObj -------------------------------------------------------------
+
+	void TestSkipObj() {
+		auto objs = SampleObjs();
+		TBytes all;
+		std::vector<std::size_t> offsets;
+		for(auto& obj: objs) {
+			auto bytes = Encode(obj);
+			Check(EncodedExtent(bytes) == bytes.size(),
+				"EncodedExtent: " + Name(obj));
+			offsets.push_back(all.size());
+			all.insert(all.end(), bytes.begin(), bytes.end());
+		}
+
+		//	SkipObj() steps from one object to the next in a concatenation.
+		SpanReader reader{all};
+		bool offsetsMatch = true;
+		for(auto offset: offsets) {
+			offsetsMatch = offsetsMatch && reader.count() == offset;
+			SkipObj(reader);
+		}
+		Check(offsetsMatch && reader.count() == all.size(), "SkipObj offsets");
+		Check(EncodedExtent(all, offsets[3]) == offsets[4] - offsets[3],
+			"EncodedExtent offset");
+
+		auto bytes = Encode(objs.back());
+		bytes.pop_back();
+		CheckThrows<BufOverrun>([&] { EncodedExtent(bytes); },
+			"EncodedExtent truncated");
+
+		//	Skipping is bound by the reader's maxDepth, as decoding is.
+		TBytes deep;
+		{
+			VectorWriter writer{deep};
+			writer.context().maxDepth = 100;
+			DeepList(100).encode(writer);
+		}
+		CheckThrows<DepthErr>([&] { EncodedExtent(deep); },
+			"EncodedExtent maxDepth");
+		CodecContext context;
+		context.maxDepth = 100;
+		Check(EncodedExtent(deep, 0, context) == deep.size(),
+			"EncodedExtent raised maxDepth");
+		CheckThrows<DepthErr>([&] { LazyObj{deep}.decode(); },
+			"LazyObj maxDepth");
+		LazyObj lazy{deep, context};
+		Check(lazy.size() == 1u && lazy[0].decode() == DeepList(99)
+			&& lazy.decode() == DeepList(100), "LazyObj raised maxDepth");
+	}
+
+	//---- encodedSize() -------------------------------------------------------
+
+	void TestEncodedSize() {
+		for(auto& obj: SampleObjs()) {
+			auto name = Name(obj);
+			auto bytes = Encode(obj);
+			Check(obj.encodedSize() == bytes.size(), "encodedSize: " + name);
+			TBytes data;
+			VectorWriter writer{data};
+			obj.encodeData(writer);
+			writer.flush();
+			Check(obj.encodedDataSize() == data.size(),
+				"encodedDataSize: " + name);
+		}
+
+		//	Sizing a SpanWriter's buffer with encodedSize() leaves no slack.
+		auto obj = SampleObjs().back();
+		TBytes buf(obj.encodedSize());
+		SpanWriter writer{buf.data(), buf.size()};
+		obj.encode(writer);
+		Check(writer.count() == buf.size() && buf == Encode(obj),
+			"encodedSize buffer");
+	}
+
+	//---- LazyObj -------------------------------------------------------------
+
+	void TestLazyObj() {
+		for(auto& obj: SampleObjs()) {
+			Check(LazyObj{Encode(obj)}.decode() == obj,
+				"LazyObj: " + Name(obj));
+		}
+
+		ListObj list;
+		AppendVal(list, "zero");
+		AppendVal(list, 1);
+		SList bools{kBoolObjCode};
+		for(int i = 0; i < 10; ++i) {
+			AppendVal(bools, i == 9);
+		}
+		list.value().push_back(bools);
+		DictObj dict;
+		SetCtnrVal(dict, "name", "widget");
+		SetCtnrVal(dict, 42, 1.5);
+		SetCtnrVal(dict, "nested", list);
+		SDict sdict{kStrObjCode, kIntObjCode};
+		SetCtnrVal(sdict, "x", 10);
+		SetCtnrVal(sdict, "y", 20);
+		SetCtnrVal(dict, "sdict", sdict);
+		auto shared = std::make_shared<const TBytes>(Encode(dict));
+		LazyObj lazy{shared};
+
+		Check(lazy.isDict() && !lazy.isList() && lazy.size() == 4,
+			"LazyObj dict size");
+		Check(lazy.find("name").value().get<std::string>() == "widget",
+			"LazyObj find() string key");
+		Check(lazy.find(42).value().get<double>() == 1.5,
+			"LazyObj find() int key");
+		Check(!lazy.find("missing") && !lazy.find(43),
+			"LazyObj find() missing key");
+		Check(GetObjVal<std::string>(FindObj(lazy, "name").value())
+			== "widget", "LazyObj FindObj()");
+
+		//	key() and operator[] walk the entries in encoding order.
+		bool entriesMatch = true;
+		for(std::size_t i = 0; i < lazy.size(); ++i) {
+			auto key = lazy.key(i).decode();
+			auto found = lazy.find(key);
+			entriesMatch = entriesMatch && found
+				&& &found.value() == &lazy[i]
+				&& lazy[i].decode() == dict.value().at(key);
+		}
+		Check(entriesMatch, "LazyObj key() and operator[]");
+		CheckThrows<std::out_of_range>([&] { lazy[4]; },
+			"LazyObj operator[] out of range");
+		CheckThrows<std::out_of_range>([&] { lazy.key(4); },
+			"LazyObj key() out of range");
+
+		auto optNested = lazy.find("nested");
+		auto& nested = optNested.value();
+		Check(nested.isList() && nested.size() == 3, "LazyObj nested list");
+		Check(nested[0].get<std::string>() == "zero"
+			&& nested[1].get<std::int64_t>() == 1, "LazyObj list elements");
+		Check(nested[2].size() == 10 && nested[2][9].get<bool>()
+			&& !nested[2][8].get<bool>() && nested[2][9].extent() == 0,
+			"LazyObj packed bools");
+		CheckThrows<NonCtnrType>([&] { nested[0].size(); },
+			"LazyObj size() of scalar");
+
+		//	A SDict's keys have no code bytes, so find() converts the key to
+		//	the dict's key type.
+		auto optSDict = lazy.find("sdict");
+		auto& lazySDict = optSDict.value();
+		Check(lazySDict.find("y").value().get<std::int64_t>() == 20,
+			"LazyObj SDict find()");
+		Check(lazySDict.find("y").value().extent() == 1,
+			"LazyObj SDict value extent");
+		Check(lazySDict.size() == 2
+			&& lazySDict.find("x").value().get<std::int64_t>() == 10
+			&& !lazySDict.find("z"), "LazyObj SDict size and key code");
+		CheckThrows<NonCtnrType>([&] { nested.find(0); },
+			"LazyObj find() in list");
+
+		//	Borrowed strings share ownership of the buffer.
+		auto name = lazy.find("name").value().decode();
+		Check(std::get<StrObj>(name).value().owner() == shared,
+			"LazyObj kShared decode()");
+	}
+
+	//---- Tree codec ----------------------------------------------------------
+
+	void TestTreeCodec() {
+		//	Nesting beyond kDefMaxDepth works once maxDepth is raised.
+		constexpr std::size_t kDeep = 1000;
+		auto deep = DeepList(kDeep);
+		TBytes bytes;
+		{
+			VectorWriter writer{bytes};
+			writer.context().maxDepth = kDeep;
+			deep.encode(writer);
+		}
+		Check(bytes.size() == deep.encodedSize(), "deep encodedSize");
+		CodecContext context;
+		context.maxDepth = kDeep;
+		Check(Decode(bytes, context) == deep, "deep round trip");
+
+		Check(Decode(Encode(DeepList(kDefMaxDepth))) == DeepList(kDefMaxDepth),
+			"decode at maxDepth");
+		TBytes deep100;
+		{
+			VectorWriter writer{deep100};
+			writer.context().maxDepth = 100;
+			DeepList(100).encode(writer);
+		}
+		CheckThrows<DepthErr>([&] { Decode(deep100); }, "decode maxDepth");
+		context.maxDepth = 100;
+		Check(Decode(deep100, context) == DeepList(100), "raised maxDepth");
+		CheckThrows<DepthErr>([&] {
+				TBytes bytes;
+				VectorWriter writer{bytes};
+				writer.context().maxDepth = 10;
+				DeepList(12).encode(writer);
+			}, "encode maxDepth");
+
+		//	Writers have no depth limit unless you set one.
+		TBytes unlimited;
+		{
+			VectorWriter writer{unlimited};
+			Check(writer.context().maxDepth == kNoLimit,
+				"writer maxDepth default");
+			DeepList(kDeep).encode(writer);
+		}
+		Check(unlimited == bytes, "deep encode by default");
+		TBytes planned;
+		{
+			VectorWriter writer{planned};
+			EncodePlanCache{}.encode(DeepList(kDeep), writer);
+		}
+		context.maxDepth = kDeep;
+		Check(Decode(planned, context) == DeepList(kDeep),
+			"EncodePlanCache deep encode by default");
+	}
+
+	//---- Limits --------------------------------------------------------------
+
+	//	DecodeFailsCheaply() runs decode() on a stream holding bytes and checks
+	//	that it runs out of data without asking for more than 1 MiB at once.
+	template<typename Decode>
+		auto DecodeFailsCheaply(const TBytes& bytes, Decode decode) -> bool
+	{
+		std::istringstream in{std::string(
+			reinterpret_cast<const char*>(bytes.data()), bytes.size())};
+		gLargestAlloc = 0;
+		bool threw = false;
+		try {
+			decode(in);
+		}
+		catch(const std::ios_base::failure&) {
+			threw = true;
+		}
+		catch(const std::bad_alloc&) {
+			return false;
+		}
+		return threw && gLargestAlloc <= 0x100000u;
+	}
+
+	void TestLimits() {
+		CodecContext context;
+		auto str = Encode(StrObj{std::string(100, 's')});
+		context.maxStrLen = 99;
+		CheckThrows<LimitErr>([&] { Decode(str, context); }, "maxStrLen");
+		context.maxStrLen = 100;
+		Check(Decode(str, context) == BinONObj{StrObj{std::string(100, 's')}},
+			"maxStrLen met");
+		context = {};
+		context.maxBytes = 50;
+		CheckThrows<LimitErr>([&] { Decode(str, context); }, "maxBytes");
+
+		ListObj list;
+		list.value().resize(10);
+		auto listBytes = Encode(list);
+		context = {};
+		context.maxCount = 9;
+		CheckThrows<LimitErr>([&] { Decode(listBytes, context); },
+			"maxCount");
+		context.maxCount = 10;
+		Check(Decode(listBytes, context) == BinONObj{list}, "maxCount met");
+
+		//	Lengths and counts the input cannot back up are rejected before
+		//	allocating.
+		auto huge = RawBytes{}.code(kListObjCode).size(1ULL << 40).mBytes;
+		CheckThrows<BufOverrun>([&] { Decode(huge); }, "huge ListObj count");
+		auto hugeStr = RawBytes{}.code(kStrObjCode).size(1ULL << 40).mBytes;
+		CheckThrows<BufOverrun>([&] { Decode(hugeStr); }, "huge StrObj length");
+
+		//	A stream cannot tell how much input is left, so such lengths are
+		//	read a chunk at a time and fail once the data runs out.
+		auto decodeObj = [](std::istream& in) { BinONObj::Decode(in); };
+		Check(DecodeFailsCheaply(hugeStr, decodeObj),
+			"huge StrObj length from stream");
+		auto hugeBuf = RawBytes{}.code(kBufferObjCode).size(3ULL << 30).mBytes;
+		Check(DecodeFailsCheaply(hugeBuf, decodeObj),
+			"huge BufferObj length from stream");
+		auto hugeInt = RawBytes{}.code(kIntObjCode).mBytes;
+		hugeInt.push_back(0xf1_byte);
+		VectorWriter intWriter{hugeInt};
+		UIntObj{3ULL << 30}.encodeData(intWriter);
+		intWriter.flush();
+		Check(DecodeFailsCheaply(hugeInt, decodeObj),
+			"huge vector-form IntObj from stream");
+		auto hugeBits = RawBytes{}.size(1ULL << 34).code(kBoolObjCode).mBytes;
+		Check(DecodeFailsCheaply(hugeBits,
+			[](std::istream& in) { SListBits{}.decodeData(in); }),
+			"huge SListBits count from stream");
+		Check(DecodeFailsCheaply(hugeBits,
+			[](std::istream& in) { SListT<bool>{}.decodeData(in); }),
+			"huge SListT<bool> count from stream");
+		auto hugeStrs = RawBytes{}.size(2).code(kStrObjCode).size(1)
+			.mBytes;
+		hugeStrs.push_back(0x61_byte);
+		VectorWriter strsWriter{hugeStrs};
+		UIntObj{3ULL << 30}.encodeData(strsWriter);
+		strsWriter.flush();
+		Check(DecodeFailsCheaply(hugeStrs,
+			[](std::istream& in) { SListStrs{}.decodeData(in); }),
+			"huge SListStrs element length from stream");
+		auto shortBits = RawBytes{}.size(20).code(kBoolObjCode).mBytes;
+		shortBits.push_back(0xff_byte);
+		std::istringstream shortIn{std::string(
+			reinterpret_cast<const char*>(shortBits.data()), shortBits.size())};
+		SListT<bool> shortList;
+		shortList.decodeData(shortIn, false);
+		Check(shortList.value() == std::vector<bool>(8, true),
+			"SListT<bool> cut short without requireIO");
+
+		//	A length may take the vector form, but its byte count may not.
+		auto vecLen = RawBytes{}.code(kStrObjCode).mBytes;
+		for(int b: {0xf1, 0x01, 0x05, 0x68, 0x65, 0x6c, 0x6c, 0x6f}) {
+			vecLen.push_back(static_cast<std::byte>(b));
+		}
+		Check(Decode(vecLen) == BinONObj{StrObj{"hello"}},
+			"vector-form StrObj length");
+		auto nestedLen = RawBytes{}.code(kStrObjCode).mBytes;
+		nestedLen.resize(100000, 0xf1_byte);
+		CheckThrows<IntTrunc>([&] { Decode(nestedLen); },
+			"nested vector-form length");
+		auto longLen = RawBytes{}.code(kStrObjCode).mBytes;
+		longLen.push_back(0xf1_byte);
+		VectorWriter writer{longLen};
+		UIntObj{1ULL << 30}.encodeData(writer);
+		CheckThrows<BufOverrun>([&] { Decode(longLen); },
+			"vector-form length byte count");
+
+		//	NullObj elements take no space, so maxNullCount bounds them.
+		auto nulls = [](std::uint64_t n) {
+				return RawBytes{}.code(kSListCode).size(n)
+					.code(kNullObjCode).mBytes;
+			};
+		CheckThrows<LimitErr>([&] { Decode(nulls(1ULL << 36)); },
+			"huge NullObj SList");
+		Check(std::get<SList>(Decode(nulls(kDefMaxNullCount))).value().size()
+			== kDefMaxNullCount, "maxNullCount met");
+		CheckThrows<LimitErr>([&] { Decode(nulls(kDefMaxNullCount + 1u)); },
+			"maxNullCount");
+		context = {};
+		context.maxNullCount = kDefMaxNullCount + 1u;
+		Check(std::get<SList>(Decode(nulls(kDefMaxNullCount + 1u), context))
+			.value().size() == kDefMaxNullCount + 1u, "raised maxNullCount");
+
+		//	The limit applies to the whole decode, not each container.
+		auto half = nulls(kDefMaxNullCount / 2u + 1u);
+		auto twoHalves = RawBytes{}.code(kListObjCode).size(2).mBytes;
+		for(int i = 0; i < 2; ++i) {
+			twoHalves.insert(twoHalves.end(), half.begin(), half.end());
+		}
+		CheckThrows<LimitErr>([&] { Decode(twoHalves); },
+			"maxNullCount across containers");
+		SpanReader nullReader{half};
+		BinONObj::Decode(nullReader);
+		Check(nullReader.nullCount() == kDefMaxNullCount / 2u + 1u,
+			"ByteReader nullCount()");
+
+		//	LazyObj checks counts when it indexes a container, and its indexes
+		//	share one null budget.
+		CheckThrows<LimitErr>([&] { LazyObj{nulls(1ULL << 36)}.size(); },
+			"LazyObj huge NullObj SList");
+		LazyObj lazyHalves{twoHalves};
+		Check(lazyHalves[0].size() == kDefMaxNullCount / 2u + 1u,
+			"LazyObj nulls within maxNullCount");
+		CheckThrows<LimitErr>([&] { lazyHalves[1].size(); },
+			"LazyObj maxNullCount across indexes");
+	}
+
+	//---- Native containers ---------------------------------------------------
+
+	//	CheckSameBytes() checks that a native container encodes to the same
+	//	bytes as its BinONVariant counterpart and decodes back to itself.
+	template<typename Native>
+		void CheckSameBytes(
+			const Native& native, const BinONObj& obj, const std::string& what
+			)
+	{
+		auto bytes = EncodeObj(native);
+		Check(bytes == Encode(obj), what + " bytes");
+		Check(native.encodedSize() == bytes.size(), what + " encodedSize");
+		SpanReader reader{bytes};
+		Native decoded;
+		decoded.decode(CodeByte::Read(reader), reader);
+		Check(decoded == native, what + " round trip");
+	}
+
+	void TestSListT() {
+		SListT<std::int64_t> ints{-1000000, -1, 0, 1, 127, 128, 1000000};
+		CheckSameBytes(ints, ints.toSList(), "SListT<int64_t>");
+		SListT<std::uint64_t> uints{0, 1, 255, 256, UINT64_MAX};
+		CheckSameBytes(uints, uints.toSList(), "SListT<uint64_t>");
+		SListT<double> doubles{1.5, 2.25, -3.0};
+		CheckSameBytes(doubles, doubles.toSList(), "SListT<double>");
+		SListT<float> floats{1.5f, -0.0f};
+		CheckSameBytes(floats, floats.toSList(), "SListT<float>");
+		SListT<bool> bools{true, false, true, true, false, false, true, true,
+			false, true};
+		CheckSameBytes(bools, bools.toSList(), "SListT<bool>");
+		SListT<std::string> strs{"red", "green", "", "blue"};
+		CheckSameBytes(strs, strs.toSList(), "SListT<string>");
+		CheckSameBytes(SListT<std::int64_t>{}, SList{kIntObjCode},
+			"empty SListT");
+
+		Check(SListT<std::int64_t>{ints.toSList()} == ints,
+			"SListT from SList");
+		Check(ints.hash() == ints.toSList().hash(), "SListT hash");
+		auto uintBytes = EncodeObj(uints);
+		CheckThrows<BadElemType>([&] {
+				SpanReader reader{uintBytes};
+				SListT<std::int64_t> wrongType;
+				wrongType.decode(CodeByte::Read(reader), reader);
+			}, "SListT element code mismatch");
+	}
+
+	void TestSDictT() {
+		//	std::unordered_map and TDict may iterate in different orders, so
+		//	dicts with more than one entry are compared after decoding.
+		SDictT<std::string,std::int64_t> one{{"only", 7}};
+		CheckSameBytes(one, one.toSDict(), "SDictT (1 entry)");
+		SKDictT<std::int64_t> oneK{{5, StrObj{"five"}}};
+		CheckSameBytes(oneK, oneK.toSKDict(), "SKDictT (1 entry)");
+		CheckSameBytes(SDictT<std::string,double>{},
+			SDict{kStrObjCode, kFloatObjCode}, "empty SDictT");
+
+		SDictT<std::string,double> counts{{"a", 1.0}, {"b", 2.0}, {"c", 3.0}};
+		auto countBytes = EncodeObj(counts);
+		Check(Decode(countBytes) == BinONObj{counts.toSDict()},
+			"SDictT decodes as SDict");
+		Check(counts.encodedSize() == countBytes.size(), "SDictT encodedSize");
+		SKDictT<std::string> mixed{{"a", IntObj{1}}, {"b", StrObj{"bee"}}};
+		auto mixedBytes = EncodeObj(mixed);
+		Check(Decode(mixedBytes) == BinONObj{mixed.toSKDict()},
+			"SKDictT decodes as SKDict");
+		{
+			SpanReader reader{mixedBytes};
+			SKDictT<std::string> decoded;
+			decoded.decode(CodeByte::Read(reader), reader);
+			Check(decoded == mixed, "SKDictT round trip");
+		}
+
+		Check(SDictT<std::string,double>{counts.toSDict()} == counts,
+			"SDictT from SDict");
+		Check(counts.hash() == counts.toSDict().hash(), "SDictT hash");
+		Check(mixed.hash() == mixed.toSKDict().hash(), "SKDictT hash");
+		CheckThrows<BadElemType>([&] {
+				SpanReader reader{countBytes};
+				SDictT<std::string,std::int64_t> wrongType;
+				wrongType.decode(CodeByte::Read(reader), reader);
+			}, "SDictT value code mismatch");
+	}
+
+	//---- OptimalObj ----------------------------------------------------------
+
+	void TestOptimalObj() {
+		for(auto& obj: SampleObjs()) {
+			auto name = Name(obj);
+
+			//	(Comparing bytes rather than decoded trees allows for a 0 that
+			//	gets optimized into a UIntObj or Float32Obj but decodes as an
+			//	IntObj or FloatObj, since the default code byte is the same.)
+			auto bytes = Encode(OptimalObj(obj));
+			TBytes optBytes;
+			{
+				VectorWriter writer{optBytes};
+				EncodeOptimal(obj, writer);
+			}
+			Check(optBytes == bytes, "EncodeOptimal: " + name);
+			Check(optBytes.size() <= Encode(obj).size(),
+				"EncodeOptimal size: " + name);
+		}
+
+		ListObj ints;
+		for(int i = 1; i <= 20; ++i) {
+			AppendVal(ints, i);
+		}
+		auto opt = OptimalObj(ints);
+		Check(opt.typeCode() == kSListCode
+			&& std::get<SList>(opt).mElemCode == kUIntCode,
+			"OptimalObj list of positive ints");
+		AppendVal(ints, -1);
+		opt = OptimalObj(ints);
+		Check(opt.typeCode() == kSListCode
+			&& std::get<SList>(opt).mElemCode == kIntObjCode,
+			"OptimalObj list of mixed ints");
+
+		DictObj dict;
+		SetCtnrVal(dict, "a", 1.5);
+		SetCtnrVal(dict, "b", 2.0);
+		opt = OptimalObj(dict);
+		Check(opt.typeCode() == kSDictCode
+			&& std::get<SDict>(opt).mKeyCode == kStrObjCode
+			&& std::get<SDict>(opt).mValCode == kFloat32Code,
+			"OptimalObj SDict");
+
+		//	IntObj 1 and UIntObj 1 are distinct keys that must not merge.
+		DictObj mixedKeys;
+		mixedKeys.value().emplace(IntObj{1}, StrObj{"int"});
+		mixedKeys.value().emplace(UIntObj{1U}, StrObj{"uint"});
+		opt = OptimalObj(mixedKeys);
+		Check(opt.typeCode() == kDictObjCode
+			&& std::get<DictObj>(opt).value().size() == 2,
+			"OptimalObj mixed int keys");
+
+		//	The same goes for container keys that differ only in the types of
+		//	their elements.
+		ListObj intKey, uintKey;
+		intKey.value().push_back(IntObj{1});
+		uintKey.value().push_back(UIntObj{1U});
+		DictObj ctnrKeys;
+		ctnrKeys.value().emplace(intKey, StrObj{"int"});
+		ctnrKeys.value().emplace(uintKey, StrObj{"uint"});
+		opt = OptimalObj(ctnrKeys);
+		Check(opt.typeCode() == kDictObjCode
+			&& std::get<DictObj>(opt).value().size() == 2
+			&& FindObj(std::get<DictObj>(opt), BinONObj{intKey})
+			&& FindObj(std::get<DictObj>(opt), BinONObj{uintKey}),
+			"OptimalObj colliding container keys");
+
+		//	SLists are left alone.
+		SList floats{kFloatObjCode};
+		AppendVal(floats, 1.5);
+		Check(OptimalObj(floats) == BinONObj{floats}, "OptimalObj SList");
+	}
+
+	//---- EncodePlanCache -----------------------------------------------------
+
+	//	Encodes obj twice through the same cache and decodes both copies.
+	auto PlanTwice(EncodePlanCache& cache, const BinONObj& obj)
+		-> std::pair<BinONObj,BinONObj>
+	{
+		TBytes bytes;
+		{
+			VectorWriter writer{bytes};
+			cache.encode(obj, writer);
+			cache.encode(obj, writer);
+		}
+		SpanReader reader{bytes};
+		auto first = BinONObj::Decode(reader);
+		auto second = BinONObj::Decode(reader);
+		Check(reader.count() == bytes.size(), "EncodePlanCache extent");
+		return {std::move(first), std::move(second)};
+	}
+
+	void TestEncodePlanCache() {
+		for(auto& obj: SampleObjs()) {
+			EncodePlanCache cache;
+			auto [first, second] = PlanTwice(cache, obj);
+			Check(first == second, "EncodePlanCache: " + Name(obj));
+		}
+
+		//	Dicts of the same shape share a plan, which encodes them as
+		//	SDicts when their values share a type.
+		EncodePlanCache cache;
+		DictObj msg;
+		SetCtnrVal(msg, "id", 1U);
+		SetCtnrVal(msg, "score", 2U);
+		auto [first, second] = PlanTwice(cache, msg);
+		Check(cache.size() == 1, "EncodePlanCache shares a plan");
+		Check(first.typeCode() == kSDictCode && second == first,
+			"EncodePlanCache SDict");
+		Check(GetObjVal<unsigned>(
+			FindObj(std::get<SDict>(first), "score").value()) == 2U,
+			"EncodePlanCache values");
+		DictObj other;
+		SetCtnrVal(other, "id", 1U);
+		SetCtnrVal(other, "name", "x");
+		PlanTwice(cache, other);
+		Check(cache.size() == 2, "EncodePlanCache new shape");
+		cache.clear();
+		Check(cache.size() == 0, "EncodePlanCache clear()");
+
+		EncodePlanCache small{1};
+		PlanTwice(small, msg);
+		PlanTwice(small, other);
+		Check(small.size() == 1, "EncodePlanCache maxPlans");
+
+		//	Container keys that would collide once optimized keep their
+		//	original encoding.
+		ListObj intKey, uintKey;
+		intKey.value().push_back(IntObj{1});
+		uintKey.value().push_back(UIntObj{1U});
+		DictObj ctnrKeys;
+		ctnrKeys.value().emplace(intKey, UIntObj{1U});
+		ctnrKeys.value().emplace(uintKey, UIntObj{2U});
+		auto [firstKeys, secondKeys] = PlanTwice(cache, ctnrKeys);
+		Check(firstKeys.typeCode() == kDictObjCode
+			&& std::get<DictObj>(firstKeys).value().size() == 2u
+			&& secondKeys == firstKeys, "EncodePlanCache colliding keys");
+	}
+
+	//---- Bulk packing --------------------------------------------------------
+
+	void TestBulkPack() {
+		//	Run lengths around the 8-bit and 64-bit word boundaries of the
+		//	bool kernels and the chunks of the float kernels.
+		for(std::size_t n: {1, 7, 8, 9, 63, 64, 65, 129, 1000}) {
+			auto suffix = " (" + std::to_string(n) + ")";
+			SList bools{kBoolObjCode}, ints{kIntObjCode}, uints{kUIntCode},
+				floats{kFloatObjCode}, float32s{kFloat32Code},
+				strs{kStrObjCode}, bufs{kBufferObjCode};
+			SDict sdict{kUIntCode, kFloatObjCode};
+			SKDict skdict{kUIntCode};
+			for(std::size_t i = 0; i < n; ++i) {
+				AppendVal(bools, i % 3 == 1);
+				AppendVal(ints, -static_cast<std::int64_t>(i * i * i));
+				AppendVal(uints, i << (i % 57));
+				AppendVal(floats, i * 0.5);
+				float32s.value().push_back(Float32Obj{i * 0.25f});
+				AppendVal(strs, std::string(i % 5, 'a'));
+				bufs.value().push_back(
+					BufferObj{HyStr{std::string(i % 3, 'b')}});
+				sdict.value().emplace(UIntObj{i}, FloatObj{i * 1.5});
+				skdict.value().emplace(UIntObj{i}, i % 2
+					? BinONObj{StrObj{"odd"}} : BinONObj{BoolObj{true}});
+			}
+			for(const BinONObj& obj: {BinONObj{bools}, BinONObj{ints},
+				BinONObj{uints}, BinONObj{floats}, BinONObj{float32s},
+				BinONObj{strs}, BinONObj{bufs}, BinONObj{sdict},
+				BinONObj{skdict}})
+			{
+				auto bytes = Encode(obj);
+				Check(Decode(bytes) == obj && obj.encodedSize() == bytes.size(),
+					"bulk round trip: " + Name(obj) + suffix);
+			}
+		}
+
+		//	A simple container whose elements do not match its element code
+		//	cannot be encoded.
+		SList wrong{kIntObjCode};
+		AppendVal(wrong, 1);
+		wrong.value().push_back(StrObj{"two"});
+		CheckThrows<BadElemType>([&] { Encode(wrong); },
+			"bulk pack mismatched element");
+
+		//	Packing onto a stream writes out the last partial byte of bools
+		//	when the PackElems goes away.
+		std::ostringstream oss;
+		{
+			PackElems pack{kBoolObjCode, oss};
+			for(bool b: {true, false, true, true, false, false, false, false,
+				true, true})
+			{
+				pack(BoolObj{b});
+			}
+		}
+		Check(oss.str() == "\xb0\xc0", "PackElems stream flush");
+	}
+
+	//---- Varint runs ---------------------------------------------------------
+
+	//	Encodes the data (no code bytes) of a run of IntObjs or UIntObjs.
+	template<typename Obj, typename TScalar>
+		auto VarintBytes(const std::vector<TScalar>& values) -> TBytes
+	{
+		TBytes bytes;
+		VectorWriter writer{bytes};
+		for(auto v: values) {
+			Obj{v}.encodeData(writer);
+		}
+		writer.flush();
+		return bytes;
+	}
+
+	void TestVarintRuns() {
+		std::vector<std::int64_t> ints;
+		std::vector<std::uint64_t> uints;
+		for(int i = 0; i < 300; ++i) {
+			//	Mostly 1-byte integers with a longer one now and then.
+			auto big = i % 17 == 5 ? std::int64_t{1} << (i % 63) : 0;
+			ints.push_back(big ? -big : i % 64 - 32);
+			uints.push_back(big ? static_cast<std::uint64_t>(big) : i % 128);
+		}
+		auto intBytes = VarintBytes<IntObj>(ints);
+		auto uintBytes = VarintBytes<UIntObj>(uints);
+		std::vector<std::int64_t> intsOut(ints.size());
+		std::vector<std::uint64_t> uintsOut(uints.size());
+		auto run = DecodeIntRun(intBytes.data(), intBytes.size(),
+			intsOut.data(), ints.size());
+		Check(run.count == ints.size() && run.size == intBytes.size()
+			&& intsOut == ints,
+			"DecodeIntRun (" + std::string{VarintDecoderISA()} + ")");
+		auto urun = DecodeUIntRun(uintBytes.data(), uintBytes.size(),
+			uintsOut.data(), uints.size());
+		Check(urun.count == uints.size() && urun.size == uintBytes.size()
+			&& uintsOut == uints,
+			"DecodeUIntRun (" + std::string{VarintDecoderISA()} + ")");
+
+		//	A run stops short of an integer that is cut off.
+		urun = DecodeUIntRun(uintBytes.data(), uintBytes.size() - 1,
+			uintsOut.data(), uints.size());
+		Check(urun.count == uints.size() - 1, "DecodeUIntRun truncated");
+
+		SListT<std::int64_t> list{ints};
+		CheckSameBytes(list, list.toSList(), "SListT<int64_t> run");
+		SListT<std::uint64_t> ulist{uints};
+		CheckSameBytes(ulist, ulist.toSList(), "SListT<uint64_t> run");
+	}
+
+	//	Encodes values as a run of Obj varints with a 0xf1 byte ahead of the
+	//	one at index stop (if there is one), and checks that decode() gets as
+	//	far as the 0xf1 or the end of the run.
+	template<typename Obj, typename TScalar, typename Decode>
+		auto DecodesRun(
+			const std::vector<TScalar>& values, std::size_t stop,
+			Decode decode
+			) -> bool
+	{
+		auto count = std::min(stop, values.size());
+		auto bytes = VarintBytes<Obj>(
+			std::vector<TScalar>(values.begin(), values.begin() + count));
+		auto size = bytes.size();
+		if(count < values.size()) {
+			bytes.push_back(std::byte{0xf1});
+			auto rest = VarintBytes<Obj>(
+				std::vector<TScalar>(values.begin() + count, values.end()));
+			bytes.insert(bytes.end(), rest.begin(), rest.end());
+		}
+		std::vector<TScalar> out(values.size());
+		auto run = decode(bytes.data(), bytes.size(), out.data(), out.size());
+		return run.count == count && run.size == size
+			&& std::equal(out.begin(), out.begin() + count, values.begin());
+	}
+
+	void TestVarintRunBoundaries() {
+		//	Runs on either side of the 16- and 32-byte SIMD block sizes, for
+		//	each decoder this CPU can run.
+		for(std::string isa: {"scalar", "sse4.1", "avx2"}) {
+			if(!ForceVarintDecoderISA(isa)) {
+				continue;
+			}
+			auto ok = true;
+			for(std::size_t n: {15, 16, 17, 31, 32, 33}) {
+				std::vector<std::uint64_t> small, mixed;
+				std::vector<std::int64_t> ismall, imixed;
+				for(std::size_t i = 0; i < n; ++i) {
+					//	Every third integer in the mixed runs is 2, 4, 8, or
+					//	9 bytes long.
+					static constexpr std::uint64_t kUWide[] = {
+						0x80, 0x4000, 0x20000000, 0x10000000'00000000
+					};
+					static constexpr std::int64_t kIWide[] = {
+						64, -0x2001, 0x10000000, -0x08000000'00000001
+					};
+					auto u = static_cast<std::uint64_t>(i % 128);
+					auto s = static_cast<std::int64_t>(i % 64) - 32;
+					small.push_back(u);
+					ismall.push_back(s);
+					auto wide = i % 3 == 2;
+					mixed.push_back(wide ? kUWide[i / 3 % 4] + i : u);
+					imixed.push_back(wide ? kIWide[i / 3 % 4] : s);
+				}
+				for(auto stop: {n, n / 2, n - 1}) {
+					ok = ok
+						&& DecodesRun<UIntObj>(small, stop, DecodeUIntRun)
+						&& DecodesRun<UIntObj>(mixed, stop, DecodeUIntRun)
+						&& DecodesRun<IntObj>(ismall, stop, DecodeIntRun)
+						&& DecodesRun<IntObj>(imixed, stop, DecodeIntRun);
+				}
+			}
+			Check(ok && VarintDecoderISA() == isa,
+				"varint run boundaries (" + isa + ")");
+		}
+		Check(ForceVarintDecoderISA(""), "varint decoder automatic pick");
+		Check(!ForceVarintDecoderISA("neon"), "varint decoder unknown ISA");
+	}
+
+	//---- Varint encoding -----------------------------------------------------
+
+	//	Formats bytes as lower-case hex digits.
+	auto Hex(const TBytes& bytes) -> std::string {
+		static constexpr char kDigits[] = "0123456789abcdef";
+		std::string hex;
+		for(auto b: bytes) {
+			auto u = std::to_integer<unsigned>(b);
+			hex += kDigits[u >> 4];
+			hex += kDigits[u & 0xfu];
+		}
+		return hex;
+	}
+
+	void TestVarintEncoding() {
+		//	The values on either side of each length boundary.
+		std::vector<std::pair<std::uint64_t,std::string>> uints{
+			{0, "00"}, {0x7f, "7f"}, {0x80, "8080"}, {0x3fff, "bfff"},
+			{0x4000, "c0004000"}, {0x1fffffff, "dfffffff"},
+			{0x20000000, "e000000020000000"},
+			{0x0fffffff'ffffffff, "efffffffffffffff"},
+			{0x10000000'00000000, "f01000000000000000"},
+			{UINT64_MAX, "f0ffffffffffffffff"}
+		};
+		std::vector<std::pair<std::int64_t,std::string>> ints{
+			{0, "00"}, {63, "3f"}, {-64, "40"}, {64, "8040"},
+			{-65, "bfbf"}, {0x1fff, "9fff"}, {-0x2000, "a000"},
+			{0x2000, "c0002000"}, {-0x2001, "dfffdfff"},
+			{0x0fffffff, "cfffffff"}, {-0x10000000, "d0000000"},
+			{0x10000000, "e000000010000000"},
+			{0x07ffffff'ffffffff, "e7ffffffffffffff"},
+			{-0x08000000'00000000, "e800000000000000"},
+			{0x08000000'00000000, "f00800000000000000"},
+			{INT64_MIN, "f08000000000000000"}
+		};
+		std::vector<std::uint64_t> uvals;
+		std::string uhex;
+		for(auto& [v, hex]: uints) {
+			auto bytes = VarintBytes<UIntObj>(std::vector{v});
+			Check(Hex(bytes) == hex && UIntVarintSize(v) == bytes.size(),
+				"UInt varint " + hex);
+			uvals.push_back(v);
+			uhex += hex;
+		}
+		std::vector<std::int64_t> ivals;
+		std::string ihex;
+		for(auto& [v, hex]: ints) {
+			auto bytes = VarintBytes<IntObj>(std::vector{v});
+			Check(Hex(bytes) == hex && IntVarintSize(v) == bytes.size(),
+				"Int varint " + hex);
+			ivals.push_back(v);
+			ihex += hex;
+		}
+
+		//	The bulk writers produce the same bytes, including through a
+		//	StreamWriter whose buffer fills up part way through an integer.
+		for(std::size_t pad = 0; pad < kMaxVarintSize; ++pad) {
+			TBytes bytes;
+			{
+				VectorWriter writer{bytes};
+				WriteUIntVarints(uvals.data(), uvals.size(), writer);
+				WriteIntVarints(ivals.data(), ivals.size(), writer);
+			}
+			std::ostringstream oss;
+			{
+				StreamWriter writer{oss};
+				TBytes zeros(kStreamBufSize - pad);
+				writer.write(zeros.data(), zeros.size());
+				WriteUIntVarints(uvals.data(), uvals.size(), writer);
+				WriteIntVarints(ivals.data(), ivals.size(), writer);
+				writer.flush();
+			}
+			auto str = oss.str().substr(kStreamBufSize - pad);
+			Check(Hex(bytes) == uhex + ihex
+				&& str.size() == bytes.size()
+				&& std::equal(str.begin(), str.end(), bytes.begin(),
+					[](char c, std::byte b) { return std::byte(c) == b; }),
+				"bulk varints (pad " + std::to_string(pad) + ")");
+		}
+	}
+
+	//---- Big integers --------------------------------------------------------
+
+	void TestBigInts() {
+		auto big = UIntVal::FromDec("123456789012345678901234567890");
+		Check(!big.isScalar(), "UIntVal::FromDec vector form");
+		Check(big.asHex() == "0x000000018ee90ff6c373e0ee4e3f0ad2",
+			"UIntVal::asHex");
+		Check(big.asHex(false, 1) == "018ee90ff6c373e0ee4e3f0ad2",
+			"UIntVal::asHex word size 1");
+		Check(big.asDec() == "123456789012345678901234567890",
+			"UIntVal::asDec");
+		auto neg = IntVal::FromDec("-123456789012345678901234567890");
+		Check(neg.asHex() == "0xfffffffe7116f0093c8c1f11b1c0f52e",
+			"IntVal::asHex");
+		Check(neg.asDec() == "-123456789012345678901234567890",
+			"IntVal::asDec");
+		Check(IntVal::FromHex("0xfffffffe7116f0093c8c1f11b1c0f52e").asDec()
+			== neg.asDec(), "IntVal::FromHex");
+		Check(UIntVal::FromHex("18EE90FF6C373E0EE4E3F0AD2").asDec()
+			== big.asDec(), "UIntVal::FromHex");
+
+		//	Values that fit 64 bits come out in scalar form.
+		Check(IntVal::FromDec("-9223372036854775808").scalar() == INT64_MIN,
+			"IntVal::FromDec INT64_MIN");
+		Check(UIntVal::FromDec("18446744073709551615").scalar()
+			== UINT64_MAX, "UIntVal::FromDec UINT64_MAX");
+		Check(IntVal{INT64_MIN}.asDec() == "-9223372036854775808"
+			&& IntVal{std::int64_t{0}}.asDec() == "0"
+			&& UIntVal{UINT64_MAX}.asDec() == "18446744073709551615",
+			"scalar asDec");
+		Check(IntVal{std::int64_t{-1}}.asHex() == "0xffffffffffffffff"
+			&& UIntVal{0x12345U}.asHex(true, 2) == "0x00012345",
+			"scalar asHex");
+		CheckThrows<NegUnsigned>([] { UIntVal::FromDec("-1"); },
+			"UIntVal::FromDec negative");
+		Check(IntVal::FromDec("+42").scalar() == 42
+			&& UIntVal::FromDec("-0").scalar() == 0u, "FromDec signs");
+		for(auto dec: {"", "-", "+", "12a3", " 12", "1,000", "0x10",
+			"1234567890123456789012345x"})
+		{
+			auto what = std::string{"FromDec rejects \""} + dec + '"';
+			CheckThrows<std::invalid_argument>(
+				[dec] { IntVal::FromDec(dec); }, "IntVal::" + what);
+			CheckThrows<std::invalid_argument>(
+				[dec] { UIntVal::FromDec(dec); }, "UIntVal::" + what);
+		}
+
+		//	The vector form is encoded as 0xf1, a byte count, and the bytes.
+		auto twoTo64 = UIntObj{UIntVal::FromDec("18446744073709551616")};
+		auto negTwoTo64 = IntObj{IntVal::FromDec("-18446744073709551616")};
+		Check(Hex(EncodeObj(twoTo64)) == "22f109010000000000000000",
+			"UIntObj 2^64 bytes");
+		Check(Hex(EncodeObj(negTwoTo64)) == "21f109ff0000000000000000",
+			"IntObj -2^64 bytes");
+		Check(Decode(EncodeObj(twoTo64)) == BinONObj{twoTo64}
+			&& Decode(EncodeObj(negTwoTo64)) == BinONObj{negTwoTo64},
+			"big integer round trip");
+	}
+
+	//---- Packed bools --------------------------------------------------------
+
+	//	EveryNth() returns an n-bit BitVec with every k-th bit set.
+	auto EveryNth(std::size_t n, std::size_t k) -> BitVec {
+		BitVec v(n);
+		for(std::size_t i = 0; i < n; i += k) {
+			v.set(i);
+		}
+		return v;
+	}
+
+	void TestBitVec() {
+		BitVec small{
+			true, false, false, false, false, false, false, true, true};
+		Check(small.byteSize() == 2u
+			&& small.data()[0] == 0x81_byte && small.data()[1] == 0x80_byte,
+			"BitVec packed layout");
+
+		//	130 bits span 3 words, the last one partially filled.
+		constexpr std::size_t n = 130;
+		auto twos = EveryNth(n, 2), threes = EveryNth(n, 3);
+		Check(twos.count() == 65u && threes.count() == 44u, "BitVec count");
+		auto v = twos;
+		v &= threes;
+		Check(v == EveryNth(n, 6) && v.count() == 22u, "BitVec &=");
+		v = twos;
+		v |= threes;
+		Check(v.count() == 65u + 44u - 22u && v.test(0) && v.test(129)
+			&& !v.test(1), "BitVec |=");
+		v = twos;
+		v ^= threes;
+		Check(v.count() == 65u + 44u - 44u && !v.test(0) && v.test(2)
+			&& v.test(3), "BitVec ^=");
+		Check((twos & threes) == EveryNth(n, 6)
+			&& (twos ^ twos).none(), "BitVec binary operators");
+		v = twos;
+		v.flip();
+		Check(v.count() == n - 65u && !v.test(0) && v.test(129),
+			"BitVec flip keeps the tail clear");
+		Check((~v) == twos && (v | twos).all(), "BitVec operator~");
+		v.flip(0);
+		Check(v.test(0) && v.count() == n - 64u, "BitVec flip(i)");
+		CheckThrows<std::invalid_argument>(
+			[&] { v &= EveryNth(n + 1, 2); }, "BitVec size mismatch");
+		v.resize(3);
+		v.resize(n);
+		Check(v.count() == 2u, "BitVec resize clears new bits");
+
+		SListBits bits{EveryNth(n, 3)};
+		CheckSameBytes(bits, bits.toSList(), "SListBits");
+		CheckSameBytes(SListBits{}, SList{kBoolObjCode}, "empty SListBits");
+		Check(SListBits{bits.toSList()} == bits, "SListBits from SList");
+		Check(bits.hash() == bits.toSList().hash(), "SListBits hash");
+		auto bytes = EncodeObj(bits);
+		SpanReader reader{bytes};
+		SListBits decoded;
+		decoded.decode(CodeByte::Read(reader), reader);
+		Check(decoded == bits, "SListBits decode");
+		auto intBytes = EncodeObj(SListT<std::int64_t>{1, 2});
+		CheckThrows<BadElemType>([&] {
+				SpanReader reader{intBytes};
+				SListBits wrongType;
+				wrongType.decode(CodeByte::Read(reader), reader);
+			}, "SListBits element code mismatch");
+	}
+
+	//---- String columns ------------------------------------------------------
+
+	void TestSListStrs() {
+		StrColumn col{"red", "", "green"};
+		col.push_back("blue");
+		Check(col.size() == 4u && col.charCount() == 12u
+			&& col[1].empty() && col[3] == "blue", "StrColumn push_back");
+		Check(std::vector<std::string_view>(col.begin(), col.end())
+			== std::vector<std::string_view>{"red", "", "green", "blue"},
+			"StrColumn iteration");
+
+		SListStrs strs{col};
+		CheckSameBytes(strs, strs.toSList(), "SListStrs");
+		CheckSameBytes(SListStrs{}, SList{kStrObjCode}, "empty SListStrs");
+		Check(SListStrs{strs.toSList()} == strs, "SListStrs from SList");
+		Check(strs.hash() == strs.toSList().hash(), "SListStrs hash");
+
+		//	Enough strings to overflow a StreamReader's buffer take the path
+		//	that grows the arena as they arrive.
+		SListStrs labels;
+		for(int i = 0; i < 200; ++i) {
+			labels.value().push_back(
+				std::string(static_cast<std::size_t>(i % 20),
+					static_cast<char>('a' + i % 26)));
+		}
+		auto bytes = EncodeObj(labels);
+		SpanReader spanReader{bytes};
+		SListStrs fromSpan;
+		fromSpan.decode(CodeByte::Read(spanReader), spanReader);
+		Check(fromSpan == labels, "SListStrs decode from span");
+		std::istringstream in{std::string(
+			reinterpret_cast<const char*>(bytes.data()), bytes.size())};
+		StreamReader streamReader{in};
+		SListStrs fromStream;
+		fromStream.decode(CodeByte::Read(streamReader), streamReader);
+		Check(fromStream == labels && fromStream.value().charCount()
+			== labels.value().charCount(), "SListStrs decode from stream");
+
+		auto intBytes = EncodeObj(SListT<std::int64_t>{1, 2});
+		CheckThrows<BadElemType>([&] {
+				SpanReader reader{intBytes};
+				SListStrs wrongType;
+				wrongType.decode(CodeByte::Read(reader), reader);
+			}, "SListStrs element code mismatch");
+	}
+
+	//---- Flat maps -----------------------------------------------------------
+
+	//	FailingAlloc is a stateless allocator that throws std::bad_alloc once
+	//	gAllocsLeft allocations have gone through (or never, if it is -1).
+	int gAllocsLeft = -1;
+	template<typename T>
+		struct FailingAlloc {
+			using value_type = T;
+			FailingAlloc() = default;
+			template<typename U>
+				FailingAlloc(const FailingAlloc<U>&) noexcept {}
+			auto allocate(std::size_t n) -> T* {
+				if(gAllocsLeft == 0) {
+					throw std::bad_alloc{};
+				}
+				if(gAllocsLeft > 0) {
+					--gAllocsLeft;
+				}
+				return std::allocator<T>{}.allocate(n);
+			}
+			void deallocate(T* p, std::size_t n) noexcept {
+				std::allocator<T>{}.deallocate(p, n);
+			}
+			template<typename U>
+				auto operator == (const FailingAlloc<U>&) const noexcept
+				{ return true; }
+			template<typename U>
+				auto operator != (const FailingAlloc<U>&) const noexcept
+				{ return false; }
+		};
+
+	//	CheckRehashFails() keeps adding entries to a map that may no longer
+	//	allocate until one of them has to grow it, and checks that the failure
+	//	leaves every entry in place.
+	template<typename Map>
+		void CheckRehashFails(const char* what) {
+			Map map;
+			int n = 0;
+			map.emplace(n, std::to_string(n));
+			bool threw = false;
+			gAllocsLeft = 0;
+			try {
+				while(++n < 1000) {
+					map.emplace(n, std::to_string(n));
+				}
+			}
+			catch(const std::bad_alloc&) {
+				threw = true;
+			}
+			gAllocsLeft = -1;
+			bool allFound = map.size() == static_cast<std::size_t>(n);
+			for(int i = 0; i < n && allFound; ++i) {
+				auto it = map.find(i);
+				allFound = it != map.end() && it->second == std::to_string(i);
+			}
+			Check(threw && allFound && !map.contains(n), what);
+		}
+
+	void TestFlatMap() {
+		//	Enough entries to rehash the table several times over.
+		FlatMap<std::int64_t,std::string> map;
+		constexpr std::int64_t n = 1000;
+		for(std::int64_t i = 0; i < n; ++i) {
+			map.emplace(i, std::to_string(i));
+		}
+		auto allFound = [&](std::int64_t step) {
+				for(std::int64_t i = 0; i < n; i += step) {
+					auto it = map.find(i);
+					if(it == map.end() || it->second != std::to_string(i)) {
+						return false;
+					}
+				}
+				return true;
+			};
+		Check(map.size() == n && allFound(1), "FlatMap insert and find");
+		Check(map.size() * 8u <= map.capacity() * 7u, "FlatMap load factor");
+		Check(static_cast<std::int64_t>(
+			std::distance(map.begin(), map.end())) == n,
+			"FlatMap iteration");
+		Check(!map.emplace(5, "again").second && map.at(5) == "5",
+			"FlatMap duplicate key");
+
+		for(std::int64_t i = 1; i < n; i += 2) {
+			map.erase(i);
+		}
+		Check(map.size() == n / 2 && allFound(2) && !map.contains(1),
+			"FlatMap erase");
+		for(std::int64_t i = 1; i < n; i += 2) {
+			map[i] = std::to_string(i);
+		}
+		Check(map.size() == n && allFound(1), "FlatMap reinsert after erase");
+
+		auto node = map.extract(7);
+		node.key() = n;
+		auto ret = map.insert(std::move(node));
+		Check(ret.inserted && !map.contains(7) && map.at(n) == "7",
+			"FlatMap extract and insert node");
+		auto copy = map;
+		Check(copy == map, "FlatMap copy");
+		copy.insert_or_assign(0, "zero");
+		Check(copy != map && copy.at(0) == "zero", "FlatMap insert_or_assign");
+		map.clear();
+		Check(map.empty() && map.begin() == map.end(), "FlatMap clear");
+
+		//	Up to kSmallSize entries stay packed at the front of the array,
+		//	and erasing one moves the last entry into its place.
+		using TMap = FlatMap<std::string,int>;
+		TMap small;
+		for(int i = 0; i < static_cast<int>(TMap::kSmallSize); ++i) {
+			small.emplace(std::to_string(i), i);
+		}
+		Check(small.capacity() == TMap::kSmallSize, "FlatMap small capacity");
+		small.erase("2");
+		Check(small.size() == TMap::kSmallSize - 1u && !small.contains("2")
+			&& small.at("7") == 7, "FlatMap small erase");
+		std::vector<int> vals;
+		for(auto& [key, val]: small) {
+			vals.push_back(val);
+		}
+		Check(vals == std::vector<int>{0, 1, 7, 3, 4, 5, 6},
+			"FlatMap small iteration order");
+		small.emplace("2", 2);
+		small.emplace("8", 8);
+		Check(small.capacity() > TMap::kSmallSize && small.size() == 9u
+			&& small.at("2") == 2 && small.at("8") == 8,
+			"FlatMap small to hash table");
+		TMap reserved;
+		reserved.reserve(TMap::kSmallSize + 1u);
+		Check(reserved.capacity() > TMap::kSmallSize,
+			"FlatMap reserve past small");
+		CheckRehashFails<FlatMap<int,std::string,std::hash<int>,
+			std::equal_to<int>,FailingAlloc<std::pair<const int,std::string>>>>(
+			"FlatMap rehash allocation failure");
+	}
+
+	//---- Ordered maps --------------------------------------------------------
+
+	//	Keys() lists the keys of a map in iteration order.
+	template<typename Map>
+		auto Keys(const Map& map) -> std::vector<int>
+	{
+		std::vector<int> keys;
+		for(auto& [key, val]: map) {
+			keys.push_back(key);
+		}
+		return keys;
+	}
+
+	void TestOrderedMap() {
+		//	20 entries is past kSmallSize, so the index table is in use.
+		OrderedMap<int,std::string> map;
+		std::vector<int> order;
+		for(int i = 0; i < 20; ++i) {
+			auto key = (i * 7) % 20;
+			map.emplace(key, std::to_string(key));
+			order.push_back(key);
+		}
+		Check(Keys(map) == order, "OrderedMap insertion order");
+		Check(map.at(13) == "13" && !map.contains(20), "OrderedMap find");
+
+		map.erase(order[3]);
+		map.erase(order[10]);
+		auto erased = order[3];
+		order.erase(order.begin() + 10);
+		order.erase(order.begin() + 3);
+		Check(Keys(map) == order, "OrderedMap erase keeps order");
+		map[erased] = "back";
+		order.push_back(erased);
+		Check(Keys(map) == order, "OrderedMap reinsert goes last");
+		map.reserve(100);
+		Check(Keys(map) == order && map.at(erased) == "back",
+			"OrderedMap reserve keeps order");
+
+		auto node = map.extract(order.front());
+		node.key() = 99;
+		map.insert(std::move(node));
+		order.push_back(99);
+		order.erase(order.begin());
+		Check(Keys(map) == order, "OrderedMap extract and insert node");
+		auto copy = map;
+		Check(copy == map && Keys(copy) == order, "OrderedMap copy");
+
+		OrderedMap<int,int> small{{3, 0}, {1, 0}, {2, 0}};
+		small.erase(1);
+		small.emplace(0, 0);
+		Check(Keys(small) == std::vector<int>{3, 2, 0},
+			"OrderedMap small order");
+		CheckRehashFails<OrderedMap<int,std::string,std::hash<int>,
+			std::equal_to<int>,FailingAlloc<std::pair<const int,std::string>>>>(
+			"OrderedMap rebuild allocation failure");
+
+	 #if BINON_DICT_STORAGE == BINON_DICT_ORDERED
+		//	With an ordered TDict, dicts encode in insertion order, so decoding
+		//	and re-encoding reproduces the original bytes.
+		SDictT<std::string,double> counts{{"a", 1.0}, {"b", 2.0}, {"c", 3.0}};
+		auto countBytes = EncodeObj(counts);
+		Check(Encode(Decode(countBytes)) == countBytes, "SDictT bytes");
+		SKDictT<std::string> mixed{{"a", IntObj{1}}, {"b", StrObj{"bee"}}};
+		auto mixedBytes = EncodeObj(mixed);
+		Check(Encode(Decode(mixedBytes)) == mixedBytes, "SKDictT bytes");
+		DictObj dict;
+		for(auto key: order) {
+			dict.value().emplace(IntObj{key}, NullObj{});
+		}
+		auto dictBytes = Encode(dict);
+		auto decoded = Decode(dictBytes);
+		std::vector<int> keys;
+		for(auto& [key, val]: std::get<DictObj>(decoded).value()) {
+			keys.push_back(static_cast<int>(
+				std::get<IntObj>(key).value().scalar()));
+		}
+		Check(keys == order, "DictObj decodes in encoded order");
+		Check(Encode(decoded) == dictBytes, "DictObj bytes");
+	 #endif
+	}
+
+	//---- Transparent key lookups ---------------------------------------------
+
+	void TestKeyLookup() {
+		KeyHash keyHash;
+		std::hash<BinONObj> objHash;
+		Check(keyHash(std::string_view{"name"}) == objHash(StrObj{"name"})
+			&& keyHash(std::int64_t{-3}) == objHash(IntObj{-3})
+			&& keyHash(std::uint64_t{7}) == objHash(UIntObj{7u})
+			&& keyHash(BinONObj{StrObj{"name"}}) == objHash(StrObj{"name"}),
+			"KeyHash matches std::hash<BinONObj>");
+		KeyEq keyEq;
+		Check(keyEq(StrObj{"name"}, std::string_view{"name"})
+			&& !keyEq(StrObj{"name"}, std::string_view{"nam"})
+			&& keyEq(IntObj{-3}, std::int64_t{-3})
+			&& keyEq(UIntObj{7u}, std::uint64_t{7})
+			&& !keyEq(StrObj{"7"}, std::uint64_t{7}),
+			"KeyEq compares native keys");
+
+		//	Both map classes take native keys through find() whatever TDict
+		//	happens to be.
+		auto checkMap = [](auto map, const char* what) {
+				map.emplace(StrObj{"name"}, IntObj{1});
+				map.emplace(IntObj{-3}, IntObj{2});
+				map.emplace(UIntObj{7u}, IntObj{3});
+				Check(map.find(std::string_view{"name"}) != map.end()
+					&& map.find(std::int64_t{-3})->second == BinONObj{IntObj{2}}
+					&& map.find(std::uint64_t{7})->second == BinONObj{IntObj{3}}
+					&& map.find(std::string_view{"none"}) == map.end()
+					&& map.find(std::int64_t{7}) == map.end(), what);
+			};
+		checkMap(FlatMap<BinONObj,BinONObj,KeyHash,KeyEq>{},
+			"FlatMap transparent find");
+		checkMap(OrderedMap<BinONObj,BinONObj,KeyHash,KeyEq>{},
+			"OrderedMap transparent find");
+
+		DictObj dict;
+		SetCtnrVal(dict, "name", "BinON");
+		SetCtnrVal(dict, std::int64_t{-3}, "minus three");
+		SetCtnrVal(dict, std::uint64_t{7}, "seven");
+		Check(FindObj(dict, "name") && FindObj(dict, std::string{"name"})
+			&& FindObj(dict, std::string_view{"name"})
+			&& !FindObj(dict, "nope"), "FindObj string keys");
+		Check(GetCtnrVal<std::string>(dict, std::int64_t{-3}) == "minus three"
+			&& GetCtnrVal<std::string>(dict, std::uint64_t{7}) == "seven"
+			&& !FindObj(dict, std::int64_t{7}), "FindObj integer keys");
+
+		//	An SKDict's key type decides what object a native key stands for.
+		SKDict uintKeys{kUIntCode};
+		SetCtnrVal(uintKeys, 5, "five");
+		Check(GetCtnrVal<std::string>(uintKeys, 5) == "five"
+			&& GetCtnrVal<std::string>(uintKeys, std::uint64_t{5}) == "five",
+			"FindObj SKDict key type");
+		SKDict strKeys{kStrObjCode};
+		SetCtnrVal(strKeys, "a", 1);
+		Check(FindObj(strKeys, std::string_view{"a"})
+			&& DelKey(strKeys, "a") && !FindObj(strKeys, "a"),
+			"DelKey string key");
+	}
+
+	//---- Hash caching --------------------------------------------------------
+
+	void TestHashCache() {
+		//	Whether or not BINON_HASH_CACHE is on, a hash must follow any
+		//	change made through value().
+		StrObj str{"before"};
+		auto strHash = str.hash();
+		str.value() = HyStr{"after"};
+		Check(str.hash() == StrObj{"after"}.hash()
+			&& str.hash() != strHash, "StrObj hash after value()");
+		BufferObj buf{HyStr{"\x01"}};
+		buf.hash();
+		buf.value() = HyStr{"\x02"};
+		Check(buf.hash() == BufferObj{HyStr{"\x02"}}.hash(),
+			"BufferObj hash after value()");
+
+		ListObj list;
+		auto listHash = list.hash();
+		list.value().push_back(IntObj{1});
+		ListObj expected;
+		expected.value().push_back(IntObj{1});
+		Check(list.hash() == expected.hash() && list.hash() != listHash,
+			"ListObj hash after value()");
+		SKDict dict{kStrObjCode};
+		dict.hash();
+		SetCtnrVal(dict, "key", 1);
+		SKDict expectedDict{kStrObjCode};
+		SetCtnrVal(expectedDict, "key", 1);
+		Check(dict.hash() == expectedDict.hash(), "SKDict hash after value()");
+
+		auto decoded = str;
+		decoded.hash();
+		auto bytes = EncodeObj(StrObj{"decoded"});
+		SpanReader reader{bytes};
+		decoded.decode(CodeByte::Read(reader), reader);
+		Check(decoded.hash() == StrObj{"decoded"}.hash(),
+			"StrObj hash after decode");
+		auto moved = std::move(list);
+		Check(moved.hash() == expected.hash()
+			&& list.hash() == ListObj{}.hash(), "ListObj hash after move");
+
+		//	A reference from value() & may be written through after the
+		//	object has been hashed, and so may one to a container's element.
+		StrObj kept{"kept"};
+		auto& keptVal = kept.value();
+		kept.hash();
+		keptVal = HyStr{"changed"};
+		Check(kept.hash() == StrObj{"changed"}.hash(),
+			"StrObj hash after write through kept value()");
+		ListObj outer{TList{ListObj{}}};
+		auto& inner = std::get<ListObj>(outer.value()[0]);
+		outer.hash();
+		AppendVal(inner, 1);
+		ListObj innerExpected{TList{IntObj{1}}};
+		Check(outer.hash() == ListObj{TList{innerExpected}}.hash(),
+			"ListObj hash after write to element");
+		SKDict keyed{kStrObjCode};
+		auto& keyedVal = keyed.value();
+		keyed.hash();
+		keyedVal.emplace(StrObj{"key"}, IntObj{1});
+		Check(keyed.hash() == expectedDict.hash(),
+			"SKDict hash after write through kept value()");
+	}
+}
+
+auto main() -> int {
+	try {
+		TestByteIO();
+		TestBorrowed();
+		TestMMapFile();
+		TestCodecContext();
+		TestPullParser();
+		TestSkipObj();
+		TestEncodedSize();
+		TestLazyObj();
+		TestTreeCodec();
+		TestLimits();
+		TestSListT();
+		TestSDictT();
+		TestOptimalObj();
+		TestEncodePlanCache();
+		TestBulkPack();
+		TestVarintRuns();
+		TestVarintRunBoundaries();
+		TestVarintEncoding();
+		TestBigInts();
+		TestBitVec();
+		TestSListStrs();
+		TestFlatMap();
+		TestOrderedMap();
+		TestKeyLookup();
+		TestHashCache();
+	}
+	catch(const std::exception& err) {
+		std::cerr << "ERROR: " << err.what() << '\n';
+		return 1;
+	}
+	std::cout << gChecks - gFailures << " of " << gChecks
+		<< " checks passed\n";
+	return gFailures ? 1 : 0;
+}